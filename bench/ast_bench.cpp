@@ -0,0 +1,49 @@
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/token_buffer.h"
+#include "bench_utils.h"
+
+#include <iomanip>
+#include <iostream>
+
+// Measures building a whole AST (keeping every declaration, like the compiler does) and tearing it down again
+int main(int argc, char *argv[]) {
+    std::string source = generate_program(bench_units(argc, argv, 20000));
+
+    StringScanner scan = StringScanner(source);
+    TokenBuffer tokens = TokenBuffer::tokenize(scan, source.length() / 4);
+
+    double best_build = 1e30;
+    double best_teardown = 1e30;
+    for (int i = 0; i < 5; i++) {
+        // The copy given to the parser isn't timed
+        TokenBuffer copy = tokens;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        auto arena = std::make_unique<AstArena>();
+        auto stmts = std::make_unique<NodeList<Stmt>>(arena->nodes<Stmt>());
+
+        Parser parser = Parser(std::move(copy), *arena);
+        auto stmt = parser.parse_stmt();
+        while (stmt.has_value()) {
+            stmts->push_back(std::move(stmt.value()));
+            stmt = parser.parse_stmt();
+        }
+
+        auto built = std::chrono::high_resolution_clock::now();
+        stmts.reset();
+        arena.reset();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        best_build = std::min(best_build, std::chrono::duration<double>(built - begin).count());
+        best_teardown = std::min(best_teardown, std::chrono::duration<double>(end - built).count());
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Source size:   " << source.length() / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "Tokens:        " << tokens.size() << std::endl;
+    std::cout << "Build:         " << best_build * 1000 << " ms" << std::endl;
+    std::cout << "Teardown:      " << best_teardown * 1000 << " ms" << std::endl;
+
+    return 0;
+}
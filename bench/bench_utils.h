@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Generate a large, valid Baz program made up of repeated structs, enums and functions
+inline std::string generate_program(int units) {
+    std::string source;
+
+    for (int i = 0; i < units; i++) {
+        std::string n = std::to_string(i);
+
+        source += "/* Generated unit " + n + " */\n";
+        source += "struct Point" + n + " {\n"
+                  "    x: int;\n"
+                  "    y: int;\n"
+                  "    label: str?;\n"
+                  "\n"
+                  "    fn length_squared(): int {\n"
+                  "        return this.x * this.x + this.y * this.y;\n"
+                  "    }\n"
+                  "}\n\n";
+
+        source += "enum Shape" + n + " {\n"
+                  "    Circle(int);\n"
+                  "    Square(int);\n"
+                  "    Empty;\n"
+                  "\n"
+                  "    fn area(): int {\n"
+                  "        match (this) {\n"
+                  "            Shape" + n + "::Circle(r): { return 3 * r * r; },\n"
+                  "            Shape" + n + "::Square(s): { return s * s; },\n"
+                  "            Shape" + n + "::Empty: { return 0; },\n"
+                  "        }\n"
+                  "    }\n"
+                  "}\n\n";
+
+        source += "// Sums some arithmetic over a loop\n"
+                  "fn compute" + n + "(a: int, b: int, label: str?): int {\n"
+                  "    let total: int = 0;\n"
+                  "    let p: Point" + n + " = Point" + n + " { x: a, y: b, label: label };\n"
+                  "    for (let i: int = 0; i < a + b; i = i + 1) {\n"
+                  "        if (i * 2 > b && !(i == a) || i <= 3) {\n"
+                  "            total = total + p.length_squared() - (i * (a + b) / 2);\n"
+                  "        } else {\n"
+                  "            total = total - 1;\n"
+                  "        }\n"
+                  "    }\n"
+                  "    let shape: Shape" + n + " = Shape" + n + "::Circle(a);\n"
+                  "    let name: str = label ?? \"unnamed\";\n"
+                  "    println(name);\n"
+                  "    return total + shape.area();\n"
+                  "}\n\n";
+    }
+
+    source += "fn main(): void {\n"
+              "    println(\"done\");\n"
+              "}\n";
+
+    return source;
+}
+
+// Number of generated units to use, overridable with the first command line argument
+inline int bench_units(int argc, char *argv[], int fallback) {
+    if (argc > 1)
+        return std::atoi(argv[1]);
+
+    return fallback;
+}
+
+// Run `f` `iterations` times and return the best time in seconds
+template <typename F>
+double time_best(int iterations, F f) {
+    double best = 1e30;
+    for (int i = 0; i < iterations; i++) {
+        auto begin = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        if (seconds < best)
+            best = seconds;
+    }
+
+    return best;
+}
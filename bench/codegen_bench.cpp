@@ -0,0 +1,70 @@
+#include "../src/code_generator/cpp_generator.h"
+#include "../src/code_generator/output_sink.h"
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/token_buffer.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+#include "../src/util/thread_pool.h"
+#include "bench_utils.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Measures how generating C++ scales with the number of threads declarations are generated on
+int main(int argc, char *argv[]) {
+    std::string source = generate_program(bench_units(argc, argv, 20000));
+
+    StringScanner scan = StringScanner(source);
+    AstArena arena;
+    Parser parser = Parser(TokenBuffer::tokenize(scan, source.length() / 4), arena);
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    auto stmt = parser.parse_stmt();
+    while (stmt.has_value()) {
+        stmts.push_back(std::move(stmt.value()));
+        stmt = parser.parse_stmt();
+    }
+
+    auto type_env = TypeEnvironment();
+    type_env.generate_type_env(stmts);
+
+    auto type_checker = TypeChecker(type_env.type_env);
+    type_checker.resolve_and_check(stmts);
+
+    size_t output_size = 0;
+    double serial_seconds = time_best(5, [&]() {
+        MemorySink output;
+        CppGenerator(output, type_env.type_env).generate(stmts);
+        output_size = output.view().length();
+    });
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Output size: " << output_size / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "Serial:      " << serial_seconds * 1000 << " ms" << std::endl;
+
+    // Writing to a file should cost little more than generating into memory
+    std::string path("codegen_bench.cpp.out");
+    double file_seconds = time_best(5, [&]() {
+        FileSink output(path);
+        CppGenerator(output, type_env.type_env).generate(stmts);
+    });
+    std::remove(path.c_str());
+
+    std::cout << "To file:     " << file_seconds * 1000 << " ms" << std::endl;
+
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        double seconds = time_best(5, [&]() {
+            MemorySink output;
+            CppGenerator(output, type_env.type_env).generate(stmts, pool);
+        });
+
+        std::cout << std::setw(2) << threads << " threads:  " << seconds * 1000 << " ms (" << serial_seconds / seconds << "x)" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/token_buffer.h"
+#include "bench_utils.h"
+
+#include <iomanip>
+#include <iostream>
+
+// Generate functions whose bodies are long expressions using every binary operator precedence level,
+// prefix operators and bracketed sub-expressions
+std::string generate_expressions(int units) {
+    std::string source;
+
+    for (int i = 0; i < units; i++) {
+        std::string n = std::to_string(i);
+
+        source += "fn expr" + n + "(a: int, b: int, c: int?, d: bool): bool {\n"
+                  "    let x: int = a * b + -c ?? 1 / (a - b) * 2 - (a + b) * (c ?? a) + 3 * a * a - b / 4;\n"
+                  "    let y: bool = !d || a < b && b <= x || !(a == b) && (x > 10 || x >= a * b - c ?? 0);\n"
+                  "    return y && x != a + b * (a - (b + (c ?? 0) * (a - b)) / 2) || -x < -a - -b;\n"
+                  "}\n\n";
+    }
+
+    source += "fn main(): void {\n"
+              "    println(\"done\");\n"
+              "}\n";
+
+    return source;
+}
+
+// Measures how quickly expression-heavy code is parsed from a pre-tokenized `TokenBuffer`
+int main(int argc, char *argv[]) {
+    std::string source = generate_expressions(bench_units(argc, argv, 20000));
+
+    StringScanner scan = StringScanner(source);
+    TokenBuffer tokens = TokenBuffer::tokenize(scan, source.length() / 4);
+
+    // The copy given to the parser isn't timed
+    double best = 1e30;
+    for (int i = 0; i < 5; i++) {
+        TokenBuffer copy = tokens;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        AstArena arena;
+        Parser parser = Parser(std::move(copy), arena);
+        while (parser.parse_stmt().has_value()) {
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+        if (seconds < best)
+            best = seconds;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Source size:   " << source.length() / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "Tokens:        " << tokens.size() << std::endl;
+    std::cout << "Parse time:    " << best * 1000 << " ms" << std::endl;
+    std::cout << "Tokens/second: " << tokens.size() / best / 1e6 << " M" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "../src/scanner/parallel_tokenizer.h"
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/token_buffer.h"
+#include "bench_utils.h"
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Measures how tokenizing scales with the number of threads used
+int main(int argc, char *argv[]) {
+    std::string source = generate_program(bench_units(argc, argv, 80000));
+
+    size_t token_count = 0;
+    double serial_seconds = time_best(5, [&]() {
+        StringScanner scan = StringScanner(source);
+        token_count = TokenBuffer::tokenize(scan, source.length() / 4).size();
+    });
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Source size: " << source.length() / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "Tokens:      " << token_count << std::endl;
+    std::cout << "Serial:      " << serial_seconds * 1000 << " ms" << std::endl;
+
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double seconds = time_best(5, [&]() {
+            tokenize_parallel(source, threads);
+        });
+
+        std::cout << std::setw(2) << threads << " threads:  " << seconds * 1000 << " ms (" << serial_seconds / seconds << "x)" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/token_buffer.h"
+#include "bench_utils.h"
+
+#include <iomanip>
+#include <iostream>
+
+// Parse every top level declaration, returning how many there were
+long parse_all(Parser &parser) {
+    long decl_count = 0;
+    auto stmt = parser.parse_stmt();
+    while (stmt.has_value()) {
+        decl_count++;
+        stmt = parser.parse_stmt();
+    }
+
+    return decl_count;
+}
+
+// Compares parsing straight from a scanner with parsing a pre-tokenized `TokenBuffer`, and with skipping bodies
+int main(int argc, char *argv[]) {
+    std::string source = generate_program(bench_units(argc, argv, 20000));
+
+    long decl_count = 0;
+    double scanner_seconds = time_best(5, [&]() {
+        AstArena arena;
+        Parser parser = Parser(std::make_unique<StringScanner>(source), arena);
+        decl_count = parse_all(parser);
+    });
+
+    size_t token_count = 0;
+    double tokenize_seconds = 0;
+    double buffer_seconds = time_best(5, [&]() {
+        auto begin = std::chrono::high_resolution_clock::now();
+        StringScanner scan = StringScanner(source);
+        TokenBuffer tokens = TokenBuffer::tokenize(scan, source.length() / 4);
+        tokenize_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+        token_count = tokens.size();
+        AstArena arena;
+        Parser parser = Parser(std::move(tokens), arena);
+        parse_all(parser);
+    });
+
+    // Only the declarations, as when just the type environment is needed
+    double lazy_seconds = time_best(5, [&]() {
+        StringScanner scan = StringScanner(source);
+        AstArena arena;
+        Parser parser = Parser(TokenBuffer::tokenize(scan, source.length() / 4), arena);
+        parser.set_lazy_bodies(true);
+        parse_all(parser);
+    });
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Source size:          " << source.length() / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "Tokens:               " << token_count << std::endl;
+    std::cout << "Declarations:         " << decl_count << std::endl;
+    std::cout << "Scanner parse:        " << scanner_seconds * 1000 << " ms" << std::endl;
+    std::cout << "Pre-tokenized parse:  " << buffer_seconds * 1000 << " ms (" << tokenize_seconds * 1000 << " ms tokenizing)" << std::endl;
+    std::cout << "Lazy bodies parse:    " << lazy_seconds * 1000 << " ms" << std::endl;
+
+    return 0;
+}
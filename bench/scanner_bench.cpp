@@ -0,0 +1,28 @@
+#include "../src/scanner/scanner.h"
+#include "bench_utils.h"
+
+#include <iomanip>
+#include <iostream>
+
+// Measures how many tokens per second `StringScanner` can produce
+int main(int argc, char *argv[]) {
+    std::string source = generate_program(bench_units(argc, argv, 20000));
+
+    long token_count = 0;
+    double seconds = time_best(5, [&]() {
+        StringScanner scan = StringScanner(source);
+
+        token_count = 0;
+        while (scan.scan_token().t != TokenType::EOF_)
+            token_count++;
+    });
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Source size:   " << source.length() / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "Tokens:        " << token_count << std::endl;
+    std::cout << "Time:          " << seconds * 1000 << " ms" << std::endl;
+    std::cout << "Tokens/second: " << token_count / seconds / 1e6 << " M" << std::endl;
+    std::cout << "MiB/second:    " << source.length() / seconds / (1024.0 * 1024.0) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/token_buffer.h"
+#include "../src/type_checker/resolver.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+#include "../src/util/thread_pool.h"
+#include "bench_utils.h"
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Measures how type checking scales with the number of threads functions are checked on
+int main(int argc, char *argv[]) {
+    std::string source = generate_program(bench_units(argc, argv, 20000));
+
+    StringScanner scan = StringScanner(source);
+    AstArena arena;
+    Parser parser = Parser(TokenBuffer::tokenize(scan, source.length() / 4), arena);
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    auto stmt = parser.parse_stmt();
+    while (stmt.has_value()) {
+        stmts.push_back(std::move(stmt.value()));
+        stmt = parser.parse_stmt();
+    }
+
+    auto type_env = TypeEnvironment();
+    type_env.generate_type_env(stmts);
+
+    auto resolver = Resolver(type_env.type_env);
+    resolver.resolve(stmts);
+
+    // Checking only reads what resolving set, so the same AST can be checked again and again
+    auto type_checker = TypeChecker(type_env.type_env);
+    double serial_seconds = time_best(5, [&]() {
+        type_checker.check(stmts);
+    });
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Declarations: " << stmts.size() << std::endl;
+    std::cout << "Serial:       " << serial_seconds * 1000 << " ms" << std::endl;
+
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        double seconds = time_best(5, [&]() {
+            type_checker.check_parallel(stmts, pool);
+        });
+
+        std::cout << std::setw(2) << threads << " threads:   " << seconds * 1000 << " ms (" << serial_seconds / seconds << "x)" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,12 @@
+#include "baz_runtime.h"
+
+namespace Baz {
+template <>
+std::string to_string<bool>(const bool &value) {
+    return value ? "true" : "false";
+}
+
+template std::string to_string<int>(const int &value);
+template std::string to_string<float>(const float &value);
+template std::string to_string<std::string>(const std::string &value);
+}
@@ -0,0 +1,35 @@
+// An include guard rather than `#pragma once`, which g++ warns about when precompiling the header
+#ifndef BAZ_RUNTIME_H
+#define BAZ_RUNTIME_H
+
+// Everything generated C++ needs, which is included instead of repeating it in every program
+// Programs link against libbazrt.a, which has the common `to_string`s already compiled
+//
+// NOTE: the build also precompiles this header. It is only used by g++ when a program is compiled with the same flags
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <variant>
+
+namespace Baz {
+template <typename T>
+std::string to_string(const T &value) {
+    std::ostringstream oss;
+    oss << value;
+    return oss.str();
+}
+
+// Bool -> "true" or "false" instead of "1" and "0"
+template <>
+std::string to_string<bool>(const bool &value);
+
+// Compiled once in the runtime library, instead of in every program that prints them
+extern template std::string to_string<int>(const int &value);
+extern template std::string to_string<float>(const float &value);
+extern template std::string to_string<std::string>(const std::string &value);
+}
+
+#endif
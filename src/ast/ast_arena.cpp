@@ -0,0 +1,31 @@
+#include "ast_arena.h"
+
+#include <algorithm>
+
+AstArena::AstArena() : next(nullptr), end(nullptr) {}
+
+void *AstArena::allocate_from_new_block(size_t size, size_t alignment) {
+    // Allocations larger than a block get a block to themselves
+    size_t block_size = std::max(BLOCK_SIZE, size + alignment);
+
+    char *block = this->blocks.emplace_back(new char[block_size]).get();
+    this->next = block;
+    this->end = block + block_size;
+
+    return this->allocate_bytes(size, alignment);
+}
+
+void AstArena::adopt(std::unique_ptr<AstArena> other) {
+    this->adopted.push_back(std::move(other));
+}
+
+void *AstArena::do_allocate(size_t size, size_t alignment) {
+    return this->allocate_bytes(size, alignment);
+}
+
+// Nothing is freed here - memory is only released when the whole arena is destroyed
+void AstArena::do_deallocate(void * /*p*/, size_t /*size*/, size_t /*alignment*/) {}
+
+bool AstArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Destroys an AST node without freeing its memory, which belongs to the `AstArena` it was made in
+struct NodeDeleter {
+    template <typename T>
+    void operator()(T *node) const {
+        node->~T();
+    }
+};
+
+// Owning pointer to a node allocated in an `AstArena`
+template <typename T>
+using NodePtr = std::unique_ptr<T, NodeDeleter>;
+
+// List whose storage is in an `AstArena`, when made by the arena
+template <typename T>
+using ArenaVector = std::pmr::vector<T>;
+
+// Child nodes of an AST node
+template <typename T>
+using NodeList = ArenaVector<NodePtr<T>>;
+
+// Owns every AST node and child list made for a compilation
+//
+// Nodes are bump allocated one after another in parse order, so walking the tree mostly walks forwards
+// through memory. Destroying a node doesn't free anything - all of the memory is released at once when
+// the arena is destroyed, so the arena must outlive every node made in it
+//
+// The arena is also a memory resource, so standard containers can keep their storage in it
+class AstArena final : public std::pmr::memory_resource {
+  private:
+    // Memory is handed out from large blocks which are never moved or freed until the arena is destroyed
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *next;
+    char *end;
+
+    // Arenas whose nodes now belong to this one, kept alive for as long as it is
+    std::vector<std::unique_ptr<AstArena>> adopted;
+
+    // Start a new block big enough for `size` bytes at `alignment`, and allocate them from it
+    void *allocate_from_new_block(size_t size, size_t alignment);
+
+    // Bump allocate, only calling out of line when the current block is full
+    void *allocate_bytes(size_t size, size_t alignment) {
+        uintptr_t start = (reinterpret_cast<uintptr_t>(this->next) + alignment - 1) & ~(alignment - 1);
+        if (start + size > reinterpret_cast<uintptr_t>(this->end))
+            return this->allocate_from_new_block(size, alignment);
+
+        this->next = reinterpret_cast<char *>(start + size);
+        return reinterpret_cast<void *>(start);
+    }
+
+  protected:
+    void *do_allocate(size_t size, size_t alignment) override;
+    void do_deallocate(void *p, size_t size, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+  public:
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+
+    AstArena();
+
+    AstArena(const AstArena &) = delete;
+    AstArena &operator=(const AstArena &) = delete;
+
+    // Take ownership of another arena, so its nodes live as long as this arena's own
+    // Lets nodes be made in separate arenas (e.g. one per thread) and then kept together
+    void adopt(std::unique_ptr<AstArena> other);
+
+    template <typename T, typename... Args>
+    NodePtr<T> make(Args &&...args) {
+        void *memory = this->allocate_bytes(sizeof(T), alignof(T));
+        return NodePtr<T>(new (memory) T(std::forward<Args>(args)...));
+    }
+
+    // Empty list whose storage is allocated in the arena
+    template <typename T>
+    ArenaVector<T> list() {
+        return ArenaVector<T>(this);
+    }
+
+    template <typename T>
+    NodeList<T> nodes() {
+        return this->list<NodePtr<T>>();
+    }
+
+    // Move a list that has finished growing into the arena, taking up exactly as much space as it needs
+    // Lists are built up outside the arena first, as every time an arena list grows it leaves its old storage behind
+    template <typename T>
+    ArenaVector<T> list(std::vector<T> &&items) {
+        ArenaVector<T> list = this->list<T>();
+        list.reserve(items.size());
+        std::move(items.begin(), items.end(), std::back_inserter(list));
+
+        return list;
+    }
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "expr.h"
+#include "stmt.h"
+
+#include <iostream>
+#include <ostream>
+
+// Switch based alternative to `accept`, calling the visitor's method for the kind of node
+//
+// Takes the visitor's own class rather than `ExprVisitor`/`StmtVisitor`, so if that class is `final`
+// the method is called directly (and can be inlined) instead of through two virtual calls
+
+template <typename V>
+void dispatch(Expr *expr, V &visitor) {
+    switch (expr->kind) {
+        case ExprKind::VAR: visitor.visit_var_expr(static_cast<VarExpr *>(expr)); return;
+        case ExprKind::STRUCT_INIT: visitor.visit_struct_init_expr(static_cast<StructInitExpr *>(expr)); return;
+        case ExprKind::BINARY: visitor.visit_binary_expr(static_cast<BinaryExpr *>(expr)); return;
+        case ExprKind::UNARY: visitor.visit_unary_expr(static_cast<UnaryExpr *>(expr)); return;
+        case ExprKind::GET: visitor.visit_get_expr(static_cast<GetExpr *>(expr)); return;
+        case ExprKind::ENUM_INIT: visitor.visit_enum_init_expr(static_cast<EnumInitExpr *>(expr)); return;
+        case ExprKind::CALL: visitor.visit_call_expr(static_cast<CallExpr *>(expr)); return;
+        case ExprKind::GROUPING: visitor.visit_grouping_expr(static_cast<GroupingExpr *>(expr)); return;
+        case ExprKind::LITERAL: visitor.visit_literal_expr(static_cast<LiteralExpr *>(expr)); return;
+    }
+
+    std::cerr << "[BUG] unknown expression kind" << std::endl;
+    exit(3);
+}
+
+template <typename V>
+void dispatch(Stmt *stmt, V &visitor) {
+    switch (stmt->kind) {
+        case StmtKind::FUN_DECL: visitor.visit_fun_decl_stmt(static_cast<FunDeclStmt *>(stmt)); return;
+        case StmtKind::ENUM_METHOD_DECL: visitor.visit_enum_method_decl_stmt(static_cast<EnumMethodDeclStmt *>(stmt)); return;
+        case StmtKind::STRUCT_DECL: visitor.visit_struct_decl_stmt(static_cast<StructDeclStmt *>(stmt)); return;
+        case StmtKind::ENUM_DECL: visitor.visit_enum_decl_stmt(static_cast<EnumDeclStmt *>(stmt)); return;
+        case StmtKind::VARIABLE_DECL: visitor.visit_variable_decl_stmt(static_cast<VariableDeclStmt *>(stmt)); return;
+        case StmtKind::EXPR: visitor.visit_expr_stmt(static_cast<ExprStmt *>(stmt)); return;
+        case StmtKind::BLOCK: visitor.visit_block_stmt(static_cast<BlockStmt *>(stmt)); return;
+        case StmtKind::IF: visitor.visit_if_stmt(static_cast<IfStmt *>(stmt)); return;
+        case StmtKind::MATCH: visitor.visit_match_stmt(static_cast<MatchStmt *>(stmt)); return;
+        case StmtKind::WHILE: visitor.visit_while_stmt(static_cast<WhileStmt *>(stmt)); return;
+        case StmtKind::ASSIGN: visitor.visit_assign_stmt(static_cast<AssignStmt *>(stmt)); return;
+        case StmtKind::FOR: visitor.visit_for_stmt(static_cast<ForStmt *>(stmt)); return;
+        case StmtKind::PRINT: visitor.visit_print_stmt(static_cast<PrintStmt *>(stmt)); return;
+        case StmtKind::PANIC: visitor.visit_panic_stmt(static_cast<PanicStmt *>(stmt)); return;
+        case StmtKind::RETURN: visitor.visit_return_stmt(static_cast<ReturnStmt *>(stmt)); return;
+        case StmtKind::SET: visitor.visit_set_stmt(static_cast<SetStmt *>(stmt)); return;
+    }
+
+    std::cerr << "[BUG] unknown statement kind" << std::endl;
+    exit(3);
+}
+
+// Allow dispatching on owned nodes directly
+template <typename T, typename V>
+void dispatch(const NodePtr<T> &node, V &visitor) {
+    dispatch(node.get(), visitor);
+}
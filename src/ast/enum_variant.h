@@ -3,11 +3,17 @@
 #include "../scanner/token.h"
 #include <optional>
 
+struct Type;
+
 struct EnumVariant {
     Token name;
 
     std::optional<Token> payload_type;
     bool is_optional;
 
-    EnumVariant(Token name, std::optional<Token> payload_type, bool is_optional) : name(name), payload_type(payload_type), is_optional(is_optional) {}
+    // NOTE: this gets set by the type environment
+    // nullptr if there is no payload, or no type with that name
+    Type *resolved_payload_type;
+
+    EnumVariant(Token name, std::optional<Token> payload_type, bool is_optional) : name(name), payload_type(payload_type), is_optional(is_optional), resolved_payload_type(nullptr) {}
 };
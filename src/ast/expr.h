@@ -2,7 +2,9 @@
 
 #include "../scanner/token.h"
 #include "../type_checker/type.h"
+#include "ast_arena.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <optional>
@@ -13,10 +15,32 @@ class ExprVisitor;
 
 // Type + whether it is optional
 struct TypeInfo {
-    std::shared_ptr<Type> type;
+    Type *type;
     bool optional;
 
-    TypeInfo(std::shared_ptr<Type> type, bool optional);
+    TypeInfo(Type *type, bool optional);
+};
+
+// Where a variable is declared, relative to the scope it is used in
+struct VariableSlot {
+    // How many scopes out from the use (0 is the scope it is used in)
+    uint32_t depth;
+
+    // Position within that scope, in declaration order
+    uint32_t slot;
+};
+
+// Which kind of expression a node is, so passes can switch on it instead of using virtual calls or RTTI
+enum class ExprKind : uint8_t {
+    VAR,
+    STRUCT_INIT,
+    BINARY,
+    UNARY,
+    GET,
+    ENUM_INIT,
+    CALL,
+    GROUPING,
+    LITERAL,
 };
 
 struct Expr {
@@ -25,95 +49,127 @@ struct Expr {
     std::optional<TypeInfo> type_info;
 
   public:
+    const ExprKind kind;
+
     virtual void accept(ExprVisitor &visitor) = 0;
     TypeInfo get_type_info();
     void set_type_info(TypeInfo type_info);
 
-    Expr() : type_info(std::nullopt) {}
+    Expr(ExprKind kind) : type_info(std::nullopt), kind(kind) {}
     virtual ~Expr() = default;
 };
 
 //// Types of expressions
 
 struct VarExpr : public Expr {
+    static const ExprKind KIND = ExprKind::VAR;
+
     Token name;
 
+    // NOTE: this gets set when resolving
+    VariableSlot slot;
+
     VarExpr(Token name);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct StructInitExpr : public Expr {
+    static const ExprKind KIND = ExprKind::STRUCT_INIT;
+
     Token name;
-    std::vector<std::tuple<Token, std::unique_ptr<Expr>>> properties;
 
-    StructInitExpr(Token name, std::vector<std::tuple<Token, std::unique_ptr<Expr>>> properties);
+    // In the order they were written, which may not be the order the struct declares its properties
+    ArenaVector<std::tuple<Token, NodePtr<Expr>>> properties;
+
+    StructInitExpr(Token name, ArenaVector<std::tuple<Token, NodePtr<Expr>>> properties);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct BinaryExpr : public Expr {
-    std::unique_ptr<Expr> left;
+    static const ExprKind KIND = ExprKind::BINARY;
+
+    NodePtr<Expr> left;
     Token op;
-    std::unique_ptr<Expr> right;
+    NodePtr<Expr> right;
 
-    BinaryExpr(std::unique_ptr<Expr> left, Token op, std::unique_ptr<Expr> right);
+    BinaryExpr(NodePtr<Expr> left, Token op, NodePtr<Expr> right);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct UnaryExpr : public Expr {
+    static const ExprKind KIND = ExprKind::UNARY;
+
     Token op;
-    std::unique_ptr<Expr> right;
+    NodePtr<Expr> right;
 
-    UnaryExpr(Token op, std::unique_ptr<Expr> right);
+    UnaryExpr(Token op, NodePtr<Expr> right);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct GetExpr : public Expr {
-    std::unique_ptr<Expr> object;
+    static const ExprKind KIND = ExprKind::GET;
+
+    NodePtr<Expr> object;
     Token name;
     bool optional;
 
-    GetExpr(std::unique_ptr<Expr> value, Token name, bool optional);
+    GetExpr(NodePtr<Expr> value, Token name, bool optional);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct EnumInitExpr : public Expr {
+    static const ExprKind KIND = ExprKind::ENUM_INIT;
+
     Token variant;
-    std::unique_ptr<VarExpr> enum_namespace;
-    std::optional<std::unique_ptr<Expr>> payload;
+    NodePtr<VarExpr> enum_namespace;
+    std::optional<NodePtr<Expr>> payload;
 
-    EnumInitExpr(Token name, std::unique_ptr<VarExpr> enum_namespace, std::optional<std::unique_ptr<Expr>> payload);
+    EnumInitExpr(Token name, NodePtr<VarExpr> enum_namespace, std::optional<NodePtr<Expr>> payload);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct CallExpr : public Expr {
-    std::unique_ptr<Expr> callee;
-    std::vector<std::unique_ptr<Expr>> args;
+    static const ExprKind KIND = ExprKind::CALL;
+
+    NodePtr<Expr> callee;
+    NodeList<Expr> args;
 
     Token bracket;
 
-    CallExpr(std::unique_ptr<Expr> callee, std::vector<std::unique_ptr<Expr>> args, Token bracket);
+    CallExpr(NodePtr<Expr> callee, NodeList<Expr> args, Token bracket);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct GroupingExpr : public Expr {
-    std::unique_ptr<Expr> expr;
+    static const ExprKind KIND = ExprKind::GROUPING;
+
+    NodePtr<Expr> expr;
 
-    GroupingExpr(std::unique_ptr<Expr> expr);
+    GroupingExpr(NodePtr<Expr> expr);
 
     void accept(ExprVisitor &visitor) override;
 };
 
 struct LiteralExpr : public Expr {
+    static const ExprKind KIND = ExprKind::LITERAL;
+
     Token literal;
 
     LiteralExpr(Token literal);
 
     void accept(ExprVisitor &visitor) override;
 };
+
+// Cast to a specific type of expression, or nullptr if it is a different kind
+// Like `dynamic_cast`, but only compares the kind tag
+template <typename T>
+T *node_cast(Expr *expr) {
+    return expr && expr->kind == T::KIND ? static_cast<T *>(expr) : nullptr;
+}
@@ -6,90 +6,102 @@
 
 //// Visitor pattern boilerplate code
 
-FunDeclStmt::FunDeclStmt(Token name, std::vector<TypedVar> params, Token return_type, bool return_type_optional, std::vector<std::unique_ptr<Stmt>> body, FunType fun_type)
-    : name(name), params(params), return_type(return_type), return_type_optional(return_type_optional), body(std::move(body)), fun_type(fun_type) {}
+FunDeclStmt::FunDeclStmt(Token name, std::vector<TypedVar> params, Token return_type, bool return_type_optional, NodeList<Stmt> body, FunType fun_type)
+    : Stmt(StmtKind::FUN_DECL), name(name), params(params), return_type(return_type), return_type_optional(return_type_optional), fun_type(fun_type), type(nullptr), body(std::move(body)), body_parser(nullptr), body_start(0) {}
+void FunDeclStmt::defer_body(BodyParser *parser, size_t start) {
+    this->body_parser = parser;
+    this->body_start = start;
+}
+NodeList<Stmt> &FunDeclStmt::get_body() {
+    if (this->body_parser) {
+        this->body = this->body_parser->parse_body(this->body_start);
+        this->body_parser = nullptr;
+    }
+
+    return this->body;
+}
 void FunDeclStmt::accept(StmtVisitor &visitor) {
     visitor.visit_fun_decl_stmt(this);
 }
 
-EnumMethodDeclStmt::EnumMethodDeclStmt(std::unique_ptr<FunDeclStmt> fun_definition, Token enum_name)
-    : fun_definition(std::move(fun_definition)), enum_name(enum_name) {}
+EnumMethodDeclStmt::EnumMethodDeclStmt(NodePtr<FunDeclStmt> fun_definition, Token enum_name)
+    : Stmt(StmtKind::ENUM_METHOD_DECL), fun_definition(std::move(fun_definition)), enum_name(enum_name) {}
 void EnumMethodDeclStmt::accept(StmtVisitor &visitor) {
     visitor.visit_enum_method_decl_stmt(this);
 }
 
-StructDeclStmt::StructDeclStmt(Token name, std::vector<TypedVar> properties, std::vector<std::unique_ptr<FunDeclStmt>> methods)
-    : name(name), properties(properties), methods(std::move(methods)) {}
+StructDeclStmt::StructDeclStmt(Token name, std::vector<TypedVar> properties, NodeList<FunDeclStmt> methods)
+    : Stmt(StmtKind::STRUCT_DECL), name(name), properties(properties), methods(std::move(methods)) {}
 void StructDeclStmt::accept(StmtVisitor &visitor) {
     visitor.visit_struct_decl_stmt(this);
 }
 
-EnumDeclStmt::EnumDeclStmt(Token name, std::vector<EnumVariant> variants, std::vector<std::unique_ptr<EnumMethodDeclStmt>> methods)
-    : name(name), variants(variants), methods(std::move(methods)) {}
+EnumDeclStmt::EnumDeclStmt(Token name, std::vector<EnumVariant> variants, NodeList<EnumMethodDeclStmt> methods)
+    : Stmt(StmtKind::ENUM_DECL), name(name), variants(variants), methods(std::move(methods)) {}
 void EnumDeclStmt::accept(StmtVisitor &visitor) {
     visitor.visit_enum_decl_stmt(this);
 }
 
-VariableDeclStmt::VariableDeclStmt(TypedVar name, std::unique_ptr<Expr> initialiser) : name(name), initialiser(std::move(initialiser)) {}
+VariableDeclStmt::VariableDeclStmt(TypedVar name, NodePtr<Expr> initialiser) : Stmt(StmtKind::VARIABLE_DECL), name(name), initialiser(std::move(initialiser)) {}
 void VariableDeclStmt::accept(StmtVisitor &visitor) {
     visitor.visit_variable_decl_stmt(this);
 }
 
-ExprStmt::ExprStmt(std::unique_ptr<Expr> expr) : expr(std::move(expr)) {}
+ExprStmt::ExprStmt(NodePtr<Expr> expr) : Stmt(StmtKind::EXPR), expr(std::move(expr)) {}
 void ExprStmt::accept(StmtVisitor &visitor) {
     visitor.visit_expr_stmt(this);
 }
 
-BlockStmt::BlockStmt(std::vector<std::unique_ptr<Stmt>> stmts) : stmts(std::move(stmts)) {}
+BlockStmt::BlockStmt(NodeList<Stmt> stmts) : Stmt(StmtKind::BLOCK), stmts(std::move(stmts)) {}
 void BlockStmt::accept(StmtVisitor &visitor) {
     visitor.visit_block_stmt(this);
 }
 
-IfStmt::IfStmt(Token keyword, std::unique_ptr<Expr> condition, std::vector<std::unique_ptr<Stmt>> true_block, std::optional<std::vector<std::unique_ptr<Stmt>>> false_block)
-    : keyword(keyword), condition(std::move(condition)), true_block(std::move(true_block)), false_block(std::move(false_block)) {}
+IfStmt::IfStmt(Token keyword, NodePtr<Expr> condition, NodeList<Stmt> true_block, std::optional<NodeList<Stmt>> false_block)
+    : Stmt(StmtKind::IF), keyword(keyword), condition(std::move(condition)), true_block(std::move(true_block)), false_block(std::move(false_block)) {}
 void IfStmt::accept(StmtVisitor &visitor) {
     visitor.visit_if_stmt(this);
 }
 
-EnumPattern::EnumPattern(Token enum_type, Token enum_variant, std::optional<std::unique_ptr<VarExpr>> bound_variable) : enum_type(enum_type), enum_variant(enum_variant), bound_variable(std::move(bound_variable)) {}
+EnumPattern::EnumPattern(Token enum_type, Token enum_variant, std::optional<NodePtr<VarExpr>> bound_variable) : enum_type(enum_type), enum_variant(enum_variant), bound_variable(std::move(bound_variable)) {}
 
-CatchAllPattern::CatchAllPattern(std::unique_ptr<VarExpr> bound_variable) : bound_variable(std::move(bound_variable)) {}
+CatchAllPattern::CatchAllPattern(NodePtr<VarExpr> bound_variable) : bound_variable(std::move(bound_variable)) {}
 
-MatchBranch::MatchBranch(MatchPattern pattern, std::vector<std::unique_ptr<Stmt>> body) : pattern(std::move(pattern)), body(std::move(body)) {}
+MatchBranch::MatchBranch(MatchPattern pattern, NodeList<Stmt> body) : pattern(std::move(pattern)), body(std::move(body)) {}
 
-MatchStmt::MatchStmt(std::unique_ptr<Expr> target, std::vector<MatchBranch> branches, Token keyword)
-    : target(std::move(target)), branches(std::move(branches)), keyword(keyword) {}
+MatchStmt::MatchStmt(NodePtr<Expr> target, ArenaVector<MatchBranch> branches, Token keyword)
+    : Stmt(StmtKind::MATCH), target(std::move(target)), branches(std::move(branches)), keyword(keyword) {}
 void MatchStmt::accept(StmtVisitor &visitor) {
     visitor.visit_match_stmt(this);
 }
 
-WhileStmt::WhileStmt(std::unique_ptr<Expr> condition, std::vector<std::unique_ptr<Stmt>> stmts, Token keyword) : condition(std::move(condition)), stmts(std::move(stmts)), keyword(keyword) {}
+WhileStmt::WhileStmt(NodePtr<Expr> condition, NodeList<Stmt> stmts, Token keyword) : Stmt(StmtKind::WHILE), condition(std::move(condition)), stmts(std::move(stmts)), keyword(keyword) {}
 void WhileStmt::accept(StmtVisitor &visitor) {
     visitor.visit_while_stmt(this);
 }
 
-ForStmt::ForStmt(std::unique_ptr<VariableDeclStmt> var, std::unique_ptr<ExprStmt> condition, std::unique_ptr<AssignStmt> increment, std::vector<std::unique_ptr<Stmt>> stmts)
-    : var(std::move(var)), condition(std::move(condition)), increment(std::move(increment)), stmts(std::move(stmts)) {}
+ForStmt::ForStmt(NodePtr<VariableDeclStmt> var, NodePtr<ExprStmt> condition, NodePtr<AssignStmt> increment, NodeList<Stmt> stmts)
+    : Stmt(StmtKind::FOR), var(std::move(var)), condition(std::move(condition)), increment(std::move(increment)), stmts(std::move(stmts)) {}
 void ForStmt::accept(StmtVisitor &visitor) {
     visitor.visit_for_stmt(this);
 }
 
-PrintStmt::PrintStmt(std::optional<std::unique_ptr<Expr>> expr, bool newline) : expr(std::move(expr)), newline(newline) {}
+PrintStmt::PrintStmt(std::optional<NodePtr<Expr>> expr, bool newline) : Stmt(StmtKind::PRINT), expr(std::move(expr)), newline(newline) {}
 void PrintStmt::accept(StmtVisitor &visitor) {
     visitor.visit_print_stmt(this);
 }
 
-PanicStmt::PanicStmt(std::optional<std::unique_ptr<Expr>> expr) : expr(std::move(expr)) {}
+PanicStmt::PanicStmt(std::optional<NodePtr<Expr>> expr) : Stmt(StmtKind::PANIC), expr(std::move(expr)) {}
 void PanicStmt::accept(StmtVisitor &visitor) {
     visitor.visit_panic_stmt(this);
 }
 
-ReturnStmt::ReturnStmt(std::optional<std::unique_ptr<Expr>> expr, Token keyword) : expr(std::move(expr)), keyword(keyword) {}
+ReturnStmt::ReturnStmt(std::optional<NodePtr<Expr>> expr, Token keyword) : Stmt(StmtKind::RETURN), expr(std::move(expr)), keyword(keyword) {}
 void ReturnStmt::accept(StmtVisitor &visitor) {
     visitor.visit_return_stmt(this);
 }
 
-AssignStmt::AssignStmt(Token name, std::unique_ptr<Expr> value) : name(name), value(std::move(value)), semicolon(true), target_type_info(std::nullopt) {}
+AssignStmt::AssignStmt(Token name, NodePtr<Expr> value) : Stmt(StmtKind::ASSIGN), name(name), value(std::move(value)), semicolon(true), slot{0, 0}, target_type_info(std::nullopt) {}
 void AssignStmt::accept(StmtVisitor &visitor) {
     visitor.visit_assign_stmt(this);
 }
@@ -107,7 +119,7 @@ void AssignStmt::set_target_type_info(TypeInfo type_info) {
     this->target_type_info = type_info;
 }
 
-SetStmt::SetStmt(std::unique_ptr<Expr> object, Token name, std::unique_ptr<Expr> value) : object(std::move(object)), name(name), value(std::move(value)), target_type_info(std::nullopt) {}
+SetStmt::SetStmt(NodePtr<Expr> object, Token name, NodePtr<Expr> value) : Stmt(StmtKind::SET), object(std::move(object)), name(name), value(std::move(value)), target_type_info(std::nullopt) {}
 void SetStmt::accept(StmtVisitor &visitor) {
     visitor.visit_set_stmt(this);
 }
@@ -13,9 +13,32 @@
 // Forward declaration - actual implementation will import the visitor
 class StmtVisitor;
 
+// Which kind of statement a node is, so passes can switch on it instead of using virtual calls or RTTI
+enum class StmtKind : uint8_t {
+    FUN_DECL,
+    ENUM_METHOD_DECL,
+    STRUCT_DECL,
+    ENUM_DECL,
+    VARIABLE_DECL,
+    EXPR,
+    BLOCK,
+    IF,
+    MATCH,
+    WHILE,
+    ASSIGN,
+    FOR,
+    PRINT,
+    PANIC,
+    RETURN,
+    SET,
+};
+
 struct Stmt {
+    const StmtKind kind;
+
     virtual void accept(StmtVisitor &visitor) = 0;
 
+    Stmt(StmtKind kind) : kind(kind) {}
     virtual ~Stmt() = default;
 };
 
@@ -24,83 +47,124 @@ enum FunType {
     METHOD,
 };
 
+// Parses a function body that was skipped over, the first time it is needed
+class BodyParser {
+  public:
+    virtual ~BodyParser() = default;
+
+    // Parse the body whose statements start at token `start`, just after its `{`
+    virtual NodeList<Stmt> parse_body(size_t start) = 0;
+};
+
 //// Types of statements
 
 struct FunDeclStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::FUN_DECL;
+
     Token name;
     Token return_type;
     bool return_type_optional;
 
     std::vector<TypedVar> params;
-    std::vector<std::unique_ptr<Stmt>> body;
     FunType fun_type;
 
-    FunDeclStmt(Token name, std::vector<TypedVar> params, Token return_type, bool return_type_optional, std::vector<std::unique_ptr<Stmt>> body, FunType fun_type);
+    // NOTE: this gets set by the type environment
+    FunctionType *type;
+
+    // NOTE: may not have been parsed yet - use `get_body`
+    NodeList<Stmt> body;
+
+    // Set until a skipped body is parsed
+    BodyParser *body_parser;
+    size_t body_start;
+
+    FunDeclStmt(Token name, std::vector<TypedVar> params, Token return_type, bool return_type_optional, NodeList<Stmt> body, FunType fun_type);
+
+    // Parse the body later, when it is first asked for
+    void defer_body(BodyParser *parser, size_t start);
+
+    // The body's statements, parsing them first if they were skipped over
+    // Not thread safe, so every body must be parsed before functions are shared between threads
+    NodeList<Stmt> &get_body();
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct EnumMethodDeclStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::ENUM_METHOD_DECL;
+
     Token enum_name;
-    std::unique_ptr<FunDeclStmt> fun_definition;
+    NodePtr<FunDeclStmt> fun_definition;
 
-    EnumMethodDeclStmt(std::unique_ptr<FunDeclStmt> fun_definition, Token enum_name);
+    EnumMethodDeclStmt(NodePtr<FunDeclStmt> fun_definition, Token enum_name);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct StructDeclStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::STRUCT_DECL;
+
     Token name;
     std::vector<TypedVar> properties;
-    std::vector<std::unique_ptr<FunDeclStmt>> methods;
+    NodeList<FunDeclStmt> methods;
 
-    StructDeclStmt(Token name, std::vector<TypedVar> properties, std::vector<std::unique_ptr<FunDeclStmt>> methods);
+    StructDeclStmt(Token name, std::vector<TypedVar> properties, NodeList<FunDeclStmt> methods);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct EnumDeclStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::ENUM_DECL;
+
     Token name;
     std::vector<EnumVariant> variants;
-    std::vector<std::unique_ptr<EnumMethodDeclStmt>> methods;
+    NodeList<EnumMethodDeclStmt> methods;
 
-    EnumDeclStmt(Token name, std::vector<EnumVariant> variants, std::vector<std::unique_ptr<EnumMethodDeclStmt>> methods);
+    EnumDeclStmt(Token name, std::vector<EnumVariant> variants, NodeList<EnumMethodDeclStmt> methods);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct VariableDeclStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::VARIABLE_DECL;
+
     TypedVar name;
-    std::unique_ptr<Expr> initialiser;
+    NodePtr<Expr> initialiser;
 
-    VariableDeclStmt(TypedVar name, std::unique_ptr<Expr> initialiser);
+    VariableDeclStmt(TypedVar name, NodePtr<Expr> initialiser);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct ExprStmt : public Stmt {
-    std::unique_ptr<Expr> expr;
+    static const StmtKind KIND = StmtKind::EXPR;
 
-    ExprStmt(std::unique_ptr<Expr> expr);
+    NodePtr<Expr> expr;
+
+    ExprStmt(NodePtr<Expr> expr);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct BlockStmt : public Stmt {
-    std::vector<std::unique_ptr<Stmt>> stmts;
+    static const StmtKind KIND = StmtKind::BLOCK;
+
+    NodeList<Stmt> stmts;
 
-    BlockStmt(std::vector<std::unique_ptr<Stmt>> stmts);
+    BlockStmt(NodeList<Stmt> stmts);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct IfStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::IF;
+
     Token keyword;
-    std::unique_ptr<Expr> condition;
-    std::vector<std::unique_ptr<Stmt>> true_block;
-    std::optional<std::vector<std::unique_ptr<Stmt>>> false_block;
+    NodePtr<Expr> condition;
+    NodeList<Stmt> true_block;
+    std::optional<NodeList<Stmt>> false_block;
 
-    IfStmt(Token keyword, std::unique_ptr<Expr> condition, std::vector<std::unique_ptr<Stmt>> true_block, std::optional<std::vector<std::unique_ptr<Stmt>>> false_block);
+    IfStmt(Token keyword, NodePtr<Expr> condition, NodeList<Stmt> true_block, std::optional<NodeList<Stmt>> false_block);
 
     void accept(StmtVisitor &visitor) override;
 };
@@ -110,15 +174,15 @@ struct EnumPattern {
     Token enum_variant;
 
     // NOTE: if the enum variant has a payload, this is required
-    std::optional<std::unique_ptr<VarExpr>> bound_variable;
+    std::optional<NodePtr<VarExpr>> bound_variable;
 
-    EnumPattern(Token enum_type, Token enum_variant, std::optional<std::unique_ptr<VarExpr>> bound_variable);
+    EnumPattern(Token enum_type, Token enum_variant, std::optional<NodePtr<VarExpr>> bound_variable);
 };
 
 struct CatchAllPattern {
-    std::unique_ptr<VarExpr> bound_variable;
+    NodePtr<VarExpr> bound_variable;
 
-    CatchAllPattern(std::unique_ptr<VarExpr> bound_variable);
+    CatchAllPattern(NodePtr<VarExpr> bound_variable);
 };
 
 struct NullPattern {};
@@ -127,102 +191,128 @@ using MatchPattern = std::variant<EnumPattern, NullPattern, CatchAllPattern>;
 
 struct MatchBranch {
     MatchPattern pattern;
-    std::vector<std::unique_ptr<Stmt>> body;
+    NodeList<Stmt> body;
 
-    MatchBranch(MatchPattern pattern, std::vector<std::unique_ptr<Stmt>> body);
+    MatchBranch(MatchPattern pattern, NodeList<Stmt> body);
 };
 
 struct MatchStmt : public Stmt {
-    std::unique_ptr<Expr> target;
-    std::vector<MatchBranch> branches;
+    static const StmtKind KIND = StmtKind::MATCH;
+
+    NodePtr<Expr> target;
+    ArenaVector<MatchBranch> branches;
     Token keyword;
 
-    MatchStmt(std::unique_ptr<Expr> target, std::vector<MatchBranch> branches, Token keyword);
+    MatchStmt(NodePtr<Expr> target, ArenaVector<MatchBranch> branches, Token keyword);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct WhileStmt : public Stmt {
-    std::unique_ptr<Expr> condition;
-    std::vector<std::unique_ptr<Stmt>> stmts;
+    static const StmtKind KIND = StmtKind::WHILE;
+
+    NodePtr<Expr> condition;
+    NodeList<Stmt> stmts;
 
     Token keyword;
 
-    WhileStmt(std::unique_ptr<Expr> condition, std::vector<std::unique_ptr<Stmt>> stmts, Token keyword);
+    WhileStmt(NodePtr<Expr> condition, NodeList<Stmt> stmts, Token keyword);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct AssignStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::ASSIGN;
+
   private:
     // NOTE: this gets set when resolving/type checking
     std::optional<TypeInfo> target_type_info;
 
   public:
     Token name;
-    std::unique_ptr<Expr> value;
+    NodePtr<Expr> value;
     bool semicolon;
 
+    // NOTE: this gets set when resolving
+    VariableSlot slot;
+
     TypeInfo get_target_type_info();
     void set_target_type_info(TypeInfo type_info);
 
-    AssignStmt(Token name, std::unique_ptr<Expr> value);
+    AssignStmt(Token name, NodePtr<Expr> value);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct ForStmt : public Stmt {
-    std::unique_ptr<VariableDeclStmt> var;
-    std::unique_ptr<ExprStmt> condition;
-    std::unique_ptr<AssignStmt> increment;
-    std::vector<std::unique_ptr<Stmt>> stmts;
+    static const StmtKind KIND = StmtKind::FOR;
+
+    NodePtr<VariableDeclStmt> var;
+    NodePtr<ExprStmt> condition;
+    NodePtr<AssignStmt> increment;
+    NodeList<Stmt> stmts;
 
-    ForStmt(std::unique_ptr<VariableDeclStmt> var, std::unique_ptr<ExprStmt> condition, std::unique_ptr<AssignStmt> increment, std::vector<std::unique_ptr<Stmt>> stmts);
+    ForStmt(NodePtr<VariableDeclStmt> var, NodePtr<ExprStmt> condition, NodePtr<AssignStmt> increment, NodeList<Stmt> stmts);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct PrintStmt : public Stmt {
-    std::optional<std::unique_ptr<Expr>> expr;
+    static const StmtKind KIND = StmtKind::PRINT;
+
+    std::optional<NodePtr<Expr>> expr;
     bool newline;
 
-    PrintStmt(std::optional<std::unique_ptr<Expr>> expr, bool newline);
+    PrintStmt(std::optional<NodePtr<Expr>> expr, bool newline);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct PanicStmt : public Stmt {
-    std::optional<std::unique_ptr<Expr>> expr;
+    static const StmtKind KIND = StmtKind::PANIC;
+
+    std::optional<NodePtr<Expr>> expr;
 
-    PanicStmt(std::optional<std::unique_ptr<Expr>> expr);
+    PanicStmt(std::optional<NodePtr<Expr>> expr);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct ReturnStmt : public Stmt {
-    std::optional<std::unique_ptr<Expr>> expr;
+    static const StmtKind KIND = StmtKind::RETURN;
+
+    std::optional<NodePtr<Expr>> expr;
     Token keyword;
 
-    ReturnStmt(std::optional<std::unique_ptr<Expr>> expr, Token keyword);
+    ReturnStmt(std::optional<NodePtr<Expr>> expr, Token keyword);
 
     void accept(StmtVisitor &visitor) override;
 };
 
 struct SetStmt : public Stmt {
+    static const StmtKind KIND = StmtKind::SET;
+
   private:
     // NOTE: this gets set when resolving/type checking
     std::optional<TypeInfo> target_type_info;
 
   public:
-    std::unique_ptr<Expr> object;
+    NodePtr<Expr> object;
     Token name;
 
-    std::unique_ptr<Expr> value;
+    NodePtr<Expr> value;
 
     TypeInfo get_target_type_info();
     void set_target_type_info(TypeInfo type_info);
 
-    SetStmt(std::unique_ptr<Expr> object, Token name, std::unique_ptr<Expr> value);
+    SetStmt(NodePtr<Expr> object, Token name, NodePtr<Expr> value);
 
     void accept(StmtVisitor &visitor) override;
 };
+
+// Cast to a specific type of statement, or nullptr if it is a different kind
+// Like `dynamic_cast`, but only compares the kind tag
+template <typename T>
+T *node_cast(Stmt *stmt) {
+    return stmt && stmt->kind == T::KIND ? static_cast<T *>(stmt) : nullptr;
+}
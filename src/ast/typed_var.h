@@ -4,11 +4,17 @@
 
 #include <memory>
 
+struct Type;
+
 // Utility class to contain variable name and type
 struct TypedVar {
     Token name;
     Token type;
     bool is_optional;
 
-    TypedVar(Token name, Token type, bool is_optional) : name(name), type(type), is_optional(is_optional) {}
+    // NOTE: this gets set by the type environment (or the resolver for local variables)
+    // nullptr if there is no type with that name
+    Type *resolved_type;
+
+    TypedVar(Token name, Token type, bool is_optional) : name(name), type(type), is_optional(is_optional), resolved_type(nullptr) {}
 };
@@ -1,4 +1,5 @@
 #include "cpp_generator.h"
+#include "../ast/dispatch.h"
 
 #include <algorithm>
 #include <iostream>
@@ -10,92 +11,161 @@ inline const std::string BAZ_NAMESPACE = "Baz";
 
 // Convert a string representing a Baz type into the equivalent type in C++
 std::string baz_to_cpp_type(Token type, bool optional) {
-    if (type.t == TokenType::TYPE && type.lexeme == "str") {
+    if (type.t == TokenType::TYPE && type.symbol == SYM_STR) {
         return optional ? "std::optional<std::string>" : "std::string";
     }
 
     auto pointer = type.t == TokenType::IDENTIFIER ? "*" : "";
-    auto full_non_optional_type = type.lexeme + pointer;
+    auto full_non_optional_type = std::string(type.lexeme) + pointer;
     return optional ? "std::optional<" + full_non_optional_type + ">" : full_non_optional_type;
 }
 
-// Get the namespaced variant struct name
-std::string enum_variant_name(std::string enum_name, std::string variant_name, bool namespaced = true) {
-    return (namespaced ? BAZ_NAMESPACE + "::" : "") + enum_name + "_" + variant_name;
+// Get the variant struct name, which is inside the Baz namespace
+const std::string &enum_variant_name(EnumType *t, Symbol variant) {
+    auto index = t->variant_index(variant);
+    if (!index.has_value()) {
+        std::cerr << "[BUG] Unknown enum variant. This should be checked in the resolver." << std::endl;
+        exit(3);
+    }
+
+    return t->variant_cpp_names[index.value()];
+}
+
+// Get the enum method function name, which is inside the Baz namespace
+const std::string &enum_method_name(EnumType *t, Symbol method) {
+    auto index = t->method_index(method);
+    if (!index.has_value()) {
+        std::cerr << "[BUG] Unknown enum method. This should be checked in the resolver." << std::endl;
+        exit(3);
+    }
+
+    return t->method_cpp_names[index.value()];
+}
+
+CppGenerator::CppGenerator(OutputSink &sink, const TypeTable &type_env) : output(&sink), this_keyword("this"), type_env(type_env), part(DeclPart::ALL) {}
+
+void CppGenerator::generate(NodeList<Stmt> &stmts) {
+    this->generate_preamble();
+
+    for (auto &stmt : stmts) {
+        this->generate_decl(stmt.get());
+    }
+}
+
+// Generate the declarations on the pool's threads, each job writing a run of them into its own buffer
+// The buffers are written out in source order, so the output is identical to generating serially
+void CppGenerator::generate(NodeList<Stmt> &stmts, ThreadPool &pool) {
+    // Buffering is only worth it if the declarations are actually split between threads
+    size_t job_count = std::min(stmts.size(), pool.size() * ThreadPool::JOBS_PER_THREAD);
+    if (pool.size() == 1 || job_count <= 1) {
+        this->generate(stmts);
+        return;
+    }
+
+    this->generate_preamble();
+
+    std::vector<std::string> buffers(job_count);
+    pool.for_each(job_count, [&](size_t job) {
+        MemorySink buffer;
+        CppGenerator generator(buffer, this->type_env);
+
+        size_t begin = stmts.size() * job / job_count;
+        size_t end = stmts.size() * (job + 1) / job_count;
+        for (size_t i = begin; i < end; i++) {
+            generator.generate_decl(stmts[i].get());
+        }
+
+        buffers[job] = buffer.view();
+    });
+
+    for (auto &buffer : buffers) {
+        this->output << buffer;
+    }
 }
 
-// Get the namespaced enum method
-std::string enum_method_name(std::string enum_name, std::string method_name, bool namespaced = true) {
-    return (namespaced ? BAZ_NAMESPACE + "::" : "") + enum_name + "_" + method_name;
+// A top level declaration, followed by a blank line
+void CppGenerator::generate_decl(Stmt *stmt) {
+    dispatch(stmt, *this);
+    this->output << '\n';
 }
 
-CppGenerator::CppGenerator(std::ostream &output, std::map<std::string, std::shared_ptr<Type>> type_env) : output(output), this_keyword("this"), type_env(type_env) {}
+void CppGenerator::generate_header(NodeList<Stmt> &stmts) {
+    this->output << "#pragma once" << '\n'
+                 << '\n';
 
-void CppGenerator::generate(std::vector<std::unique_ptr<Stmt>> &stmts) {
-    // Relevant includes
-    this->output << "#include <iostream>" << std::endl
-                 << "#include <variant>" << std::endl
-                 << "#include <string>" << std::endl
-                 << "#include <optional>" << std::endl
-                 << "#include <sstream>" << std::endl
-                 << std::endl;
+    this->generate_preamble();
 
-    // To-string function - adds specialisation for booleans to print as "true" or "false"
-    this->output << "namespace " << BAZ_NAMESPACE << " {" << std::endl;
-    this->output << R"END(// to_string code from https://medium.com/@ryan_forrester_/how-to-convert-c-boolean-to-string-b4b2b3c36d68
-    template<typename T>
-    std::string to_string(const T& value) {
-        // Normal converting element to string
-        std::ostringstream oss;
-        oss << value;
-        return oss.str();
+    this->part = DeclPart::DECLARATION;
+    for (auto &stmt : stmts) {
+        this->generate_decl(stmt.get());
     }
 
-    // Specialization for bool
-    template<>
-    std::string to_string<bool>(const bool& value) {
-        // Bool -> "true" or "false" instead of "1" and "0"
-        return value ? "true" : "false";
+    this->part = DeclPart::ALL;
+}
+
+void CppGenerator::generate_source(NodeList<Stmt> &stmts, size_t begin, size_t end, const std::string &header_name) {
+    // The header includes the runtime too, but g++ only uses the precompiled runtime when it comes first
+    this->output << "#include \"baz_runtime.h\"" << '\n'
+                 << "#include \"" << header_name << "\"" << '\n'
+                 << '\n';
+
+    this->part = DeclPart::DEFINITION;
+    for (size_t i = begin; i < end; i++) {
+        if (this->has_definitions(stmts[i].get()))
+            this->generate_decl(stmts[i].get());
     }
-})END" << std::endl
-                 << std::endl;
+
+    this->part = DeclPart::ALL;
+}
+
+bool CppGenerator::has_definitions(Stmt *stmt) {
+    if (auto s = node_cast<StructDeclStmt>(stmt))
+        return !s->methods.empty();
+
+    if (auto e = node_cast<EnumDeclStmt>(stmt))
+        return !e->methods.empty();
+
+    return true;
+}
+
+// The runtime and forward declarations of every type, which come before any declaration
+void CppGenerator::generate_preamble() {
+    // The includes and helpers every program needs are in the prebuilt runtime, so aren't compiled again each time
+    this->output << "#include \"baz_runtime.h\"" << '\n'
+                 << '\n';
 
     // Declare all struct names (including enum variants)
-    for (auto type : this->type_env) {
-        if (auto t = std::dynamic_pointer_cast<StructType>(std::get<1>(type))) {
-            this->output << "struct " << std::get<0>(type) << ";" << std::endl;
-        } else if (auto t = std::dynamic_pointer_cast<EnumType>(std::get<1>(type))) {
-            this->output << "namespace " << BAZ_NAMESPACE << " {" << std::endl;
-            for (auto variant : t->variants) {
-                this->output << "struct " << enum_variant_name(std::get<0>(type), variant.name.lexeme, false) << ";" << std::endl;
+    // Types are in order of their names' symbols, i.e. the order they first appear in the source
+    for (Symbol name = 0; name < this->type_env.size(); name++) {
+        if (auto t = type_cast<StructType>(this->type_env[name])) {
+            this->output << "struct " << t->name.lexeme << ";" << '\n';
+        } else if (auto t = type_cast<EnumType>(this->type_env[name])) {
+            this->output << "namespace " << BAZ_NAMESPACE << " {" << '\n';
+            for (auto &variant_name : t->variant_cpp_names) {
+                this->output << "struct " << variant_name << ";" << '\n';
             }
-            this->output << "}" << std::endl;
+            this->output << "}" << '\n';
         }
     }
 
     // Declare all enums
-    for (auto type : this->type_env) {
-        if (auto t = std::dynamic_pointer_cast<EnumType>(std::get<1>(type))) {
+    for (Symbol name = 0; name < this->type_env.size(); name++) {
+        if (auto t = type_cast<EnumType>(this->type_env[name])) {
             this->output << "using " << t->name.lexeme << " = std::variant<";
             for (int i = 0; i < t->variants.size(); i++) {
-                this->output << enum_variant_name(t->name.lexeme, t->variants[i].name.lexeme);
+                this->output << BAZ_NAMESPACE << "::" << t->variant_cpp_names[i];
                 if (i < t->variants.size() - 1)
                     this->output << ",";
             }
-            this->output << ">;" << std::endl;
+            this->output << ">;" << '\n';
         }
     }
-
-    for (auto &stmt : stmts) {
-        stmt->accept(*this);
-        this->output << std::endl;
-    }
 }
 
 //// Expressions
 
 void CppGenerator::visit_var_expr(VarExpr *expr) {
-    if (expr->name.lexeme == "this") {
+    if (expr->name.symbol == SYM_THIS) {
         this->output << this->this_keyword;
         return;
     }
@@ -106,28 +176,27 @@ void CppGenerator::visit_var_expr(VarExpr *expr) {
 void CppGenerator::visit_struct_init_expr(StructInitExpr *expr) {
     this->output << "(new " << expr->name.lexeme << "{";
 
-    if (auto t = std::dynamic_pointer_cast<StructType>(expr->get_type_info().type)) {
+    if (auto t = type_cast<StructType>(expr->get_type_info().type)) {
         if (expr->properties.size() != t->props.size()) {
             std::cerr << "[BUG] Incorrect number of properties. Should be checked by type checker." << std::endl;
             exit(3);
         }
 
-        // Loop through in order of declared type props
-        for (auto &prop : t->props) {
-            auto name = prop.name.lexeme;
-
-            // Find corresponding property
-            auto p = std::find_if(expr->properties.begin(), expr->properties.end(), [name](const auto &t) {
-                return std::get<0>(t).lexeme == name;
-            });
-
-            if (p != expr->properties.end()) {
-                std::get<1>(*p)->accept(*this);
-                this->output << ", ";
-            } else {
-                std::cerr << "[BUG] Not all properties initialised. This should be checked in the type checker." << std::endl;
+        // Initialisers may be written in any order, but must be given in the order the struct declares its props
+        std::vector<Expr *> initialisers(t->props.size(), nullptr);
+        for (auto &prop : expr->properties) {
+            auto index = t->prop_index(std::get<0>(prop).symbol);
+            if (!index.has_value() || initialisers[index.value()] != nullptr) {
+                std::cerr << "[BUG] Unknown or repeated property. Should be checked by type checker." << std::endl;
                 exit(3);
             }
+
+            initialisers[index.value()] = std::get<1>(prop).get();
+        }
+
+        for (auto initialiser : initialisers) {
+            dispatch(initialiser, *this);
+            this->output << ", ";
         }
     } else {
         std::cerr << "[BUG] Trying to initialise non-struct. This should be checked in the type checker" << std::endl;
@@ -142,15 +211,15 @@ void CppGenerator::visit_binary_expr(BinaryExpr *expr) {
 
     if (expr->op.t == TokenType::QUESTION_QUESTION) {
         // If `??` operator, use `a.value_or(b)`
-        expr->left->accept(*this);
+        dispatch(expr->left, *this);
         this->output << ".value_or(";
-        expr->right->accept(*this);
+        dispatch(expr->right, *this);
         this->output << ")";
     } else {
         // Otherwise use `a <op> b`
-        expr->left->accept(*this);
+        dispatch(expr->left, *this);
         this->output << " " << expr->op.lexeme << " ";
-        expr->right->accept(*this);
+        dispatch(expr->right, *this);
     }
 
     this->output << ")";
@@ -159,7 +228,7 @@ void CppGenerator::visit_binary_expr(BinaryExpr *expr) {
 void CppGenerator::visit_unary_expr(UnaryExpr *expr) {
     this->output << "(";
     this->output << expr->op.lexeme;
-    expr->right->accept(*this);
+    dispatch(expr->right, *this);
     this->output << ")";
 }
 
@@ -168,11 +237,11 @@ void CppGenerator::visit_get_expr(GetExpr *expr) {
 
     if (expr->optional) {
         this->output << "{ auto temp = ";
-        expr->object->accept(*this);
+        dispatch(expr->object, *this);
         this->output << "; temp.has_value() ? std::optional{temp.value()->" << expr->name.lexeme;
         this->output << "} : std::nullopt; }";
     } else {
-        expr->object->accept(*this);
+        dispatch(expr->object, *this);
         this->output << "->" << expr->name.lexeme;
     }
 
@@ -180,11 +249,12 @@ void CppGenerator::visit_get_expr(GetExpr *expr) {
 }
 
 void CppGenerator::visit_enum_init_expr(EnumInitExpr *expr) {
-    if (VarExpr *enum_name = dynamic_cast<VarExpr *>(expr->enum_namespace.get())) {
-        this->output << "(new " << enum_name->name.lexeme << "(" << enum_variant_name(enum_name->name.lexeme, expr->variant.lexeme) << "{";
+    auto t = type_cast<EnumType>(expr->get_type_info().type);
+    if (VarExpr *enum_name = node_cast<VarExpr>(expr->enum_namespace.get()); enum_name && t) {
+        this->output << "(new " << enum_name->name.lexeme << "(" << BAZ_NAMESPACE << "::" << enum_variant_name(t, expr->variant.symbol) << "{";
 
         if (expr->payload.has_value())
-            expr->payload.value()->accept(*this);
+            dispatch(expr->payload.value(), *this);
 
         this->output << "}))";
     } else {
@@ -195,25 +265,25 @@ void CppGenerator::visit_enum_init_expr(EnumInitExpr *expr) {
 
 void CppGenerator::visit_call_expr(CallExpr *expr) {
     // If we are doing x.y()
-    if (auto *get_expr = dynamic_cast<GetExpr *>(expr->callee.get())) {
+    if (auto *get_expr = node_cast<GetExpr>(expr->callee.get())) {
         // And x is an enum type
-        if (auto t = std::dynamic_pointer_cast<EnumType>(get_expr->object->get_type_info().type)) {
+        if (auto t = type_cast<EnumType>(get_expr->object->get_type_info().type)) {
             this->output << "(";
 
             if (get_expr->optional) {
                 // If calling a function that returns void, handle differently - no return value
-                if (auto fun_t = std::dynamic_pointer_cast<FunctionType>(get_expr->get_type_info().type)) {
-                    if (fun_t->return_type.lexeme == "void") {
+                if (auto fun_t = type_cast<FunctionType>(get_expr->get_type_info().type)) {
+                    if (fun_t->return_type == this->type_env[SYM_VOID]) {
                         this->output << "{ auto temp = ";
-                        get_expr->object->accept(*this);
+                        dispatch(get_expr->object, *this);
                         this->output << "; if (temp.has_value()) { ";
 
                         // Use namespaced enum method
-                        this->output << enum_method_name(t->name.lexeme, get_expr->name.lexeme) << "(temp.value()";
+                        this->output << BAZ_NAMESPACE << "::" << enum_method_name(t, get_expr->name.symbol) << "(temp.value()";
 
                         for (auto &arg : expr->args) {
                             this->output << ", ";
-                            arg->accept(*this);
+                            dispatch(arg, *this);
                         }
 
                         this->output << "); }})";
@@ -222,15 +292,15 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
                 }
 
                 this->output << "{ auto temp = ";
-                get_expr->object->accept(*this);
+                dispatch(get_expr->object, *this);
                 this->output << "; temp.has_value() ? std::optional{";
 
                 // Use namespaced enum method
-                this->output << enum_method_name(t->name.lexeme, get_expr->name.lexeme) << "(temp.value()";
+                this->output << BAZ_NAMESPACE << "::" << enum_method_name(t, get_expr->name.symbol) << "(temp.value()";
 
                 for (auto &arg : expr->args) {
                     this->output << ", ";
-                    arg->accept(*this);
+                    dispatch(arg, *this);
                 }
 
                 this->output << ")} : std::nullopt; })";
@@ -238,22 +308,22 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
             }
 
             // Use namespaced enum method
-            this->output << enum_method_name(t->name.lexeme, get_expr->name.lexeme) << "(";
-            get_expr->object->accept(*this);
+            this->output << BAZ_NAMESPACE << "::" << enum_method_name(t, get_expr->name.symbol) << "(";
+            dispatch(get_expr->object, *this);
 
             for (auto &arg : expr->args) {
                 this->output << ", ";
-                arg->accept(*this);
+                dispatch(arg, *this);
             }
 
             this->output << "))";
             return;
-        } else if (auto t = std::dynamic_pointer_cast<StructType>(get_expr->object->get_type_info().type) && get_expr->get_type_info().optional) {
+        } else if (auto t = type_cast<StructType>(get_expr->object->get_type_info().type) && get_expr->get_type_info().optional) {
             this->output << "(";
-            if (auto fun_t = std::dynamic_pointer_cast<FunctionType>(get_expr->get_type_info().type)) {
-                if (fun_t->return_type.lexeme == "void") {
+            if (auto fun_t = type_cast<FunctionType>(get_expr->get_type_info().type)) {
+                if (fun_t->return_type == this->type_env[SYM_VOID]) {
                     this->output << "{ auto temp = ";
-                    get_expr->object->accept(*this);
+                    dispatch(get_expr->object, *this);
                     this->output << "; if (temp.has_value()) { temp.value()->" << get_expr->name.lexeme << "(";
 
                     bool first = true;
@@ -261,7 +331,7 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
                         if (!first)
                             this->output << ", ";
 
-                        arg->accept(*this);
+                        dispatch(arg, *this);
                         first = false;
                     }
 
@@ -271,7 +341,7 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
             }
 
             this->output << "{ auto temp = ";
-            get_expr->object->accept(*this);
+            dispatch(get_expr->object, *this);
             this->output << "; temp.has_value() ? std::optional{temp.value()->" << get_expr->name.lexeme << "(";
 
             bool first = true;
@@ -279,7 +349,7 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
                 if (!first)
                     this->output << ", ";
 
-                arg->accept(*this);
+                dispatch(arg, *this);
                 first = false;
             }
 
@@ -289,7 +359,7 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
     }
 
     this->output << "(";
-    expr->callee->accept(*this);
+    dispatch(expr->callee, *this);
     this->output << "(";
 
     bool first = true;
@@ -297,7 +367,7 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
         if (!first)
             this->output << ", ";
 
-        arg->accept(*this);
+        dispatch(arg, *this);
         first = false;
     }
 
@@ -306,7 +376,7 @@ void CppGenerator::visit_call_expr(CallExpr *expr) {
 
 void CppGenerator::visit_grouping_expr(GroupingExpr *expr) {
     this->output << "(";
-    expr->expr->accept(*this);
+    dispatch(expr->expr, *this);
     this->output << ")";
 }
 
@@ -326,14 +396,18 @@ void CppGenerator::visit_literal_expr(LiteralExpr *expr) {
 
 //// Statements
 
-void CppGenerator::visit_fun_decl_stmt(FunDeclStmt *stmt) {
+void CppGenerator::function_signature(FunDeclStmt *stmt) {
     std::string return_type = baz_to_cpp_type(stmt->return_type, stmt->return_type_optional);
 
     // Convert main to use "int" instead of "void" for main
-    if (stmt->fun_type == FunType::FUNCTION && stmt->name.lexeme == "main")
+    if (stmt->fun_type == FunType::FUNCTION && stmt->name.symbol == SYM_MAIN)
         return_type = "int";
 
-    this->output << return_type << " " << stmt->name.lexeme << "(";
+    this->output << return_type << " ";
+    if (!this->method_owner.empty())
+        this->output << this->method_owner << "::";
+
+    this->output << stmt->name.lexeme << "(";
 
     bool first = true;
     for (auto &param : stmt->params) {
@@ -344,113 +418,166 @@ void CppGenerator::visit_fun_decl_stmt(FunDeclStmt *stmt) {
         first = false;
     }
 
-    this->output << ") {" << std::endl;
+    this->output << ")";
+}
+
+void CppGenerator::visit_fun_decl_stmt(FunDeclStmt *stmt) {
+    this->function_signature(stmt);
+
+    if (this->part == DeclPart::DECLARATION) {
+        this->output << ";" << '\n';
+        return;
+    }
+
+    this->output << " {" << '\n';
 
-    for (auto &line : stmt->body) {
-        line->accept(*this);
+    for (auto &line : stmt->get_body()) {
+        dispatch(line, *this);
     }
 
-    this->output << "}" << std::endl;
+    this->output << "}" << '\n';
 }
 
 void CppGenerator::visit_enum_method_decl_stmt(EnumMethodDeclStmt *enum_stmt) {
     auto &stmt = enum_stmt->fun_definition;
-    this->output << "namespace " << BAZ_NAMESPACE << " {" << std::endl;
-    this->output << baz_to_cpp_type(stmt->return_type, stmt->return_type_optional) << " " << enum_method_name(enum_stmt->enum_name.lexeme, stmt->name.lexeme, false) << "(" << enum_stmt->enum_name.lexeme << " *baz_this";
+    auto t = type_cast<EnumType>(this->type_env[enum_stmt->enum_name.symbol]);
+    if (!t) {
+        std::cerr << "[BUG] Enum method on non-enum." << std::endl;
+        exit(3);
+    }
+
+    this->output << "namespace " << BAZ_NAMESPACE << " {" << '\n';
+    this->output << baz_to_cpp_type(stmt->return_type, stmt->return_type_optional) << " " << enum_method_name(t, stmt->name.symbol) << "(" << enum_stmt->enum_name.lexeme << " *baz_this";
 
     for (auto &param : stmt->params) {
         this->output << ", " << baz_to_cpp_type(param.type, param.is_optional) << " " << param.name.lexeme;
     }
 
-    this->output << ") {" << std::endl;
+    this->output << ")";
+
+    if (this->part == DeclPart::DECLARATION) {
+        this->output << ";" << '\n';
+        this->output << "}" << '\n';
+        return;
+    }
+
+    this->output << " {" << '\n';
 
-    for (auto &line : stmt->body) {
+    for (auto &line : stmt->get_body()) {
         // Use "baz_this" instead of "this" as we are just using normal functions, not methods
         auto prev_this_keyword = this->this_keyword;
         this->this_keyword = "baz_this";
 
-        line->accept(*this);
+        dispatch(line, *this);
 
         this->this_keyword = prev_this_keyword;
     }
 
-    this->output << "}" << std::endl;
-    this->output << "}" << std::endl;
+    this->output << "}" << '\n';
+    this->output << "}" << '\n';
 }
 
 void CppGenerator::visit_struct_decl_stmt(StructDeclStmt *stmt) {
-    this->output << "struct " << stmt->name.lexeme << " {" << std::endl;
+    // Methods are defined outside of the struct, which is declared in the header
+    if (this->part == DeclPart::DEFINITION) {
+        this->method_owner = stmt->name.lexeme;
+        for (size_t i = 0; i < stmt->methods.size(); i++) {
+            if (i > 0)
+                this->output << '\n';
+
+            dispatch(stmt->methods[i], *this);
+        }
+
+        this->method_owner = "";
+        return;
+    }
+
+    this->output << "struct " << stmt->name.lexeme << " {" << '\n';
 
-    this->output << "public:" << std::endl;
+    this->output << "public:" << '\n';
     for (auto &prop : stmt->properties) {
-        this->output << baz_to_cpp_type(prop.type, prop.is_optional) << " " << prop.name.lexeme << ";" << std::endl;
+        this->output << baz_to_cpp_type(prop.type, prop.is_optional) << " " << prop.name.lexeme << ";" << '\n';
     }
 
     for (auto &method : stmt->methods) {
-        this->output << std::endl;
-        method->accept(*this);
+        this->output << '\n';
+        dispatch(method, *this);
     }
 
-    this->output << "};" << std::endl;
+    this->output << "};" << '\n';
 }
 
 void CppGenerator::visit_enum_decl_stmt(EnumDeclStmt *stmt) {
+    auto t = type_cast<EnumType>(this->type_env[stmt->name.symbol]);
+    if (!t) {
+        std::cerr << "[BUG] Enum does not have enum type." << std::endl;
+        exit(3);
+    }
+
+    // Only the methods have bodies, and the variants are declared in the header
+    bool definitions_only = this->part == DeclPart::DEFINITION;
+
     for (auto &variant : stmt->variants) {
-        this->output << "namespace " << BAZ_NAMESPACE << " {" << std::endl;
-        this->output << "struct " << enum_variant_name(stmt->name.lexeme, variant.name.lexeme, false) << "{ ";
+        if (definitions_only)
+            break;
+
+        this->output << "namespace " << BAZ_NAMESPACE << " {" << '\n';
+        this->output << "struct " << enum_variant_name(t, variant.name.symbol) << "{ ";
         if (variant.payload_type.has_value())
             this->output << baz_to_cpp_type(variant.payload_type.value(), variant.is_optional) << " value; ";
 
-        this->output << "};" << std::endl;
-        this->output << "}" << std::endl;
+        this->output << "};" << '\n';
+        this->output << "}" << '\n';
     }
 
-    for (auto &method : stmt->methods) {
-        this->output << std::endl;
-        method->accept(*this);
+    for (size_t i = 0; i < stmt->methods.size(); i++) {
+        if (i > 0 || !definitions_only)
+            this->output << '\n';
+
+        dispatch(stmt->methods[i], *this);
     }
 }
 
 void CppGenerator::visit_variable_decl_stmt(VariableDeclStmt *stmt) {
     // Pointer if user defined type
     this->output << baz_to_cpp_type(stmt->name.type, stmt->name.is_optional) << " " << stmt->name.name.lexeme << " = ";
-    stmt->initialiser->accept(*this);
-    this->output << ";" << std::endl;
+    dispatch(stmt->initialiser, *this);
+    this->output << ";" << '\n';
 }
 
 void CppGenerator::visit_expr_stmt(ExprStmt *stmt) {
-    stmt->expr->accept(*this);
-    this->output << ";" << std::endl;
+    dispatch(stmt->expr, *this);
+    this->output << ";" << '\n';
 }
 
 void CppGenerator::visit_block_stmt(BlockStmt *stmt) {
-    this->output << "{" << std::endl;
+    this->output << "{" << '\n';
 
     for (auto &line : stmt->stmts) {
-        line->accept(*this);
+        dispatch(line, *this);
     }
 
-    this->output << "}" << std::endl;
+    this->output << "}" << '\n';
 }
 
 void CppGenerator::visit_if_stmt(IfStmt *stmt) {
     this->output << "if (";
-    stmt->condition->accept(*this);
-    this->output << ") {" << std::endl;
+    dispatch(stmt->condition, *this);
+    this->output << ") {" << '\n';
 
     for (auto &line : stmt->true_block) {
-        line->accept(*this);
+        dispatch(line, *this);
     }
 
     this->output << "}";
 
     if (stmt->false_block.has_value()) {
-        this->output << " else {" << std::endl;
+        this->output << " else {" << '\n';
         for (auto &line : stmt->false_block.value()) {
-            line->accept(*this);
+            dispatch(line, *this);
         }
 
-        this->output << "}" << std::endl;
+        this->output << "}" << '\n';
     }
 }
 
@@ -458,8 +585,8 @@ void CppGenerator::visit_match_stmt(MatchStmt *stmt) {
     // TODO: make sure this is a unique name within the scope
     std::string target_var("baz_enum_target");
     this->output << "auto " << target_var << " = ";
-    stmt->target->accept(*this);
-    this->output << ";" << std::endl;
+    dispatch(stmt->target, *this);
+    this->output << ";" << '\n';
 
     bool first = true;
     auto optional_getter = "";
@@ -467,7 +594,7 @@ void CppGenerator::visit_match_stmt(MatchStmt *stmt) {
     // Do null branch first
     if (stmt->target->get_type_info().optional) {
         first = false;
-        this->output << "if (!" << target_var << ".has_value()) {" << std::endl;
+        this->output << "if (!" << target_var << ".has_value()) {" << '\n';
         optional_getter = ".value()";
 
         auto branch = std::find_if(stmt->branches.begin(), stmt->branches.end(), [](const auto &b) {
@@ -480,7 +607,7 @@ void CppGenerator::visit_match_stmt(MatchStmt *stmt) {
         }
 
         for (auto &stmt : branch->body) {
-            stmt->accept(*this);
+            dispatch(stmt, *this);
         }
 
         this->output << "}";
@@ -491,11 +618,17 @@ void CppGenerator::visit_match_stmt(MatchStmt *stmt) {
         auto if_keyword = first ? "if" : "else if";
         if (std::holds_alternative<EnumPattern>(branch.pattern)) {
             auto &enum_pattern = std::get<EnumPattern>(branch.pattern);
-            auto pattern_variant = enum_variant_name(enum_pattern.enum_type.lexeme, enum_pattern.enum_variant.lexeme);
-            this->output << if_keyword << "(std::holds_alternative<" << pattern_variant << ">(*" << target_var << optional_getter << ")) {" << std::endl;
+            auto t = type_cast<EnumType>(stmt->target->get_type_info().type);
+            if (!t) {
+                std::cerr << "[BUG] Enum pattern on non-enum target. This should be checked in the type checker." << std::endl;
+                exit(3);
+            }
+
+            auto pattern_variant = BAZ_NAMESPACE + "::" + enum_variant_name(t, enum_pattern.enum_variant.symbol);
+            this->output << if_keyword << "(std::holds_alternative<" << pattern_variant << ">(*" << target_var << optional_getter << ")) {" << '\n';
 
             if (enum_pattern.bound_variable.has_value()) {
-                this->output << "auto " << enum_pattern.bound_variable.value()->name.lexeme << " = std::get<" << pattern_variant << ">(*" << target_var << optional_getter << ").value;" << std::endl;
+                this->output << "auto " << enum_pattern.bound_variable.value()->name.lexeme << " = std::get<" << pattern_variant << ">(*" << target_var << optional_getter << ").value;" << '\n';
             }
         } else if (std::holds_alternative<NullPattern>(branch.pattern)) {
             // Already handled
@@ -506,10 +639,10 @@ void CppGenerator::visit_match_stmt(MatchStmt *stmt) {
         }
 
         for (auto &stmt : branch.body) {
-            stmt->accept(*this);
+            dispatch(stmt, *this);
         }
 
-        this->output << "}" << std::endl;
+        this->output << "}" << '\n';
         first = false;
     }
 
@@ -519,42 +652,42 @@ void CppGenerator::visit_match_stmt(MatchStmt *stmt) {
     });
     if (catch_all_branch != stmt->branches.end()) {
         auto &catch_all_pattern = std::get<CatchAllPattern>(catch_all_branch->pattern);
-        this->output << "else {" << std::endl;
-        this->output << "auto " << catch_all_pattern.bound_variable->name.lexeme << " = " << target_var << ".value();" << std::endl;
+        this->output << "else {" << '\n';
+        this->output << "auto " << catch_all_pattern.bound_variable->name.lexeme << " = " << target_var << ".value();" << '\n';
         for (auto &stmt : catch_all_branch->body) {
-            stmt->accept(*this);
+            dispatch(stmt, *this);
         }
 
-        this->output << "}" << std::endl;
+        this->output << "}" << '\n';
     }
 }
 
 void CppGenerator::visit_while_stmt(WhileStmt *stmt) {
     this->output << "while (";
-    stmt->condition->accept(*this);
-    this->output << ") {" << std::endl;
+    dispatch(stmt->condition, *this);
+    this->output << ") {" << '\n';
 
     for (auto &line : stmt->stmts) {
-        line->accept(*this);
+        dispatch(line, *this);
     }
 
-    this->output << "}" << std::endl;
+    this->output << "}" << '\n';
 }
 
 void CppGenerator::visit_for_stmt(ForStmt *stmt) {
     this->output << "for (";
 
-    stmt->var->accept(*this);
-    stmt->condition->accept(*this);
-    stmt->increment->accept(*this);
+    dispatch(stmt->var, *this);
+    dispatch(stmt->condition, *this);
+    dispatch(stmt->increment, *this);
 
-    this->output << ") {" << std::endl;
+    this->output << ") {" << '\n';
 
     for (auto &line : stmt->stmts) {
-        line->accept(*this);
+        dispatch(line, *this);
     }
 
-    this->output << "}" << std::endl;
+    this->output << "}" << '\n';
 }
 
 void CppGenerator::visit_print_stmt(PrintStmt *stmt) {
@@ -565,11 +698,11 @@ void CppGenerator::visit_print_stmt(PrintStmt *stmt) {
 
         if (stmt->expr.value()->get_type_info().optional) {
             this->output << "({ auto temp = ";
-            stmt->expr.value()->accept(*this);
+            dispatch(stmt->expr.value(), *this);
             this->output << "; temp.has_value() ? " << BAZ_NAMESPACE << "::to_string(temp.value()) : \"null\"; })";
         } else {
             this->output << BAZ_NAMESPACE << "::to_string(";
-            stmt->expr.value()->accept(*this);
+            dispatch(stmt->expr.value(), *this);
             this->output << ")";
         }
     }
@@ -577,7 +710,7 @@ void CppGenerator::visit_print_stmt(PrintStmt *stmt) {
     if (stmt->newline)
         this->output << " << std::endl";
 
-    this->output << ";" << std::endl;
+    this->output << ";" << '\n';
 }
 
 void CppGenerator::visit_panic_stmt(PanicStmt *stmt) {
@@ -588,46 +721,46 @@ void CppGenerator::visit_panic_stmt(PanicStmt *stmt) {
 
         if (stmt->expr.value()->get_type_info().optional) {
             this->output << "({ auto temp = ";
-            stmt->expr.value()->accept(*this);
+            dispatch(stmt->expr.value(), *this);
             this->output << "; temp.has_value() ? " << BAZ_NAMESPACE << "::to_string(temp.value()) : \"null\"; })";
         } else {
             this->output << BAZ_NAMESPACE << "::to_string(";
-            stmt->expr.value()->accept(*this);
+            dispatch(stmt->expr.value(), *this);
             this->output << ")";
         }
     }
 
-    this->output << " << std::endl;" << std::endl;
-    this->output << "exit(1);" << std::endl;
+    this->output << " << std::endl;" << '\n';
+    this->output << "exit(1);" << '\n';
 }
 
 void CppGenerator::visit_return_stmt(ReturnStmt *stmt) {
     this->output << "return ";
 
     if (stmt->expr.has_value())
-        stmt->expr.value()->accept(*this);
+        dispatch(stmt->expr.value(), *this);
 
-    this->output << ";" << std::endl;
+    this->output << ";" << '\n';
 }
 
 void CppGenerator::visit_assign_stmt(AssignStmt *stmt) {
-    if (stmt->name.lexeme == "this") {
+    if (stmt->name.symbol == SYM_THIS) {
         // If we're reassigning "this", need to dereference
         this->output << "*" << this->this_keyword << " = *";
     } else {
         this->output << stmt->name.lexeme << " = ";
     }
 
-    stmt->value->accept(*this);
+    dispatch(stmt->value, *this);
 
     if (stmt->semicolon)
-        this->output << ";" << std::endl;
+        this->output << ";" << '\n';
 }
 
 void CppGenerator::visit_set_stmt(SetStmt *stmt) {
-    stmt->object->accept(*this);
+    dispatch(stmt->object, *this);
     this->output << "->" << stmt->name.lexeme << " = ";
 
-    stmt->value->accept(*this);
-    this->output << ";" << std::endl;
+    dispatch(stmt->value, *this);
+    this->output << ";" << '\n';
 }
@@ -2,19 +2,59 @@
 
 #include "../ast/expr_visitor.h"
 #include "../ast/stmt_visitor.h"
+#include "../util/thread_pool.h"
+#include "output_sink.h"
 
-#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
 
-class CppGenerator : public ExprVisitor, public StmtVisitor {
+// Which part of each top level declaration is generated
+enum class DeclPart {
+    // Everything, for a single file of output
+    ALL,
+
+    // Types and function prototypes, for a header shared between several files
+    DECLARATION,
+
+    // Function and method bodies, which include the header for everything else
+    DEFINITION,
+};
+
+class CppGenerator final : public ExprVisitor, public StmtVisitor {
   private:
-    std::ostream &output;
+    // Writes into the sink given to the generator
+    std::ostream output;
     std::string this_keyword;
-    std::map<std::string, std::shared_ptr<Type>> type_env;
+    const TypeTable &type_env;
+
+    DeclPart part;
+
+    // Struct the method being generated belongs to, when it is defined outside of the struct
+    std::string_view method_owner;
+
+    // Return type, name and parameters of a function
+    void function_signature(FunDeclStmt *stmt);
+
+    // Whether a declaration has any bodies, so has anything to generate as a `DeclPart::DEFINITION`
+    bool has_definitions(Stmt *stmt);
 
   public:
-    CppGenerator(std::ostream &file, std::map<std::string, std::shared_ptr<Type>> type_env);
+    CppGenerator(OutputSink &sink, const TypeTable &type_env);
+
+    void generate(NodeList<Stmt> &stmts);
+    void generate(NodeList<Stmt> &stmts, ThreadPool &pool);
+
+    // The pieces of `generate`, for generating declarations separately
+    void generate_preamble();
+    void generate_decl(Stmt *stmt);
+
+    // Split the output between a header, and source files that can be compiled separately:
+    // The header has the preamble, every type, and a prototype for every function and method
+    void generate_header(NodeList<Stmt> &stmts);
 
-    void generate(std::vector<std::unique_ptr<Stmt>> &stmts);
+    // The bodies of the declarations in `[begin, end)`, after including `header_name`
+    void generate_source(NodeList<Stmt> &stmts, size_t begin, size_t end, const std::string &header_name);
 
     void visit_var_expr(VarExpr *expr);
     void visit_struct_init_expr(StructInitExpr *expr);
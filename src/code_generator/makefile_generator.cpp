@@ -0,0 +1,35 @@
+#include "makefile_generator.h"
+#include "runtime.h"
+
+#include <ostream>
+
+void generate_makefile(OutputSink &sink, const std::string &header, const std::vector<std::string> &sources, const std::string &binary) {
+    std::ostream output(&sink);
+
+    output << "# Generated by baz - build with `make -j`" << '\n'
+           << "CXXFLAGS ?= " << RUNTIME_FLAGS << '\n'
+           << "CPPFLAGS += -I" << RUNTIME_DIR << '\n'
+           << "LDFLAGS += -L" << RUNTIME_DIR << '\n'
+           << "LDLIBS += -lbazrt" << '\n'
+           << '\n';
+
+    output << "OBJECTS =";
+    for (auto &source : sources) {
+        output << " " << source.substr(0, source.rfind('.')) << ".o";
+    }
+    output << '\n'
+           << '\n';
+
+    output << binary << ": $(OBJECTS)" << '\n'
+           << "\t$(CXX) $(CXXFLAGS) $(LDFLAGS) $(OBJECTS) $(LDLIBS) -o " << binary << '\n'
+           << '\n';
+
+    output << "%.o: %.cpp " << header << '\n'
+           << "\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -c $< -o $@" << '\n'
+           << '\n';
+
+    output << "clean:" << '\n'
+           << "\trm -f " << binary << " $(OBJECTS)" << '\n'
+           << '\n'
+           << ".PHONY: clean" << '\n';
+}
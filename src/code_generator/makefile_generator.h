@@ -0,0 +1,10 @@
+#pragma once
+
+#include "output_sink.h"
+
+#include <string>
+#include <vector>
+
+// Makefile that compiles each of `sources` on its own, so `make -j` builds them in parallel, then links them into `binary`
+// Every source is rebuilt when `header` changes, and all of them are built against the runtime
+void generate_makefile(OutputSink &sink, const std::string &header, const std::vector<std::string> &sources, const std::string &binary);
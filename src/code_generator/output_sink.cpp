@@ -0,0 +1,103 @@
+#include "output_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <ostream>
+#include <unistd.h>
+
+// Smallest buffer a `MemorySink` starts with, once anything is written to it
+const size_t MIN_MEMORY_SINK_SIZE = 4096;
+
+int OutputSink::sync() {
+    return 0;
+}
+
+FileSink::FileSink(const std::string &path) : FileSink(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+    this->owns_fd = true;
+}
+
+FileSink::FileSink(int fd) : fd(fd), owns_fd(false), block(new char[BLOCK_SIZE]) {
+    this->setp(this->block.get(), this->block.get() + BLOCK_SIZE);
+}
+
+FileSink::~FileSink() {
+    if (!this->is_open())
+        return;
+
+    this->flush();
+    if (this->owns_fd)
+        close(this->fd);
+}
+
+bool FileSink::is_open() const {
+    return this->fd >= 0;
+}
+
+void FileSink::flush() {
+    this->write_block();
+}
+
+void FileSink::write_block() {
+    const char *data = this->pbase();
+    size_t remaining = this->pptr() - this->pbase();
+
+    while (remaining > 0) {
+        ssize_t n = write(this->fd, data, remaining);
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0) {
+            std::cerr << "Failed to write output: " << std::strerror(errno) << std::endl;
+            exit(1);
+        }
+
+        data += n;
+        remaining -= n;
+    }
+
+    this->setp(this->block.get(), this->block.get() + BLOCK_SIZE);
+}
+
+// The block is full - write it out and start again from the beginning
+int FileSink::overflow(int c) {
+    this->write_block();
+
+    if (c != traits_type::eof())
+        this->sputc(traits_type::to_char_type(c));
+
+    return traits_type::not_eof(c);
+}
+
+StdoutSink::StdoutSink() : FileSink(STDOUT_FILENO) {}
+
+MemorySink::MemorySink() {}
+
+void MemorySink::flush() {}
+
+std::string_view MemorySink::view() const {
+    return std::string_view(this->pbase(), this->pptr() - this->pbase());
+}
+
+// Out of space - double the buffer, keeping what has been written so far
+int MemorySink::overflow(int c) {
+    size_t written = this->pptr() - this->pbase();
+
+    this->buffer.resize(std::max(this->buffer.size() * 2, MIN_MEMORY_SINK_SIZE));
+    this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
+
+    // `pbump` only takes an int, so more than 2 GiB has to be skipped over in steps
+    while (written > 0) {
+        int step = std::min<size_t>(written, INT_MAX);
+        this->pbump(step);
+        written -= step;
+    }
+
+    if (c != traits_type::eof())
+        this->sputc(traits_type::to_char_type(c));
+
+    return traits_type::not_eof(c);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+// Where generated C++ is written to, used as the buffer behind the generator's `std::ostream`
+//
+// Output is only written out when a large block fills up, or when the sink is flushed. Flushing the stream
+// (e.g. with `std::endl`) does nothing, so lines don't each cost a write
+class OutputSink : public std::streambuf {
+  protected:
+    int sync() override;
+
+  public:
+    // Write out everything buffered so far
+    virtual void flush() = 0;
+};
+
+// Writes to a file descriptor in blocks of `BLOCK_SIZE`, so most outputs are written with a single write
+class FileSink : public OutputSink {
+  private:
+    int fd;
+
+    // Whether `fd` was opened by the sink, so must be closed by it
+    bool owns_fd;
+
+    std::unique_ptr<char[]> block;
+
+    // Write the whole of the block's contents, exiting if that isn't possible
+    void write_block();
+
+  protected:
+    int overflow(int c) override;
+
+  public:
+    static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+
+    // Creates or truncates the file at `path`. Check `is_open` before writing to it
+    FileSink(const std::string &path);
+
+    // Writes to an already open file descriptor, which is left open
+    FileSink(int fd);
+
+    FileSink(const FileSink &) = delete;
+    FileSink &operator=(const FileSink &) = delete;
+
+    // Flushes anything left, and closes the file if the sink opened it
+    ~FileSink();
+
+    bool is_open() const;
+    void flush() override;
+};
+
+class StdoutSink final : public FileSink {
+  public:
+    StdoutSink();
+};
+
+// Keeps the output in memory, growing its buffer as needed
+class MemorySink final : public OutputSink {
+  private:
+    std::string buffer;
+
+  protected:
+    int overflow(int c) override;
+
+  public:
+    MemorySink();
+
+    // Nothing to write out, as the output is already where it is going
+    void flush() override;
+
+    // Everything written so far, until more is written
+    std::string_view view() const;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+// Set by the build to where it puts the runtime, and the flags it precompiles the runtime header with
+#ifndef BAZ_RUNTIME_DIR
+#define BAZ_RUNTIME_DIR "runtime"
+#endif
+
+#ifndef BAZ_RUNTIME_FLAGS
+#define BAZ_RUNTIME_FLAGS "-std=c++17 -O2"
+#endif
+
+// Holds "baz_runtime.h" (and its precompiled header) which generated C++ includes, and "libbazrt.a" it must link against
+inline const std::string RUNTIME_DIR = BAZ_RUNTIME_DIR;
+
+// Programs must be compiled with exactly these flags for g++ to use the precompiled header
+inline const std::string RUNTIME_FLAGS = BAZ_RUNTIME_FLAGS;
@@ -0,0 +1,58 @@
+#include "diagnostic.h"
+#include "../type_checker/type.h"
+
+#include <array>
+
+// Message for each diagnostic code, indexed by the code
+static constexpr std::array MESSAGES = {
+#define X(code, message) std::string_view(message),
+    DIAGNOSTIC_CODES(X)
+#undef X
+};
+
+static constexpr std::array<std::string_view, 3> STAGE_NAMES = {"Syntax", "Resolving", "Type"};
+
+Diagnostic::Diagnostic(DiagnosticStage stage, DiagnosticCode code, Token token, std::initializer_list<DiagnosticArg> args)
+    : stage(stage), code(code), token(token), args(args) {}
+
+// Write a single argument into the message
+static void format_arg(std::string &out, const DiagnosticArg &arg) {
+    if (auto number = std::get_if<size_t>(&arg)) {
+        out += std::to_string(*number);
+    } else if (auto text = std::get_if<std::string_view>(&arg)) {
+        out += *text;
+    } else if (auto type = std::get_if<TypeArg>(&arg)) {
+        out += type->type->to_string();
+        if (type->optional)
+            out += "?";
+    }
+}
+
+std::string Diagnostic::message() const {
+    std::string_view format = MESSAGES[static_cast<size_t>(this->code)];
+
+    std::string message;
+    for (size_t i = 0; i < format.length(); i++) {
+        // `%n` is replaced by the nth argument
+        if (format[i] == '%' && i + 1 < format.length() && format[i + 1] >= '0' && format[i + 1] <= '9') {
+            size_t index = format[i + 1] - '0';
+            if (index < this->args.size())
+                format_arg(message, this->args[index]);
+
+            i++;
+            continue;
+        }
+
+        message += format[i];
+    }
+
+    return message;
+}
+
+void report(std::ostream &out, const Diagnostic &diagnostic) {
+    std::string where = "end";
+    if (diagnostic.token.t != TokenType::EOF_)
+        where = "'" + std::string(diagnostic.token.lexeme) + "'";
+
+    out << "[line " << diagnostic.token.line << "] " << STAGE_NAMES[static_cast<size_t>(diagnostic.stage)] << " error at " << where << ": " << diagnostic.message() << std::endl;
+}
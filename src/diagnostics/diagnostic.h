@@ -0,0 +1,165 @@
+#pragma once
+
+#include "../scanner/token.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+struct Type;
+
+// Every error the parser, resolver and type checker can report, with its message
+// `%0`, `%1`, etc. in a message are replaced by the diagnostic's arguments
+#define DIAGNOSTIC_CODES(X) \
+    /* Syntax errors */                                                                                         \
+    X(UNEXPECTED_TOP_LEVEL_STATEMENT, "Unexpected statement at top level.")                                     \
+    X(EXPECTED_SEMI_COLON_AFTER_ASSIGNMENT, "Expected ';' after assignment.")                                   \
+    X(EXPECTED_SEMI_COLON_AFTER_EXPRESSION, "Expected ';' after expression.")                                   \
+    X(EXPECTED_L_BRACKET_AFTER_IF, "Expected '(' after 'if'.")                                                  \
+    X(EXPECTED_CLOSING_R_BRACKET_AFTER_IF_CONDITION, "Expected closing ')' after if condition.")                \
+    X(EXPECTED_L_CURLY_BEFORE_IF_BRANCH, "Expected '{' before if branch.")                                      \
+    X(EXPECTED_L_CURLY_BEFORE_ELSE_BRANCH, "Expected '{' before else branch.")                                  \
+    X(EXPECTED_L_BRACKET_AFTER_MATCH, "Expected '(' after 'match'.")                                            \
+    X(EXPECTED_CLOSING_R_BRACKET_AFTER_MATCH_TARGET, "Expected closing ')' after match target.")                \
+    X(EXPECTED_L_CURLY_BEFORE_MATCH_BODY, "Expected '{' before match body.")                                    \
+    X(EXPECTED_COLON_AFTER_MATCH_PATTERN, "Expected ':' after match pattern.")                                  \
+    X(EXPECTED_BLOCK_AFTER_MATCH_PATTERN, "Expected block after match pattern.")                                \
+    X(EXPECTED_R_CURLY_AFTER_MATCH_BRANCHES, "Expected '}' after match branches")                               \
+    X(EXPECTED_IDENTIFIER, "Expected identifier.")                                                              \
+    X(EXPECTED_VARIANT, "Expected variant.")                                                                    \
+    X(EXPECTED_VARIABLE_TO_BIND_TO, "Expected variable to bind to.")                                            \
+    X(EXPECTED_R_BRACKET_AFTER_ENUM_PAYLOAD, "Expected ')' after enum payload.")                                \
+    X(EXPECTED_L_BRACKET_AFTER_FOR, "Expected '(' after 'for'.")                                                \
+    X(EXPECTED_VARIABLE_DECLARATION, "Expected variable declaration.")                                          \
+    X(EXPECTED_EQUAL_AFTER_ASSIGNMENT_TARGET, "Expected '=' after assignment target.")                          \
+    X(ASSIGN_STATEMENT_NOT_VALID, "Assign statement not valid.")                                                \
+    X(EXPECTED_CLOSING_R_BRACKET_AFTER_FOR_CONDITION, "Expected closing ')' after for condition.")              \
+    X(EXPECTED_L_CURLY_BEFORE_LOOP_BODY, "Expected '{' before loop body.")                                      \
+    X(EXPECTED_L_BRACKET_AFTER_WHILE, "Expected '(' after 'while'.")                                            \
+    X(EXPECTED_CLOSING_R_BRACKET_AFTER_WHILE_CONDITION, "Expected closing ')' after while condition.")          \
+    X(EXPECTED_L_BRACKET_AFTER_PRINT, "Expected '(' after 'print'.")                                            \
+    X(EXPECTED_SEMI_COLON_AFTER_PRINT_STATEMENT, "Expected ';' after print statement.")                         \
+    X(EXPECTED_CLOSING_R_BRACKET_AFTER_PRINT_VALUE, "Expected closing ')' after print value.")                  \
+    X(EXPECTED_L_BRACKET_AFTER_PANIC, "Expected '(' after 'panic'.")                                            \
+    X(EXPECTED_SEMI_COLON_AFTER_PANIC_STATEMENT, "Expected ';' after panic statement.")                         \
+    X(EXPECTED_CLOSING_R_BRACKET_AFTER_PANIC_VALUE, "Expected closing ')' after panic value.")                  \
+    X(EXPECTED_SEMI_COLON_AFTER_RETURN_STATEMENT, "Expected ';' after return statement.")                       \
+    X(INVALID_ASSIGNMENT_TARGET, "Invalid assignment target.")                                                  \
+    X(EXPECTED_R_CURLY_AFTER_BLOCK, "Expected '}' after block.")                                                \
+    X(EXPECTED_TYPE_FOR_IDENTIFIER, "Expected type for identifier.")                                            \
+    X(EXPECTED_TYPE, "Expected type.")                                                                          \
+    X(EXPECTED_STRUCT_NAME, "Expected struct name.")                                                            \
+    X(EXPECTED_L_CURLY_BEFORE_FUNCTION_BODY, "Expected '{' before function body.")                              \
+    X(EXPECTED_SEMI_COLON_AFTER_PROPERTY, "Expected ';' after property.")                                       \
+    X(EXPECTED_R_CURLY_AFTER_STRUCT_BODY, "Expected '}' after struct body.")                                    \
+    X(EXPECTED_ENUM_NAME, "Expected enum name.")                                                                \
+    X(EXPECTED_NAME_FOR_ENUM_VARIANT, "Expected name for enum variant.")                                        \
+    X(EXPECTED_R_BRACKET_AFTER_VARIANT_PAYLOAD, "Expected ')' after variant payload.")                          \
+    X(EXPECTED_FUNCTION_NAME, "Expected function name.")                                                        \
+    X(EXPECTED_L_BRACKET_AFTER_FUNCTION_NAME, "Expected '(' after function name.")                              \
+    X(EXPECTED_R_BRACKET_AFTER_PARAMETER_LIST, "Expected ')' after parameter list.")                            \
+    X(EXPECTED_RETURN_TYPE, "Expected return type.")                                                            \
+    X(MAIN_MUST_RETURN_VOID, "Main function must have return type of 'void'.")                                  \
+    X(EXPECTED_EQUAL_AFTER_VARIABLE_DECLARATION, "Expected '=' after variable declaration.")                    \
+    X(EXPECTED_SEMI_COLON_AFTER_VARIABLE_DECLARATION, "Expected ';' after variable declaration.")               \
+    X(EXPRESSION_NESTED_TOO_DEEPLY, "Expression nested too deeply.")                                            \
+    X(EXPECTED_VARIANT_NAME_AFTER_DOT, "Expected variant name after '.'.")                                      \
+    X(EXPECTED_PROPERTY_NAME_AFTER_DOT, "Expected property name after '.'.")                                    \
+    X(EXPECTED_R_BRACKET_AFTER_ARGUMENTS, "Expected ')' after arguments.")                                      \
+    X(EXPECTED_CLOSING_R_BRACKET, "Expected closing ')'.")                                                      \
+    X(EXPECTED_EXPRESSION, "Expected expression.")                                                              \
+    X(EXPECTED_PROPERTY_NAME, "Expected property name.")                                                        \
+    X(EXPECTED_PROPERTY_VALUE, "Expected property value.")                                                      \
+    X(EXPECTED_R_CURLY_AFTER_STRUCT_INITIALISATION, "Expected '}' after struct initialisation.")                \
+                                                                                                                \
+    /* Resolving errors */                                                                                      \
+    X(UNKNOWN_PROPERTY_TYPE, "Unknown type for struct prop.")                                                   \
+    X(UNKNOWN_VARIABLE, "Unknown variable - not declared at this point.")                                       \
+    X(READ_IN_OWN_INITIALISER, "Cannot read local variable in its own initialiser.")                            \
+    X(STRUCT_INIT_ON_NON_STRUCT, "Cannot use struct initialiser on non-struct.")                                \
+    X(UNKNOWN_STRUCT_MEMBER, "Could not find member on struct.")                                                \
+    X(UNKNOWN_ENUM_MEMBER, "Could not find property on enum.")                                                  \
+    X(GET_ON_NON_STRUCT_OR_ENUM, "Cannot get property on a variable that is neither a struct nor enum.")        \
+    X(CANNOT_CALL_NON_FUNCTION, "Cannot call non-function.")                                                    \
+    X(MATCH_ON_NON_ENUM, "Can only match on enum or optional.")                                                 \
+    X(PATTERN_NOT_ENUM_VARIANT, "Pattern must be an enum variant.")                                             \
+    X(UNKNOWN_VARIANT, "Could not find variant on enum.")                                                       \
+    X(BIND_WITHOUT_PAYLOAD, "Enum variant has no payload - cannot bind a variable.")                            \
+    X(ASSIGN_TO_UNDECLARED_VARIABLE, "Cannot assign to a variable that hasn't been declared.")                  \
+    X(SET_ON_OPTIONAL_STRUCT, "Assigning to a property of an optional struct is not currently supported.")      \
+    X(UNKNOWN_STRUCT_PROPERTY, "Could not find property on struct.")                                            \
+    X(SET_ON_NON_STRUCT, "Cannot get property on a variable that is not a struct.")                             \
+                                                                                                                \
+    /* Type errors */                                                                                           \
+    X(CANNOT_INITIALISE_NON_STRUCT, "Cannot initialise non-struct.")                                            \
+    X(OPERATOR_NEEDS_NUMERIC_OR_STRING, "Operator can only be used on numeric or string types.")                \
+    X(OPERAND_TYPES_DIFFER, "Operands must be the same type, or coercible to the same type.")                   \
+    X(OPERATOR_NEEDS_NUMERIC, "Operator can only be used on numeric types.")                                    \
+    X(FALLBACK_ON_NON_NULLABLE, "Cannot use '\?\?' operator on a non-nullable type.")                           \
+    X(OPERATOR_NEEDS_BOOLEANS, "Operator can only be used on boolean types.")                                   \
+    X(OPERATOR_NEEDS_BOOLEAN, "Operator can only be used on a boolean type.")                                   \
+    X(OPTIONAL_CHAINING_ON_NON_OPTIONAL, "Cannot use optional chaining on non-optional type.")                  \
+    X(MISSING_OPTIONAL_CHAINING, "Must use optional chaining for optional type.")                               \
+    X(INVALID_PAYLOAD_TYPE, "Payload of enum cannot be coerced to a valid type.")                               \
+    X(UNEXPECTED_OPTIONAL, "Expected non-optional type. Received optional type.")                               \
+    X(INVALID_TYPE_PASSED_TO_FUNCTION, "Invalid type passed to function.")                                      \
+    X(NOT_ALL_CODE_PATHS_RETURN, "Not all code paths return.")                                                  \
+    X(NON_BOOLEAN_IF_CONDITION, "If condition must be a boolean value.")                                        \
+    X(VARIANTS_NOT_COVERED, "Not all variants covered in pattern matching.")                                    \
+    X(PATTERN_FOR_DIFFERENT_ENUM, "Match pattern must be for the same enum type.")                              \
+    X(UNKNOWN_MATCH_VARIANT, "Could not find variant on enum type.")                                            \
+    X(VARIANT_EXPECTS_PAYLOAD, "Enum variant expects payload.")                                                 \
+    X(VARIANT_HAS_NO_PAYLOAD, "No payload available for this enum variant.")                                    \
+    X(INVALID_ENUM_PATTERN, "Can only match enum variant or null on enum.")                                     \
+    X(NULL_VARIANT_NOT_PROVIDED, "Null variant not provided.")                                                  \
+    X(INVALID_OPTIONAL_PATTERN, "Can only match existing or null on enum.")                                     \
+    X(NON_BOOLEAN_WHILE_CONDITION, "While condition must be a boolean value.")                                  \
+    X(RETURN_OUTSIDE_FUNCTION, "Cannot return from outside of a function.")                                     \
+    X(RETURN_TYPE_MISMATCH, "Must return a type that equals or can coerce to the return type of the function.") \
+    X(MISSING_RETURN_VALUE, "Must return a value from a non-void function.")                                    \
+    X(ASSIGN_DIFFERENT_TYPE, "Cannot assign a different type to this variable.")                                \
+    X(ARGUMENT_COUNT, "Expected %0 arguments, received %1.")                                                    \
+    X(MISSING_PROPERTY, "Missing property %0 from constructor.")                                                \
+    X(ASSIGN_INCOMPATIBLE_TYPE, "Cannot assign a type '%0' to variable of type '%1'.")
+
+enum class DiagnosticCode : uint16_t {
+#define X(code, message) code,
+    DIAGNOSTIC_CODES(X)
+#undef X
+};
+
+// A type written into a message, followed by a `?` if `optional` is set
+struct TypeArg {
+    Type *type;
+    bool optional;
+};
+
+using DiagnosticArg = std::variant<size_t, std::string_view, TypeArg>;
+
+// Which stage of compilation reported the error
+enum class DiagnosticStage {
+    SYNTAX,
+    RESOLVING,
+    TYPE,
+};
+
+// An error, kept as its code and arguments so nothing is formatted unless it is actually reported
+struct Diagnostic {
+    DiagnosticStage stage;
+    DiagnosticCode code;
+    Token token;
+    std::vector<DiagnosticArg> args;
+
+    Diagnostic(DiagnosticStage stage, DiagnosticCode code, Token token, std::initializer_list<DiagnosticArg> args = {});
+
+    // The message with its arguments filled in
+    std::string message() const;
+};
+
+// Write the diagnostic with its line number and where it happened e.g. `[line 3] Syntax error at ';': ...`
+void report(std::ostream &out, const Diagnostic &diagnostic);
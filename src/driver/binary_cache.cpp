@@ -0,0 +1,175 @@
+#include "binary_cache.h"
+
+#include "../code_generator/runtime.h"
+#include "../util/content_hash.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Binaries are linked against the runtime, so one built against an older runtime mustn't be reused
+// Its header and library are only rewritten when the runtime is rebuilt, so their size and modification time are enough
+static std::string runtime_stamp() {
+    std::string stamp;
+    for (const char *file : {"/baz_runtime.h", "/libbazrt.a"}) {
+        struct stat st;
+        if (stat((RUNTIME_DIR + file).c_str(), &st) == 0)
+            stamp += std::to_string(st.st_size) + ":" + std::to_string(st.st_mtime) + ";";
+    }
+
+    return stamp;
+}
+
+// Split on spaces, as a shell would for flags without any quoting
+static std::vector<std::string> split_flags(const std::string &flags) {
+    std::vector<std::string> split;
+    std::istringstream stream(flags);
+
+    std::string flag;
+    while (stream >> flag)
+        split.push_back(flag);
+
+    return split;
+}
+
+// Copy to a temporary file first, so a binary that is currently running can still be replaced
+// It is named after the process, so concurrent builds never rename each other's half-written copy into place
+static bool copy_binary(const std::string &from, const std::string &to) {
+    std::string partial = to + "." + std::to_string(getpid()) + ".partial";
+
+    std::error_code error;
+    std::filesystem::copy_file(from, partial, std::filesystem::copy_options::overwrite_existing, error);
+    if (!error)
+        std::filesystem::rename(partial, to, error);
+
+    if (error) {
+        std::cerr << "Could not write file '" << to << "': " << error.message() << std::endl;
+        std::filesystem::remove(partial, error);
+        return false;
+    }
+
+    return true;
+}
+
+// Run `args`, writing `input` to its stdin. Returns whether it ran and exited successfully
+static bool run_with_input(const std::vector<std::string> &args, std::string_view input) {
+    // Built before forking, as the child should only exec
+    std::vector<char *> argv;
+    for (const auto &arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "Could not create pipe: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "Could not start compiler: " << std::strerror(errno) << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        dup2(fds[0], STDIN_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execvp(argv[0], argv.data());
+
+        const char *message = "Could not run compiler\n";
+        (void)!write(STDERR_FILENO, message, strlen(message));
+        _exit(127);
+    }
+
+    close(fds[0]);
+
+    // If the compiler exits early, writing fails instead of killing baz
+    auto previous_handler = signal(SIGPIPE, SIG_IGN);
+
+    const char *data = input.data();
+    size_t remaining = input.size();
+    while (remaining > 0) {
+        ssize_t n = write(fds[1], data, remaining);
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        // The compiler has stopped reading, and will report why itself
+        if (n < 0)
+            break;
+
+        data += n;
+        remaining -= n;
+    }
+
+    close(fds[1]);
+    signal(SIGPIPE, previous_handler);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR)
+            return false;
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+BinaryCache::BinaryCache(std::string dir) : BinaryCache(std::move(dir), "g++", split_flags(RUNTIME_FLAGS)) {
+    if (const char *cxx = std::getenv("CXX"))
+        this->compiler = cxx;
+}
+
+BinaryCache::BinaryCache(std::string dir, std::string compiler, std::vector<std::string> flags) : dir(std::move(dir)), compiler(std::move(compiler)), flags(std::move(flags)) {}
+
+std::string BinaryCache::key(std::string_view cpp) const {
+    ContentHash hash;
+    hash.update(this->compiler);
+    for (const auto &flag : this->flags)
+        hash.update(flag);
+
+    hash.update(runtime_stamp());
+    hash.update(cpp);
+    return hash.hex();
+}
+
+BuildResult BinaryCache::build(std::string_view cpp, const std::string &binary) {
+    std::string cached = this->dir + "/" + this->key(cpp);
+    if (access(cached.c_str(), X_OK) == 0)
+        return copy_binary(cached, binary) ? BuildResult::CACHED : BuildResult::FAILED;
+
+    std::error_code error;
+    std::filesystem::create_directories(this->dir, error);
+    if (error) {
+        std::cerr << "Could not create cache directory '" << this->dir << "': " << error.message() << std::endl;
+        return BuildResult::FAILED;
+    }
+
+    // Only renamed into the cache once complete, so a failed or concurrent build never leaves a broken binary there
+    std::string partial = cached + "." + std::to_string(getpid()) + ".partial";
+
+    std::vector<std::string> args = {this->compiler};
+    args.insert(args.end(), this->flags.begin(), this->flags.end());
+    args.insert(args.end(), {"-I", RUNTIME_DIR, "-x", "c++", "-", "-x", "none", "-L", RUNTIME_DIR, "-lbazrt", "-o", partial});
+
+    if (!run_with_input(args, cpp)) {
+        std::filesystem::remove(partial, error);
+        return BuildResult::FAILED;
+    }
+
+    std::filesystem::rename(partial, cached, error);
+    if (error) {
+        std::cerr << "Could not write file '" << cached << "': " << error.message() << std::endl;
+        return BuildResult::FAILED;
+    }
+
+    return copy_binary(cached, binary) ? BuildResult::COMPILED : BuildResult::FAILED;
+}
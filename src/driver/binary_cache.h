@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class BuildResult {
+    // The same C++ had been built before, so its binary was reused
+    CACHED,
+    COMPILED,
+
+    // The compiler couldn't be run, or rejected the C++. Its errors have already been printed
+    FAILED,
+};
+
+// Compiles generated C++ into binaries, keeping each one in `dir` named after a hash of what it was built from:
+// the C++, the compiler, its flags and the runtime library. Building an unchanged program again then just copies its binary
+//
+// The C++ is piped straight into the compiler, so it is never written to disk
+class BinaryCache {
+  private:
+    std::string dir;
+    std::string compiler;
+    std::vector<std::string> flags;
+
+  public:
+    // Compiles with `$CXX` (or g++ if unset), using the flags the runtime header was precompiled with
+    BinaryCache(std::string dir);
+
+    BinaryCache(std::string dir, std::string compiler, std::vector<std::string> flags);
+
+    // Name of the cached binary for `cpp`
+    std::string key(std::string_view cpp) const;
+
+    // Puts the binary for `cpp` at `binary`, only compiling it if it isn't already cached
+    BuildResult build(std::string_view cpp, const std::string &binary);
+};
@@ -0,0 +1,177 @@
+#include "compile_cache.h"
+
+#include "../util/content_hash.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Running totals, as "<hits> <misses> <evictions>"
+const std::string STATS_FILE = "stats";
+const std::string ENTRY_EXTENSION = ".cpp";
+
+// Changes whenever baz is rebuilt, as the executable's size and modification time
+// Only Linux has "/proc/self/exe" - elsewhere this is empty, so entries outlive rebuilding baz
+static std::string compiler_stamp() {
+    struct stat st;
+    if (stat("/proc/self/exe", &st) != 0)
+        return "";
+
+    return std::to_string(st.st_size) + ":" + std::to_string(st.st_mtime);
+}
+
+CompileCache::CompileCache(std::string dir, uint64_t max_size) : dir(std::move(dir)), max_size(max_size) {}
+
+std::optional<CompileCache> CompileCache::open(std::string dir, uint64_t max_size) {
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error || access(dir.c_str(), W_OK) != 0)
+        return std::nullopt;
+
+    return CompileCache(std::move(dir), max_size);
+}
+
+std::string CompileCache::key(std::string_view source) {
+    static const std::string stamp = compiler_stamp();
+    return ContentHash().update(stamp).update(source).hex();
+}
+
+std::string CompileCache::entry_path(const std::string &key) const {
+    return this->dir + "/" + key + ENTRY_EXTENSION;
+}
+
+void CompileCache::record(uint64_t hits, uint64_t misses, uint64_t evictions) {
+    std::error_code error;
+    std::filesystem::create_directories(this->dir, error);
+
+    int fd = ::open((this->dir + "/" + STATS_FILE).c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return;
+
+    flock(fd, LOCK_EX);
+
+    char buffer[128];
+    ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    buffer[std::max<ssize_t>(n, 0)] = '\0';
+
+    uint64_t totals[3] = {0, 0, 0};
+    std::istringstream in(buffer);
+    in >> totals[0] >> totals[1] >> totals[2];
+
+    std::string updated = std::to_string(totals[0] + hits) + " " + std::to_string(totals[1] + misses) + " " + std::to_string(totals[2] + evictions) + "\n";
+    if (ftruncate(fd, 0) == 0)
+        (void)!pwrite(fd, updated.data(), updated.size(), 0);
+
+    // Closing releases the lock
+    close(fd);
+}
+
+std::optional<SourceBuffer> CompileCache::find(const std::string &key) {
+    std::string path = this->entry_path(key);
+    auto entry = SourceBuffer::open(path);
+    if (!entry.has_value()) {
+        this->record(0, 1, 0);
+        return std::nullopt;
+    }
+
+    // Eviction goes by modification time, so using an entry marks it as recently used
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    this->record(1, 0, 0);
+    return entry;
+}
+
+void CompileCache::store(const std::string &key, std::string_view cpp) {
+    std::error_code error;
+    std::filesystem::create_directories(this->dir, error);
+    if (error)
+        return;
+
+    std::string path = this->entry_path(key);
+    std::string partial = path + "." + std::to_string(getpid()) + ".partial";
+    {
+        std::ofstream out(partial, std::ios::binary);
+        out.write(cpp.data(), cpp.size());
+        if (!out) {
+            out.close();
+            std::filesystem::remove(partial, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(partial, path, error);
+    if (error) {
+        std::filesystem::remove(partial, error);
+        return;
+    }
+
+    this->evict();
+}
+
+void CompileCache::evict() {
+    struct Entry {
+        std::filesystem::file_time_type used;
+        uint64_t size;
+        std::filesystem::path path;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code error;
+    for (const auto &file : std::filesystem::directory_iterator(this->dir, error)) {
+        if (file.path().extension() != ENTRY_EXTENSION)
+            continue;
+
+        Entry entry = {file.last_write_time(error), file.file_size(error), file.path()};
+        if (error)
+            continue;
+
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+
+    if (total <= this->max_size)
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.used < b.used; });
+
+    // Another compile may be evicting at the same time, so entries already gone are still counted as freed
+    uint64_t evicted = 0;
+    for (const auto &entry : entries) {
+        if (total <= this->max_size)
+            break;
+
+        if (std::filesystem::remove(entry.path, error))
+            evicted++;
+
+        total -= entry.size;
+    }
+
+    this->record(0, 0, evicted);
+}
+
+CompileCacheStats CompileCache::stats() const {
+    CompileCacheStats stats = {0, 0, 0, 0, 0};
+
+    std::ifstream in(this->dir + "/" + STATS_FILE);
+    in >> stats.hits >> stats.misses >> stats.evictions;
+
+    std::error_code error;
+    for (const auto &file : std::filesystem::directory_iterator(this->dir, error)) {
+        if (file.path().extension() != ENTRY_EXTENSION)
+            continue;
+
+        stats.entries++;
+        stats.size += file.file_size(error);
+    }
+
+    return stats;
+}
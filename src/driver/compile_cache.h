@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../scanner/source_buffer.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Totals kept by a `CompileCache` across every run using it
+struct CompileCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+
+    // What is currently stored
+    uint64_t entries;
+    uint64_t size;
+};
+
+// C++ generated for whole files, kept in `dir` named after a hash of the source and the compiler that generated it,
+// so an unchanged file can skip every phase of compilation
+//
+// Once the entries add up to more than `max_size` bytes, the least recently used are evicted
+// Entries are written to a temporary file then renamed, so any number of compiles can share a cache at once
+class CompileCache {
+  private:
+    std::string dir;
+    uint64_t max_size;
+
+    std::string entry_path(const std::string &key) const;
+
+    // Add to the totals kept in the cache's stats file, locking it so concurrent runs don't lose counts
+    void record(uint64_t hits, uint64_t misses, uint64_t evictions);
+
+    // Remove the least recently used entries until the cache is no larger than `max_size`
+    void evict();
+
+  public:
+    CompileCache(std::string dir, uint64_t max_size);
+
+    // Creates `dir` if it doesn't exist yet, giving nothing if it can't be created or written to
+    static std::optional<CompileCache> open(std::string dir, uint64_t max_size);
+
+    // Identifies `source` compiled by this build of baz, so a rebuilt compiler never reuses older output
+    static std::string key(std::string_view source);
+
+    // The C++ stored for `key`, counting a hit or a miss
+    std::optional<SourceBuffer> find(const std::string &key);
+
+    // Store the C++ generated for `key`, then evict entries if the cache has grown too large
+    // Failing to store is ignored, as the C++ has already been generated
+    void store(const std::string &key, std::string_view cpp);
+
+    CompileCacheStats stats() const;
+};
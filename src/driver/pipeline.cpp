@@ -0,0 +1,120 @@
+#include "pipeline.h"
+#include "../code_generator/cpp_generator.h"
+#include "../type_checker/resolver.h"
+#include "../type_checker/type_checker.h"
+#include "../type_checker/type_environment.h"
+#include "../util/blocking_queue.h"
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+void compile_pipelined(Parser &parser, AstArena &arena, ThreadPool &pool, OutputSink &output) {
+    BlockingQueue<NodePtr<Stmt>> parsed;
+    std::optional<Diagnostic> parse_error;
+    std::optional<ScannerError> scan_error;
+
+    std::thread parser_thread([&]() {
+        try {
+            auto stmt = parser.parse_stmt();
+            while (stmt.has_value()) {
+                parsed.push(std::move(stmt.value()));
+                stmt = parser.parse_stmt();
+            }
+        } catch (ParserError e) {
+            parse_error = e.diagnostic;
+        } catch (ScannerError e) {
+            scan_error = e;
+        }
+
+        parsed.close();
+    });
+
+    // Name each type as soon as it is parsed, so only the signatures are left once parsing has finished
+    // NOTE: the parser is allocating in `arena` until it is joined, so the declarations are only moved into it after that
+    auto type_env = TypeEnvironment();
+    std::vector<NodePtr<Stmt>> parsed_stmts;
+    for (auto stmt = parsed.pop(); stmt.has_value(); stmt = parsed.pop()) {
+        type_env.add_type_name(stmt.value().get());
+        parsed_stmts.push_back(std::move(stmt.value()));
+    }
+
+    parser_thread.join();
+    if (scan_error.has_value())
+        throw scan_error.value();
+
+    if (parse_error.has_value())
+        throw ParserError{parse_error.value()};
+
+    NodeList<Stmt> stmts = arena.list(std::move(parsed_stmts));
+
+    type_env.add_signatures(stmts);
+
+    // How many declarations have been resolved, guarded by `mutex`
+    // On a resolving error nothing more is resolved, so it is set to every declaration to stop anything waiting
+    std::mutex mutex;
+    std::condition_variable resolved_more;
+    size_t resolved = 0;
+    std::optional<Diagnostic> resolve_error;
+
+    // Resolving has to see the declarations in order, but is cheap next to checking and generating them
+    std::thread resolver_thread([&]() {
+        Resolver resolver(type_env.type_env, true);
+        try {
+            for (size_t i = 0; i < stmts.size(); i++) {
+                resolver.resolve(stmts[i].get());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                resolved = i + 1;
+                resolved_more.notify_all();
+            }
+        } catch (ResolverError e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            resolve_error = e.diagnostic;
+            resolved = stmts.size();
+            resolved_more.notify_all();
+        }
+    });
+
+    // The pool takes declarations in order, so each job only waits for the resolver to catch up to it
+    std::vector<std::optional<Diagnostic>> type_errors(stmts.size());
+    std::vector<std::string> generated(stmts.size());
+    pool.for_each(stmts.size(), [&](size_t i) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            resolved_more.wait(lock, [&]() { return resolved > i; });
+            if (resolve_error.has_value())
+                return;
+        }
+
+        type_errors[i] = TypeChecker(type_env.type_env).check_decl(stmts[i].get());
+        if (type_errors[i].has_value())
+            return;
+
+        MemorySink output;
+        CppGenerator(output, type_env.type_env).generate_decl(stmts[i].get());
+        generated[i] = output.view();
+    });
+
+    resolver_thread.join();
+
+    // Resolving errors come before any type error, wherever they are
+    if (resolve_error.has_value())
+        throw ResolverError{resolve_error.value()};
+
+    for (auto &error : type_errors) {
+        if (error.has_value()) {
+            report(std::cerr, error.value());
+            throw TypeCheckerError::OP_ON_INCOMPATIBLE_TYPES;
+        }
+    }
+
+    CppGenerator(output, type_env.type_env).generate_preamble();
+    for (auto &decl : generated) {
+        output.sputn(decl.data(), decl.size());
+    }
+}
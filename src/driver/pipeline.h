@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../ast/ast_arena.h"
+#include "../code_generator/output_sink.h"
+#include "../parser/parser.h"
+#include "../util/thread_pool.h"
+
+// Compile everything `parser` parses into C++ written to `output`, overlapping the stages instead of running them one after another:
+//  - A parser thread pushes each top level declaration into a queue, and the types they declare are named as they arrive
+//  - Once the last declaration is parsed, every signature is added to the type environment
+//  - A resolver thread resolves each declaration in order, and as soon as one is resolved it is checked and
+//    generated on the pool, at the same time as later declarations are still being resolved
+//
+// `parser` and its scanner must have been asked to throw their errors, and must only be used by this
+// Errors are found exactly as running each stage in turn would, and nothing is written once one is:
+// scanning errors throw a `ScannerError`, syntax errors a `ParserError`, resolving errors a `ResolverError`,
+// and type errors are reported and then thrown as a `TypeCheckerError`
+void compile_pipelined(Parser &parser, AstArena &arena, ThreadPool &pool, OutputSink &output);
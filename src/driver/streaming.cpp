@@ -0,0 +1,95 @@
+#include "streaming.h"
+#include "../code_generator/cpp_generator.h"
+#include "../parser/parser.h"
+#include "../scanner/scanner.h"
+#include "../scanner/token_buffer.h"
+#include "../type_checker/resolver.h"
+#include "../type_checker/type_checker.h"
+
+#include <iostream>
+#include <memory>
+#include <optional>
+
+StreamingCompiler::StreamingCompiler(std::string_view source) : source(source), signatures(signature_arena.nodes<Stmt>()) {
+    Parser parser = Parser(std::make_unique<StringScanner>(source), this->signature_arena, true);
+    parser.set_signatures_only(true);
+
+    try {
+        while (true) {
+            Token start = parser.next_token();
+            auto stmt = parser.parse_stmt();
+            if (!stmt.has_value())
+                break;
+
+            this->starts.push_back(start);
+            this->signatures.push_back(std::move(stmt.value()));
+        }
+    } catch (ParserError e) {
+        // A syntax error in a skipped body may have come first
+        this->fail_parse(e.diagnostic);
+    }
+
+    this->type_env.generate_type_env(this->signatures);
+}
+
+void StreamingCompiler::fail_parse(Diagnostic diagnostic) {
+    StringScanner scan = StringScanner(this->source);
+    AstArena arena;
+    Parser parser = Parser(TokenBuffer::tokenize(scan), arena);
+    while (parser.parse_stmt().has_value()) {
+    }
+
+    // Parsing everything should have found the error already
+    report(std::cerr, diagnostic);
+    exit(2);
+}
+
+void StreamingCompiler::compile(OutputSink &output) {
+    auto resolver = Resolver(this->type_env.type_env, true);
+    auto type_checker = TypeChecker(this->type_env.type_env);
+    auto cpp_generator = CppGenerator(output, this->type_env.type_env);
+
+    // Resolving errors come before any type error, wherever they are, so declarations are still resolved after a
+    // type error. After a resolving error they are still parsed, as syntax errors come before both
+    std::optional<Diagnostic> resolve_error;
+    std::optional<Diagnostic> type_error;
+
+    cpp_generator.generate_preamble();
+    for (size_t i = 0; i < this->signatures.size(); i++) {
+        // Freed along with the declaration at the end of each iteration
+        AstArena arena;
+
+        // Scan from the start of the declaration to the end of the file, as only as much as is parsed gets scanned
+        const Token &start = this->starts[i];
+        std::string_view rest = this->source.substr(start.lexeme.data() - this->source.data());
+        Parser parser = Parser(std::make_unique<StringScanner>(rest, SymbolTable::global(), false, start.line), arena, true);
+
+        NodePtr<Stmt> stmt = std::move(parser.parse_stmt().value());
+        this->type_env.reuse_signature(this->signatures[i].get(), stmt.get());
+
+        if (resolve_error.has_value())
+            continue;
+
+        try {
+            resolver.resolve(stmt.get());
+        } catch (ResolverError e) {
+            resolve_error = e.diagnostic;
+            continue;
+        }
+
+        if (type_error.has_value())
+            continue;
+
+        type_error = type_checker.check_decl(stmt.get());
+        if (!type_error.has_value())
+            cpp_generator.generate_decl(stmt.get());
+    }
+
+    if (resolve_error.has_value())
+        throw ResolverError{resolve_error.value()};
+
+    if (type_error.has_value()) {
+        report(std::cerr, type_error.value());
+        throw TypeCheckerError::OP_ON_INCOMPATIBLE_TYPES;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../ast/ast_arena.h"
+#include "../ast/stmt.h"
+#include "../code_generator/output_sink.h"
+#include "../diagnostics/diagnostic.h"
+#include "../scanner/token.h"
+#include "../type_checker/type_environment.h"
+
+#include <string_view>
+#include <vector>
+
+// Compiles a file in two passes, so the whole program's AST is never alive at once:
+//  - The first pass parses only the signatures, skipping every function body, and builds the type environment
+//  - The second pass parses each declaration again in its own arena, then resolves, checks and generates it,
+//    and frees it before moving on to the next one
+//
+// Peak memory then tracks the largest declaration (plus the signatures) rather than the whole program
+class StreamingCompiler {
+  private:
+    // NOTE: both passes point into the source, so it must outlive the compiler
+    std::string_view source;
+
+    AstArena signature_arena;
+    NodeList<Stmt> signatures;
+
+    // The token each declaration starts at, so the second pass can scan it again from there
+    std::vector<Token> starts;
+
+    TypeEnvironment type_env;
+
+    // Parse the whole file at once, which reports the first error exactly as compiling normally would
+    void fail_parse(Diagnostic diagnostic);
+
+  public:
+    // Run the first pass. Scanning and syntax errors are reported and exit, as they would normally
+    StreamingCompiler(std::string_view source);
+
+    // Run the second pass, writing the C++ as each declaration is generated
+    // Errors are reported exactly as compiling normally would, so once any is found nothing more is written:
+    // syntax errors throw a `ParserError`, resolving errors a `ResolverError`,
+    // and type errors are reported and then thrown as a `TypeCheckerError`
+    void compile(OutputSink &output);
+};
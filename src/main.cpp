@@ -1,77 +1,473 @@
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "ast/stmt.h"
 #include "code_generator/cpp_generator.h"
+#include "code_generator/makefile_generator.h"
+#include "code_generator/output_sink.h"
+#include "driver/binary_cache.h"
+#include "driver/compile_cache.h"
+#include "driver/pipeline.h"
+#include "driver/streaming.h"
+#include "parser/parallel_parser.h"
 #include "parser/parser.h"
+#include "scanner/file_scanner.h"
+#include "scanner/parallel_tokenizer.h"
 #include "scanner/scanner.h"
+#include "scanner/source_buffer.h"
+#include "scanner/token_buffer.h"
 #include "type_checker/resolver.h"
 #include "type_checker/type_checker.h"
 #include "type_checker/type_environment.h"
+#include "util/thread_pool.h"
 
-std::string read_file(std::string path) {
-    std::ifstream file(path);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-    return buffer.str();
+// Rough average used to size the token buffer up front, avoiding most reallocations
+const size_t BYTES_PER_TOKEN_ESTIMATE = 4;
+
+// Smallest amount of source given to each thread when tokenizing in parallel
+const size_t MIN_PARALLEL_CHUNK_SIZE = 1024 * 1024;
+
+// Fewest tokens for it to be worth parsing declarations in parallel
+const size_t MIN_PARALLEL_PARSE_TOKENS = 64 * 1024;
+
+// Fewest top level declarations for it to be worth type checking and generating them in parallel
+const size_t MIN_PARALLEL_DECLS = 64;
+
+// Sharded output is written to these, along with a source file for each shard
+const std::string SHARD_HEADER = "output.h";
+const std::string MAKEFILE = "Makefile";
+
+// `baz build` compiles the C++ into this binary, keeping every binary it has built in the cache directory
+const std::string BUILD_BINARY = "main";
+const std::string BUILD_CACHE_DIR = ".baz-cache";
+
+// With `--cache`, C++ generated for each file is kept here (or in `BAZ_CACHE_DIR`), so compiling an unchanged file again skips every phase
+const std::string COMPILE_CACHE_DIR = BUILD_CACHE_DIR + "/cpp";
+
+// Most C++ kept in the cache unless `BAZ_CACHE_SIZE` (in MiB) says otherwise, after which the least recently used is evicted
+const uint64_t DEFAULT_COMPILE_CACHE_SIZE = 256 * 1024 * 1024;
+
+// Pipes, FIFOs and stdin can't be mapped, so are streamed through a `FileScanner` instead
+bool is_streamed_source(const char *path) {
+    if (strcmp(path, "-") == 0)
+        return true;
+
+    struct stat st;
+    return stat(path, &st) == 0 && !S_ISREG(st.st_mode);
+}
+
+// Type errors have already been reported by the time they are caught
+void fail_type_check() {
+    std::cout << "Failed type check" << std::endl;
+    exit(4);
+}
+
+// Nothing is printed when the C++ itself was written to stdout
+void print_success(const std::string &output_file, bool to_stdout, std::chrono::high_resolution_clock::time_point begin, bool cached = false) {
+    if (to_stdout)
+        return;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    std::cout << "Successfully outputted to '" << output_file << "' in " << us << "us" << (cached ? " (cached)" : "") << std::endl;
+}
+
+std::string compile_cache_dir() {
+    const char *dir = std::getenv("BAZ_CACHE_DIR");
+    return dir != nullptr ? dir : COMPILE_CACHE_DIR;
+}
+
+// A size that isn't a number is warned about and ignored, rather than evicting everything as a size of 0 would
+uint64_t compile_cache_size() {
+    const char *mib = std::getenv("BAZ_CACHE_SIZE");
+    if (mib == nullptr)
+        return DEFAULT_COMPILE_CACHE_SIZE;
+
+    char *end = nullptr;
+    errno = 0;
+    uint64_t size = strtoull(mib, &end, 10);
+    if (end == mib || *end != '\0' || errno != 0 || mib[0] == '-') {
+        std::cerr << "Expected BAZ_CACHE_SIZE to be a number of MiB, using " << DEFAULT_COMPILE_CACHE_SIZE / (1024 * 1024) << " instead" << std::endl;
+        return DEFAULT_COMPILE_CACHE_SIZE;
+    }
+
+    return size * 1024 * 1024;
+}
+
+// A cache that can't be written to is skipped with a warning, as the file can still be compiled without it
+std::optional<CompileCache> open_compile_cache() {
+    auto cache = CompileCache::open(compile_cache_dir(), compile_cache_size());
+    if (!cache.has_value())
+        std::cerr << "Could not use cache directory '" << compile_cache_dir() << "', compiling without it" << std::endl;
+
+    return cache;
+}
+
+void print_cache_stats() {
+    CompileCacheStats stats = CompileCache(compile_cache_dir(), compile_cache_size()).stats();
+    uint64_t lookups = stats.hits + stats.misses;
+
+    std::cout << "Hits: " << stats.hits << std::endl;
+    std::cout << "Misses: " << stats.misses << std::endl;
+    std::cout << "Hit rate: " << (lookups == 0 ? 0 : stats.hits * 100 / lookups) << "%" << std::endl;
+    std::cout << "Evictions: " << stats.evictions << std::endl;
+    std::cout << "Entries: " << stats.entries << " (" << stats.size << " bytes)" << std::endl;
+}
+
+// Only opened once there is output to write, so a failed compile leaves the previous output alone
+std::unique_ptr<OutputSink> open_output(const std::string &output_file, bool to_stdout) {
+    if (to_stdout)
+        return std::make_unique<StdoutSink>();
+
+    auto sink = std::make_unique<FileSink>(output_file);
+    if (!sink->is_open()) {
+        std::cerr << "Could not write file '" << output_file << "'" << std::endl;
+        exit(1);
+    }
+
+    return sink;
+}
+
+// Write out C++ that was kept in memory
+void write_output(std::string_view cpp, const std::string &output_file, bool to_stdout) {
+    auto output = open_output(output_file, to_stdout);
+    output->sputn(cpp.data(), cpp.size());
+    output->flush();
+}
+
+// Compile the C++ into `BUILD_BINARY`, exiting if the compiler fails
+void build_binary(std::string_view cpp, std::chrono::high_resolution_clock::time_point begin) {
+    BinaryCache cache(BUILD_CACHE_DIR);
+    BuildResult result = cache.build(cpp, BUILD_BINARY);
+    if (result == BuildResult::FAILED) {
+        std::cerr << "Failed to build '" << BUILD_BINARY << "'" << std::endl;
+        exit(1);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    std::cout << "Successfully built '" << BUILD_BINARY << "' in " << us << "us" << (result == BuildResult::CACHED ? " (cached)" : "") << std::endl;
+}
+
+// Compile one declaration at a time, writing to a separate file until everything has succeeded
+// Output to stdout can't be taken back, so is written to directly
+void compile_streaming(std::string_view source, const std::string &output_file, bool to_stdout) {
+    StreamingCompiler compiler(source);
+
+    std::string partial_file = output_file + ".partial";
+    auto discard_partial = [&]() {
+        if (!to_stdout)
+            std::remove(partial_file.c_str());
+    };
+
+    {
+        auto sink = open_output(partial_file, to_stdout);
+        try {
+            compiler.compile(*sink);
+        } catch (ParserError e) {
+            discard_partial();
+            report(std::cerr, e.diagnostic);
+            exit(2);
+        } catch (ResolverError e) {
+            discard_partial();
+            report(std::cerr, e.diagnostic);
+            exit(5);
+        } catch (TypeCheckerError) {
+            discard_partial();
+            fail_type_check();
+        }
+    }
+
+    if (!to_stdout)
+        std::rename(partial_file.c_str(), output_file.c_str());
+}
+
+// Split the C++ between a header and source files generated in parallel, along with a Makefile to compile them in parallel
+void generate_shards(NodeList<Stmt> &stmts, const TypeTable &type_env, size_t shard_count, ThreadPool &pool) {
+    {
+        auto header = open_output(SHARD_HEADER, false);
+        CppGenerator(*header, type_env).generate_header(stmts);
+    }
+
+    // Each shard gets a run of declarations, so none are empty unless there are no declarations at all
+    shard_count = std::max<size_t>(1, std::min(shard_count, stmts.size()));
+
+    std::vector<std::string> sources(shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        sources[i] = "output_" + std::to_string(i) + ".cpp";
+    }
+
+    pool.for_each(shard_count, [&](size_t i) {
+        size_t begin = stmts.size() * i / shard_count;
+        size_t end = stmts.size() * (i + 1) / shard_count;
+
+        auto source = open_output(sources[i], false);
+        CppGenerator(*source, type_env).generate_source(stmts, begin, end, SHARD_HEADER);
+    });
+
+    auto makefile = open_output(MAKEFILE, false);
+    generate_makefile(*makefile, SHARD_HEADER, sources, "main");
 }
 
 int main(int argc, char *argv[]) {
     auto begin = std::chrono::high_resolution_clock::now();
-    if (argc != 2) {
+
+    // `baz build` goes on to compile the C++ into a binary, without writing the C++ anywhere
+    bool building = argc > 1 && strcmp(argv[1], "build") == 0;
+
+    bool streaming = false;
+    bool to_stdout = false;
+    bool use_cache = std::getenv("BAZ_CACHE_DIR") != nullptr;
+    size_t shard_count = 0;
+    const char *arg = nullptr;
+    for (int i = building ? 2 : 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            std::cout << "Usage: './baz [options] <source_code_path>'  compile the specified source code file ('-' reads from stdin)" << std::endl;
+            std::cout << "       './baz build <source_code_path>'  compile the specified source code file into '" << BUILD_BINARY << "', reusing the binary if it was built before" << std::endl;
+            std::cout << "  --stream  only keep one declaration in memory at a time, reading the file twice" << std::endl;
+            std::cout << "  --stdout  write the C++ to stdout instead of 'output.cpp'" << std::endl;
+            std::cout << "  --shards <count>  split the C++ into 'output.h' and <count> files to compile in parallel, built by the generated 'Makefile'" << std::endl;
+            std::cout << "  --cache  reuse the C++ generated for an unchanged file, keeping it in '" << COMPILE_CACHE_DIR << "' (or $BAZ_CACHE_DIR, which also turns this on)" << std::endl;
+            std::cout << "  --cache-stats  print how often the C++ has been reused, and how much is cached" << std::endl;
+            exit(0);
+        }
+
+        if (strcmp(argv[i], "--cache-stats") == 0) {
+            print_cache_stats();
+            exit(0);
+        }
+
+        if (strcmp(argv[i], "--stream") == 0) {
+            streaming = true;
+        } else if (strcmp(argv[i], "--stdout") == 0) {
+            to_stdout = true;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            use_cache = true;
+        } else if (strcmp(argv[i], "--shards") == 0) {
+            char *end = nullptr;
+            shard_count = i + 1 < argc ? strtoul(argv[++i], &end, 10) : 0;
+            if (shard_count == 0 || *end != '\0') {
+                std::cerr << "Expected a number of shards" << std::endl;
+                exit(1);
+            }
+        } else if (arg == nullptr) {
+            arg = argv[i];
+        } else {
+            arg = nullptr;
+            break;
+        }
+    }
+
+    if (arg == nullptr) {
         std::cerr << "Expected path to source code" << std::endl;
         exit(1);
     }
 
-    auto arg = argv[1];
-    if (strcmp(arg, "--help") == 0) {
-        std::cout << "Usage: './baz <source_code_path>'  compile the specified source code file" << std::endl;
-        exit(0);
+    if (shard_count > 0 && (streaming || to_stdout)) {
+        std::cerr << "Sharded output can't be streamed or written to stdout" << std::endl;
+        exit(1);
     }
 
-    auto source = read_file(argv[1]);
+    if (building && (streaming || to_stdout || shard_count > 0)) {
+        std::cerr << "Building can't be combined with --stream, --stdout or --shards" << std::endl;
+        exit(1);
+    }
 
-    auto scan = std::make_unique<StringScanner>(source);
-    Parser parser = Parser(std::move(scan));
+    // NOTE: tokens and the AST point into the source, so it must stay alive until compilation has finished
+    std::optional<SourceBuffer> source;
 
-    std::vector<std::unique_ptr<Stmt>> stmts;
-    auto stmt = parser.parse_stmt();
-    while (stmt.has_value()) {
-        stmts.push_back(std::move(stmt.value()));
-        stmt = parser.parse_stmt();
+    std::string output_file("output.cpp");
+
+    if (!is_streamed_source(arg)) {
+        source = SourceBuffer::open(arg);
+        if (!source.has_value()) {
+            std::cerr << "Could not read file '" << arg << "'" << std::endl;
+            exit(1);
+        }
+    }
+
+    // Only whole files can be looked up before compiling, and sharded output is spread over too many files to cache
+    std::optional<CompileCache> cache;
+    std::string cache_key;
+    if (use_cache && source.has_value() && shard_count == 0)
+        cache = open_compile_cache();
+
+    if (cache.has_value()) {
+        cache_key = CompileCache::key(source->view());
+
+        auto cached = cache->find(cache_key);
+        if (cached.has_value()) {
+            if (building) {
+                build_binary(cached->view(), begin);
+                return 0;
+            }
+
+            write_output(cached->view(), output_file, to_stdout);
+            print_success(output_file, to_stdout, begin, true);
+            return 0;
+        }
+    }
+
+    // Pipes and stdin can't be read twice, so are compiled as normal
+    if (streaming && source.has_value()) {
+        compile_streaming(source->view(), output_file, to_stdout);
+
+        // Only one declaration's C++ is kept in memory, so what was written is read back to be cached
+        if (cache.has_value() && !to_stdout) {
+            auto cpp = SourceBuffer::open(output_file);
+            if (cpp.has_value())
+                cache->store(cache_key, cpp->view());
+        }
+
+        print_success(output_file, to_stdout, begin);
+        return 0;
+    }
+
+    // Shared by every pass that works in parallel
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+    // Owns the whole AST, which is freed in one go at the end of compilation
+    AstArena arena;
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    std::unique_ptr<Parser> parser;
+
+    if (is_streamed_source(arg)) {
+        int fd = strcmp(arg, "-") == 0 ? STDIN_FILENO : open(arg, O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Could not read file '" << arg << "'" << std::endl;
+            exit(1);
+        }
+
+        // Streamed sources are scanned as the parser needs them, so only a chunk is buffered at a time
+        // Parsing them can't be split up, so with cores to spare the later stages run alongside it instead
+        if (pool.size() > 1 && shard_count == 0) {
+            Parser streamed_parser = Parser(std::make_unique<FileScanner>(fd, FileScanner::DEFAULT_CHUNK_SIZE, true), arena, true);
+
+            // Nothing is written until every error has been found, so the previous output is left alone on failure
+            MemorySink cpp;
+            try {
+                compile_pipelined(streamed_parser, arena, pool, cpp);
+            } catch (ScannerError e) {
+                std::cerr << e.message << std::endl;
+                exit(1);
+            } catch (ParserError e) {
+                report(std::cerr, e.diagnostic);
+                exit(2);
+            } catch (ResolverError e) {
+                report(std::cerr, e.diagnostic);
+                exit(5);
+            } catch (TypeCheckerError) {
+                fail_type_check();
+            }
+
+            if (building) {
+                build_binary(cpp.view(), begin);
+                return 0;
+            }
+
+            write_output(cpp.view(), output_file, to_stdout);
+            print_success(output_file, to_stdout, begin);
+            return 0;
+        }
+
+        parser = std::make_unique<Parser>(std::make_unique<FileScanner>(fd), arena);
+    } else {
+        // Tokenize the whole file up front, split across every core if it is large enough to be worth it
+        std::string_view view = source->view();
+        size_t chunk_count = std::min<size_t>(std::thread::hardware_concurrency(), view.length() / MIN_PARALLEL_CHUNK_SIZE);
+
+        TokenBuffer tokens;
+        if (chunk_count > 1) {
+            tokens = tokenize_parallel(view, chunk_count);
+        } else {
+            StringScanner scan = StringScanner(view);
+            tokens = TokenBuffer::tokenize(scan, view.length() / BYTES_PER_TOKEN_ESTIMATE);
+        }
+
+        // Top level declarations can be parsed on their own, so large files are split between every core
+        if (pool.size() > 1 && tokens.size() >= MIN_PARALLEL_PARSE_TOKENS) {
+            stmts = parse_parallel(tokens, arena, pool);
+        } else {
+            parser = std::make_unique<Parser>(std::move(tokens), arena);
+        }
+    }
+
+    // Unless already parsed in parallel, parse one declaration at a time
+    if (parser) {
+        auto stmt = parser->parse_stmt();
+        while (stmt.has_value()) {
+            stmts.push_back(std::move(stmt.value()));
+            stmt = parser->parse_stmt();
+        }
     }
 
     // Generate type environment
     auto type_env = TypeEnvironment();
     type_env.generate_type_env(stmts);
 
-    // Resolve types
-    auto resolver = Resolver(type_env.type_env);
-    resolver.resolve(stmts);
+    // Type checking and code generation also split declarations between threads, if there are enough of them
+    bool parallel = pool.size() > 1 && stmts.size() >= MIN_PARALLEL_DECLS;
 
-    // Check types
+    // Resolve and check types
     auto type_checker = TypeChecker(type_env.type_env);
     try {
-        type_checker.check(stmts);
+        if (parallel) {
+            // Names are all resolved first, so each function can then be checked on its own
+            auto resolver = Resolver(type_env.type_env);
+            resolver.resolve(stmts);
+            type_checker.check_parallel(stmts, pool);
+        } else {
+            type_checker.resolve_and_check(stmts);
+        }
     } catch (TypeCheckerError) {
-        std::cout << "Failed type check" << std::endl;
-        exit(4);
+        fail_type_check();
     }
 
-    // Generate C++
-    std::string output_file("output.cpp");
-    std::ofstream file(output_file);
-    auto cpp_generator = CppGenerator(file, type_env.type_env);
-    cpp_generator.generate(stmts);
+    if (shard_count > 0) {
+        generate_shards(stmts, type_env.type_env, shard_count, pool);
+        print_success(MAKEFILE, false, begin);
+        return 0;
+    }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
-    std::cout << "Successfully outputted to '" << output_file << "' in " << us << "us" << std::endl;
+    // Generate C++, which is kept in memory to be stored in the cache, or to be piped into the compiler when building
+    bool in_memory = building || cache.has_value();
+    MemorySink cpp;
+    std::unique_ptr<OutputSink> file_output = in_memory ? nullptr : open_output(output_file, to_stdout);
+    OutputSink &output = in_memory ? cpp : *file_output;
+
+    auto cpp_generator = CppGenerator(output, type_env.type_env);
+    if (parallel) {
+        cpp_generator.generate(stmts, pool);
+    } else {
+        cpp_generator.generate(stmts);
+    }
+
+    output.flush();
+    if (cache.has_value())
+        cache->store(cache_key, cpp.view());
+
+    if (building) {
+        build_binary(cpp.view(), begin);
+        return 0;
+    }
+
+    if (in_memory)
+        write_output(cpp.view(), output_file, to_stdout);
 
+    print_success(output_file, to_stdout, begin);
     return 0;
 }
@@ -0,0 +1,100 @@
+#include "parallel_parser.h"
+#include "parser.h"
+
+#include <memory>
+
+std::vector<size_t> find_decl_split_points(const TokenBuffer &tokens, size_t chunk_count) {
+    std::vector<size_t> splits;
+    if (chunk_count <= 1)
+        return splits;
+
+    size_t target = tokens.size() / chunk_count;
+    long depth = 0;
+
+    // The final EOF token is never a split
+    for (size_t i = 0; i + 1 < tokens.size(); i++) {
+        switch (tokens.type(i)) {
+            case TokenType::L_CURLY_BRACKET:
+                depth++;
+                break;
+            case TokenType::R_CURLY_BRACKET:
+                depth--;
+
+                // Unbalanced - where declarations start is a guess from here on, so the rest is left as one chunk
+                if (depth < 0)
+                    return splits;
+                break;
+            case TokenType::STRUCT:
+            case TokenType::ENUM:
+            case TokenType::FN:
+                if (depth == 0 && i > 0 && i >= target) {
+                    splits.push_back(i);
+                    if (splits.size() == chunk_count - 1)
+                        return splits;
+
+                    target = tokens.size() * (splits.size() + 1) / chunk_count;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return splits;
+}
+
+// Declarations parsed from one chunk, in their own arena as arenas can't be shared between threads
+struct ParsedChunk {
+    std::unique_ptr<AstArena> arena;
+    std::vector<NodePtr<Stmt>> stmts;
+    bool failed = false;
+};
+
+NodeList<Stmt> parse_parallel(const TokenBuffer &tokens, AstArena &arena, ThreadPool &pool) {
+    std::vector<size_t> splits = find_decl_split_points(tokens, pool.size() * ThreadPool::JOBS_PER_THREAD);
+    splits.insert(splits.begin(), 0);
+
+    // Up to, but not including, the EOF token
+    splits.push_back(tokens.size() - 1);
+
+    std::vector<ParsedChunk> chunks(splits.size() - 1);
+    pool.for_each(chunks.size(), [&](size_t i) {
+        ParsedChunk &chunk = chunks[i];
+        chunk.arena = std::make_unique<AstArena>();
+
+        try {
+            Parser parser = Parser(tokens.slice(splits[i], splits[i + 1]), *chunk.arena, true);
+            auto stmt = parser.parse_stmt();
+            while (stmt.has_value()) {
+                chunk.stmts.push_back(std::move(stmt.value()));
+                stmt = parser.parse_stmt();
+            }
+        } catch (ParserError) {
+            chunk.stmts.clear();
+            chunk.failed = true;
+        }
+    });
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    for (size_t i = 0; i < chunks.size(); i++) {
+        // A chunk fails on a syntax error, or if a declaration actually carries on past the end of the chunk
+        // Parsing serially from its start gives what parsing the whole file serially would have from there
+        if (chunks[i].failed) {
+            Parser parser = Parser(tokens.slice(splits[i], tokens.size() - 1), arena);
+            auto stmt = parser.parse_stmt();
+            while (stmt.has_value()) {
+                stmts.push_back(std::move(stmt.value()));
+                stmt = parser.parse_stmt();
+            }
+
+            break;
+        }
+
+        for (auto &stmt : chunks[i].stmts)
+            stmts.push_back(std::move(stmt));
+
+        arena.adopt(std::move(chunks[i].arena));
+    }
+
+    return stmts;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../ast/ast_arena.h"
+#include "../ast/stmt.h"
+#include "../scanner/token_buffer.h"
+#include "../util/thread_pool.h"
+
+#include <vector>
+
+// Find up to `chunk_count - 1` token indices to split `tokens` at so each chunk can be parsed on its own
+// Each split is the `struct`, `enum` or `fn` starting a top level declaration (found by brace depth), as close
+// as possible to evenly spaced. Returns the indices of the splits, which may be fewer than asked for
+std::vector<size_t> find_decl_split_points(const TokenBuffer &tokens, size_t chunk_count);
+
+// Parse every top level declaration in `tokens`, split into chunks which are each parsed on the pool
+// The statements are in source order and identical to parsing serially, including which syntax error is reported
+NodeList<Stmt> parse_parallel(const TokenBuffer &tokens, AstArena &arena, ThreadPool &pool);
@@ -6,16 +6,44 @@
 #include <ostream>
 #include <vector>
 
-Parser::Parser(std::unique_ptr<Scanner> scanner) : scanner(std::move(scanner)) {
+Parser::Parser(TokenBuffer tokens, AstArena &arena, bool throw_errors)
+    : arena(arena), tokens(std::move(tokens)), current(0), expression_depth(0), throw_errors(throw_errors), lazy_bodies(false), signatures_only(false) {}
+
+Parser::Parser(std::unique_ptr<Scanner> scanner, AstArena &arena, bool throw_errors)
+    : arena(arena), current(0), scanner(std::move(scanner)), expression_depth(0), throw_errors(throw_errors), lazy_bodies(false), signatures_only(false) {
     // Set up first token
-    this->advance();
+    this->scanned(0);
 }
 
-std::optional<std::unique_ptr<Stmt>> Parser::parse_stmt() {
+std::optional<NodePtr<Stmt>> Parser::parse_stmt() {
     return this->top_level_decl();
 }
 
-std::optional<std::unique_ptr<Stmt>> Parser::top_level_decl() {
+void Parser::set_lazy_bodies(bool lazy) {
+    this->lazy_bodies = lazy;
+}
+
+void Parser::set_signatures_only(bool signatures_only) {
+    this->signatures_only = signatures_only;
+}
+
+Token Parser::next_token() {
+    return this->peek();
+}
+
+NodeList<Stmt> Parser::parse_body(size_t start) {
+    size_t resume = this->current;
+    this->current = start;
+
+    NodeList<Stmt> body = this->block();
+
+    this->current = resume;
+    return body;
+}
+
+std::optional<NodePtr<Stmt>> Parser::top_level_decl() {
+    this->drop_parsed_tokens();
+
     if (this->peek().t == TokenType::EOF_)
         return std::nullopt;
 
@@ -29,19 +57,19 @@ std::optional<std::unique_ptr<Stmt>> Parser::top_level_decl() {
     if (this->match(TokenType::FN))
         return this->function_decl(FunType::FUNCTION);
 
-    this->error(this->peek(), "Unexpected statement at top level.");
+    this->error(this->peek(), DiagnosticCode::UNEXPECTED_TOP_LEVEL_STATEMENT);
     exit(2);
 }
 
 // Declarations that can only be done nested inside a function
-std::unique_ptr<Stmt> Parser::nested_decl() {
+NodePtr<Stmt> Parser::nested_decl() {
     if (this->match(TokenType::LET))
         return this->variable_decl();
 
     return this->statement();
 }
 
-std::unique_ptr<Stmt> Parser::statement() {
+NodePtr<Stmt> Parser::statement() {
     // Handle each statement based on keyword
     if (this->match(TokenType::IF))
         return this->if_statement();
@@ -58,62 +86,62 @@ std::unique_ptr<Stmt> Parser::statement() {
     if (this->match(TokenType::RETURN))
         return this->return_statement();
     if (this->match(TokenType::L_CURLY_BRACKET))
-        return std::make_unique<BlockStmt>(std::move(this->block()));
+        return this->arena.make<BlockStmt>(std::move(this->block()));
 
-    std::unique_ptr<Expr> expr = this->expression();
+    NodePtr<Expr> expr = this->expression();
 
     // If expression is followed by `=`, this is an assignment - parse the right hand side as an expression
     if (this->match(TokenType::EQUAL)) {
-        std::unique_ptr<Stmt> assign_stmt = this->assignment(*expr);
-        this->consume(TokenType::SEMI_COLON, "Expected ';' after assignment.");
+        NodePtr<Stmt> assign_stmt = this->assignment(*expr);
+        this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_ASSIGNMENT);
         return assign_stmt;
     }
 
     // Expression statement
-    this->consume(TokenType::SEMI_COLON, "Expected ';' after expression.");
-    return std::make_unique<ExprStmt>(std::move(expr));
+    this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_EXPRESSION);
+    return this->arena.make<ExprStmt>(std::move(expr));
 }
 
-std::unique_ptr<IfStmt> Parser::if_statement() {
+NodePtr<IfStmt> Parser::if_statement() {
     auto keyword = this->previous();
 
-    this->consume(TokenType::L_BRACKET, "Expected '(' after 'if'.");
-    std::unique_ptr<Expr> condition = this->expression();
-    this->consume(TokenType::R_BRACKET, "Expected closing ')' after if condition.");
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before if branch.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_IF);
+    NodePtr<Expr> condition = this->expression();
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET_AFTER_IF_CONDITION);
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_IF_BRANCH);
 
     auto true_block = this->block();
 
-    std::optional<std::vector<std::unique_ptr<Stmt>>> false_block = std::nullopt;
+    std::optional<NodeList<Stmt>> false_block = std::nullopt;
     if (this->match(TokenType::ELSE)) {
-        this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before else branch.");
+        this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_ELSE_BRANCH);
         false_block = this->block();
     }
 
-    return std::make_unique<IfStmt>(keyword, std::move(condition), std::move(true_block), std::move(false_block));
+    return this->arena.make<IfStmt>(keyword, std::move(condition), std::move(true_block), std::move(false_block));
 }
 
-std::unique_ptr<MatchStmt> Parser::match_statement() {
+NodePtr<MatchStmt> Parser::match_statement() {
     auto keyword = this->previous();
-    this->consume(TokenType::L_BRACKET, "Expected '(' after 'match'.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_MATCH);
 
-    std::unique_ptr<Expr> target = this->expression();
-    this->consume(TokenType::R_BRACKET, "Expected closing ')' after match target.");
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before match body.");
+    NodePtr<Expr> target = this->expression();
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET_AFTER_MATCH_TARGET);
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_MATCH_BODY);
 
     std::vector<MatchBranch> branches;
     do {
         auto pattern = this->match_pattern();
-        this->consume(TokenType::COLON, "Expected ':' after match pattern.");
+        this->consume(TokenType::COLON, DiagnosticCode::EXPECTED_COLON_AFTER_MATCH_PATTERN);
 
-        this->consume(TokenType::L_CURLY_BRACKET, "Expected block after match pattern.");
+        this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_BLOCK_AFTER_MATCH_PATTERN);
         auto body = this->block();
 
         branches.push_back(MatchBranch(std::move(pattern), std::move(body)));
     } while (this->match(TokenType::COMMA) && !this->check(TokenType::R_CURLY_BRACKET));
 
-    this->consume(TokenType::R_CURLY_BRACKET, "Expected '}' after match branches");
-    return std::make_unique<MatchStmt>(std::move(target), std::move(branches), keyword);
+    this->consume(TokenType::R_CURLY_BRACKET, DiagnosticCode::EXPECTED_R_CURLY_AFTER_MATCH_BRANCHES);
+    return this->arena.make<MatchStmt>(std::move(target), this->arena.list(std::move(branches)), keyword);
 }
 
 MatchPattern Parser::match_pattern() {
@@ -122,155 +150,177 @@ MatchPattern Parser::match_pattern() {
     }
 
     if (!this->match(TokenType::IDENTIFIER)) {
-        this->error(this->peek(), "Expected identifier.");
+        this->error(this->peek(), DiagnosticCode::EXPECTED_IDENTIFIER);
         exit(2);
     }
 
     auto identifier = this->previous();
 
     if (!this->match(TokenType::COLON_COLON)) {
-        auto payload = std::make_unique<VarExpr>(identifier);
+        auto payload = this->arena.make<VarExpr>(identifier);
         return CatchAllPattern(std::move(payload));
     }
 
     if (!this->match(TokenType::IDENTIFIER)) {
-        this->error(this->peek(), "Expected variant.");
+        this->error(this->peek(), DiagnosticCode::EXPECTED_VARIANT);
         exit(2);
     }
 
     auto enum_variant = this->previous();
 
-    std::optional<std::unique_ptr<VarExpr>> payload = std::nullopt;
+    std::optional<NodePtr<VarExpr>> payload = std::nullopt;
     if (this->match(TokenType::L_BRACKET)) {
         if (!this->match(TokenType::IDENTIFIER)) {
-            this->error(this->peek(), "Expected variable to bind to.");
+            this->error(this->peek(), DiagnosticCode::EXPECTED_VARIABLE_TO_BIND_TO);
             exit(2);
         }
 
         auto identifier = this->previous();
-        payload = std::make_unique<VarExpr>(identifier);
-        this->consume(TokenType::R_BRACKET, "Expected ')' after enum payload.");
+        payload = this->arena.make<VarExpr>(identifier);
+        this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_R_BRACKET_AFTER_ENUM_PAYLOAD);
     }
 
     return EnumPattern(identifier, enum_variant, std::move(payload));
 }
 
-std::unique_ptr<ForStmt> Parser::for_statement() {
+NodePtr<ForStmt> Parser::for_statement() {
     auto keyword = this->previous();
 
-    this->consume(TokenType::L_BRACKET, "Expected '(' after 'for'.");
-    this->consume(TokenType::LET, "Expected variable declaration.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_FOR);
+    this->consume(TokenType::LET, DiagnosticCode::EXPECTED_VARIABLE_DECLARATION);
     auto var = this->variable_decl();
 
     auto condition = this->expression();
-    this->consume(TokenType::SEMI_COLON, "Expected ';' after expression.");
-    auto condition_stmt = std::make_unique<ExprStmt>(std::move(condition));
+    this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_EXPRESSION);
+    auto condition_stmt = this->arena.make<ExprStmt>(std::move(condition));
 
     auto expr = this->expression();
-    this->consume(TokenType::EQUAL, "Expected '=' after assignment target.");
+    this->consume(TokenType::EQUAL, DiagnosticCode::EXPECTED_EQUAL_AFTER_ASSIGNMENT_TARGET);
     auto stmt = this->assignment(*expr);
 
-    auto increment = dynamic_cast<AssignStmt *>(stmt.release());
+    auto increment = node_cast<AssignStmt>(stmt.release());
     if (!increment) {
-        this->error(keyword, "Assign statement not valid.");
+        this->error(keyword, DiagnosticCode::ASSIGN_STATEMENT_NOT_VALID);
     }
 
     increment->semicolon = false;
 
-    this->consume(TokenType::R_BRACKET, "Expected closing ')' after for condition.");
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before loop body.");
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET_AFTER_FOR_CONDITION);
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_LOOP_BODY);
     auto body = this->block();
-    return std::make_unique<ForStmt>(std::move(var), std::move(condition_stmt), std::unique_ptr<AssignStmt>(increment), std::move(body));
+    return this->arena.make<ForStmt>(std::move(var), std::move(condition_stmt), NodePtr<AssignStmt>(increment), std::move(body));
 }
 
-std::unique_ptr<WhileStmt> Parser::while_statement() {
+NodePtr<WhileStmt> Parser::while_statement() {
     auto keyword = this->previous();
-    this->consume(TokenType::L_BRACKET, "Expected '(' after 'while'.");
-    std::unique_ptr<Expr> condition = this->expression();
-    this->consume(TokenType::R_BRACKET, "Expected closing ')' after while condition.");
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before loop body.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_WHILE);
+    NodePtr<Expr> condition = this->expression();
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET_AFTER_WHILE_CONDITION);
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_LOOP_BODY);
 
     auto body = this->block();
-    return std::make_unique<WhileStmt>(std::move(condition), std::move(body), keyword);
+    return this->arena.make<WhileStmt>(std::move(condition), std::move(body), keyword);
 }
 
-std::unique_ptr<PrintStmt> Parser::print_statement() {
+NodePtr<PrintStmt> Parser::print_statement() {
     Token print = this->previous();
 
-    this->consume(TokenType::L_BRACKET, "Expected '(' after 'print'.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_PRINT);
     if (this->match(TokenType::R_BRACKET)) {
-        this->consume(TokenType::SEMI_COLON, "Expected ';' after print statement.");
-        return std::make_unique<PrintStmt>(
-            std::optional<std::unique_ptr<Expr>>{},
+        this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_PRINT_STATEMENT);
+        return this->arena.make<PrintStmt>(
+            std::optional<NodePtr<Expr>>{},
             print.lexeme == "println");
     }
 
-    std::unique_ptr<Expr> value = this->expression();
-    this->consume(TokenType::R_BRACKET, "Expected closing ')' after print value.");
-    this->consume(TokenType::SEMI_COLON, "Expected ';' after print statement.");
+    NodePtr<Expr> value = this->expression();
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET_AFTER_PRINT_VALUE);
+    this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_PRINT_STATEMENT);
 
-    return std::make_unique<PrintStmt>(std::move(value), print.lexeme == "println");
+    return this->arena.make<PrintStmt>(std::move(value), print.lexeme == "println");
 }
 
-std::unique_ptr<PanicStmt> Parser::panic_statement() {
+NodePtr<PanicStmt> Parser::panic_statement() {
     Token print = this->previous();
 
-    this->consume(TokenType::L_BRACKET, "Expected '(' after 'panic'.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_PANIC);
     if (this->match(TokenType::R_BRACKET)) {
-        this->consume(TokenType::SEMI_COLON, "Expected ';' after panic statement.");
-        return std::make_unique<PanicStmt>(std::optional<std::unique_ptr<Expr>>{});
+        this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_PANIC_STATEMENT);
+        return this->arena.make<PanicStmt>(std::optional<NodePtr<Expr>>{});
     }
 
-    std::unique_ptr<Expr> value = this->expression();
-    this->consume(TokenType::R_BRACKET, "Expected closing ')' after panic value.");
-    this->consume(TokenType::SEMI_COLON, "Expected ';' after panic statement.");
+    NodePtr<Expr> value = this->expression();
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET_AFTER_PANIC_VALUE);
+    this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_PANIC_STATEMENT);
 
-    return std::make_unique<PanicStmt>(std::move(value));
+    return this->arena.make<PanicStmt>(std::move(value));
 }
 
-std::unique_ptr<ReturnStmt> Parser::return_statement() {
+NodePtr<ReturnStmt> Parser::return_statement() {
     auto keyword = this->previous();
 
     if (this->match(TokenType::SEMI_COLON)) {
-        return std::make_unique<ReturnStmt>(std::optional<std::unique_ptr<Expr>>{}, keyword);
+        return this->arena.make<ReturnStmt>(std::optional<NodePtr<Expr>>{}, keyword);
     }
 
-    std::unique_ptr<Expr> value = this->expression();
-    this->consume(TokenType::SEMI_COLON, "Expected ';' after return statement.");
+    NodePtr<Expr> value = this->expression();
+    this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_RETURN_STATEMENT);
 
-    return std::make_unique<ReturnStmt>(std::move(value), keyword);
+    return this->arena.make<ReturnStmt>(std::move(value), keyword);
 }
 
-std::unique_ptr<Stmt> Parser::assignment(Expr &lhs) {
+NodePtr<Stmt> Parser::assignment(Expr &lhs) {
     Token equals_token = this->previous();
-    std::unique_ptr<Expr> value = this->expression();
+    NodePtr<Expr> value = this->expression();
 
-    if (VarExpr *var = dynamic_cast<VarExpr *>(&lhs)) {
+    if (VarExpr *var = node_cast<VarExpr>(&lhs)) {
         Token name = var->name;
-        return std::make_unique<AssignStmt>(name, std::move(value));
-    } else if (GetExpr *get = dynamic_cast<GetExpr *>(&lhs)) {
-        return std::make_unique<SetStmt>(std::move(get->object), get->name, std::move(value));
+        return this->arena.make<AssignStmt>(name, std::move(value));
+    } else if (GetExpr *get = node_cast<GetExpr>(&lhs)) {
+        return this->arena.make<SetStmt>(std::move(get->object), get->name, std::move(value));
     }
 
-    this->error(equals_token, "Invalid assignment target.");
+    this->error(equals_token, DiagnosticCode::INVALID_ASSIGNMENT_TARGET);
     exit(2);
 }
 
-std::vector<std::unique_ptr<Stmt>> Parser::block() {
-    std::vector<std::unique_ptr<Stmt>> stmts;
+NodeList<Stmt> Parser::block() {
+    std::vector<NodePtr<Stmt>> stmts;
     while (!this->check(TokenType::R_CURLY_BRACKET)) {
         stmts.push_back(this->nested_decl());
     }
 
-    this->consume(TokenType::R_CURLY_BRACKET, "Expected '}' after block.");
+    this->consume(TokenType::R_CURLY_BRACKET, DiagnosticCode::EXPECTED_R_CURLY_AFTER_BLOCK);
+
+    return this->arena.list(std::move(stmts));
+}
+
+// Move past the `}` matching an already consumed `{`, without parsing anything in between
+void Parser::skip_block() {
+    size_t start = this->current;
+    size_t depth = 1;
 
-    return stmts;
+    while (depth > 0) {
+        if (this->check(TokenType::EOF_)) {
+            // Never closed - parse it now so the error is the same as it would have been
+            this->current = start;
+            this->block();
+            return;
+        }
+
+        if (this->check(TokenType::L_CURLY_BRACKET))
+            depth++;
+        else if (this->check(TokenType::R_CURLY_BRACKET))
+            depth--;
+
+        this->advance();
+    }
 }
 
 TypedVar Parser::typed_identifier() {
-    Token name = this->consume(TokenType::IDENTIFIER, "Expected identifier.");
+    Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_IDENTIFIER);
 
-    this->consume(TokenType::COLON, "Expected type for identifier.");
+    this->consume(TokenType::COLON, DiagnosticCode::EXPECTED_TYPE_FOR_IDENTIFIER);
 
     Token type = this->type();
     bool is_optional = this->match(TokenType::QUESTION);
@@ -282,55 +332,55 @@ Token Parser::type() {
     if (this->match(TokenType::TYPE))
         return this->previous();
 
-    return this->consume(TokenType::IDENTIFIER, "Expected type.");
+    return this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_TYPE);
 }
 
-std::unique_ptr<StructDeclStmt> Parser::struct_decl() {
-    Token name = this->consume(TokenType::IDENTIFIER, "Expected struct name.");
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before function body.");
+NodePtr<StructDeclStmt> Parser::struct_decl() {
+    Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_STRUCT_NAME);
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_FUNCTION_BODY);
 
     std::vector<TypedVar> properties;
-    std::vector<std::unique_ptr<FunDeclStmt>> methods;
+    std::vector<NodePtr<FunDeclStmt>> methods;
 
     while (!this->check(TokenType::R_CURLY_BRACKET)) {
         if (this->match(TokenType::FN)) {
             methods.push_back(this->function_decl(FunType::METHOD));
         } else {
             properties.push_back(this->typed_identifier());
-            this->consume(TokenType::SEMI_COLON, "Expected ';' after property.");
+            this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_PROPERTY);
         }
     };
 
-    this->consume(TokenType::R_CURLY_BRACKET, "Expected '}' after struct body.");
+    this->consume(TokenType::R_CURLY_BRACKET, DiagnosticCode::EXPECTED_R_CURLY_AFTER_STRUCT_BODY);
 
-    return std::make_unique<StructDeclStmt>(name, properties, std::move(methods));
+    return this->arena.make<StructDeclStmt>(name, properties, this->arena.list(std::move(methods)));
 }
 
-std::unique_ptr<EnumDeclStmt> Parser::enum_decl() {
-    Token name = this->consume(TokenType::IDENTIFIER, "Expected enum name.");
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before function body.");
+NodePtr<EnumDeclStmt> Parser::enum_decl() {
+    Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_ENUM_NAME);
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_FUNCTION_BODY);
 
     std::vector<EnumVariant> variants;
-    std::vector<std::unique_ptr<EnumMethodDeclStmt>> methods;
+    std::vector<NodePtr<EnumMethodDeclStmt>> methods;
 
     while (!this->check(TokenType::R_CURLY_BRACKET)) {
         if (this->match(TokenType::FN)) {
             auto fun = this->function_decl(FunType::METHOD);
 
-            methods.push_back(std::make_unique<EnumMethodDeclStmt>(std::move(fun), name));
+            methods.push_back(this->arena.make<EnumMethodDeclStmt>(std::move(fun), name));
         } else {
             variants.push_back(this->enum_variant_decl());
-            this->consume(TokenType::SEMI_COLON, "Expected ';' after property.");
+            this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_PROPERTY);
         }
     };
 
-    this->consume(TokenType::R_CURLY_BRACKET, "Expected '}' after struct body.");
+    this->consume(TokenType::R_CURLY_BRACKET, DiagnosticCode::EXPECTED_R_CURLY_AFTER_STRUCT_BODY);
 
-    return std::make_unique<EnumDeclStmt>(name, variants, std::move(methods));
+    return this->arena.make<EnumDeclStmt>(name, variants, this->arena.list(std::move(methods)));
 }
 
 EnumVariant Parser::enum_variant_decl() {
-    Token name = this->consume(TokenType::IDENTIFIER, "Expected name for enum variant.");
+    Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_NAME_FOR_ENUM_VARIANT);
 
     std::optional<Token> type = std::nullopt;
     bool is_optional = false;
@@ -338,17 +388,17 @@ EnumVariant Parser::enum_variant_decl() {
         type = this->type();
         is_optional = this->match(TokenType::QUESTION);
 
-        this->consume(TokenType::R_BRACKET, "Expected ')' after variant payload.");
+        this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_R_BRACKET_AFTER_VARIANT_PAYLOAD);
     }
 
     return EnumVariant(name, type, is_optional);
 }
 
-std::unique_ptr<FunDeclStmt> Parser::function_decl(FunType fun_type) {
-    Token name = this->consume(TokenType::IDENTIFIER, "Expected function name.");
+NodePtr<FunDeclStmt> Parser::function_decl(FunType fun_type) {
+    Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_FUNCTION_NAME);
     std::vector<TypedVar> params;
 
-    this->consume(TokenType::L_BRACKET, "Expected '(' after function name.");
+    this->consume(TokenType::L_BRACKET, DiagnosticCode::EXPECTED_L_BRACKET_AFTER_FUNCTION_NAME);
     if (!this->check(TokenType::R_BRACKET)) {
         // Loop while there are commas
         // If there is a comma followed by a right bracket, it is a trailing comma
@@ -357,173 +407,145 @@ std::unique_ptr<FunDeclStmt> Parser::function_decl(FunType fun_type) {
         } while (this->match(TokenType::COMMA) && !this->check(TokenType::R_BRACKET));
     }
 
-    this->consume(TokenType::R_BRACKET, "Expected ')' after parameter list.");
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_R_BRACKET_AFTER_PARAMETER_LIST);
 
-    this->consume(TokenType::COLON, "Expected return type.");
+    this->consume(TokenType::COLON, DiagnosticCode::EXPECTED_RETURN_TYPE);
     Token return_type = this->type();
     bool return_type_optional = this->match(TokenType::QUESTION);
 
     // Main function must be type void
-    if (fun_type == FunType::FUNCTION && name.lexeme == "main") {
-        if (return_type.lexeme != "void") {
-            this->error(return_type, "Main function must have return type of 'void'.");
+    if (fun_type == FunType::FUNCTION && name.symbol == SYM_MAIN) {
+        if (return_type.symbol != SYM_VOID) {
+            this->error(return_type, DiagnosticCode::MAIN_MUST_RETURN_VOID);
             exit(2);
         }
     }
 
-    this->consume(TokenType::L_CURLY_BRACKET, "Expected '{' before function body.");
-    std::vector<std::unique_ptr<Stmt>> body = this->block();
+    this->consume(TokenType::L_CURLY_BRACKET, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_FUNCTION_BODY);
 
-    return std::make_unique<FunDeclStmt>(name, params, return_type, return_type_optional, std::move(body), fun_type);
-}
+    if (this->signatures_only) {
+        this->skip_block();
+        return this->arena.make<FunDeclStmt>(name, params, return_type, return_type_optional, this->arena.nodes<Stmt>(), fun_type);
+    }
 
-std::unique_ptr<VariableDeclStmt> Parser::variable_decl() {
-    TypedVar name = this->typed_identifier();
-    this->consume(TokenType::EQUAL, "Expected '=' after variable declaration.");
-    std::unique_ptr<Expr> expr = this->expression();
+    if (this->lazy_bodies) {
+        size_t body_start = this->current;
+        this->skip_block();
 
-    this->consume(TokenType::SEMI_COLON, "Expected ';' after variable declaration.");
+        auto fun = this->arena.make<FunDeclStmt>(name, params, return_type, return_type_optional, this->arena.nodes<Stmt>(), fun_type);
+        fun->defer_body(this, body_start);
+        return fun;
+    }
 
-    return std::make_unique<VariableDeclStmt>(name, std::move(expr));
-}
+    NodeList<Stmt> body = this->block();
 
-std::unique_ptr<Expr> Parser::expression() {
-    return this->logical_or();
+    return this->arena.make<FunDeclStmt>(name, params, return_type, return_type_optional, std::move(body), fun_type);
 }
 
-std::unique_ptr<Expr> Parser::logical_or() {
-    std::unique_ptr<Expr> expr = this->logical_and();
+NodePtr<VariableDeclStmt> Parser::variable_decl() {
+    TypedVar name = this->typed_identifier();
+    this->consume(TokenType::EQUAL, DiagnosticCode::EXPECTED_EQUAL_AFTER_VARIABLE_DECLARATION);
+    NodePtr<Expr> expr = this->expression();
 
-    while (this->match(TokenType::OR)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->logical_and();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
-    }
+    this->consume(TokenType::SEMI_COLON, DiagnosticCode::EXPECTED_SEMI_COLON_AFTER_VARIABLE_DECLARATION);
 
-    return expr;
+    return this->arena.make<VariableDeclStmt>(name, std::move(expr));
 }
 
-std::unique_ptr<Expr> Parser::logical_and() {
-    std::unique_ptr<Expr> expr = this->equality();
-
-    while (this->match(TokenType::AND)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->equality();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
+NodePtr<Expr> Parser::expression() {
+    // Every nested expression (brackets, arguments, payloads, etc.) comes back through here,
+    // so limiting the depth bounds how far the parser can recurse
+    if (this->expression_depth >= MAX_EXPRESSION_DEPTH) {
+        this->error(this->peek(), DiagnosticCode::EXPRESSION_NESTED_TOO_DEEPLY);
+        exit(2);
     }
 
-    return expr;
-}
-
-std::unique_ptr<Expr> Parser::equality() {
-    std::unique_ptr<Expr> expr = this->comparison();
-
-    if (this->match(TokenType::EQUAL_EQUAL) ||
-        this->match(TokenType::BANG_EQUAL)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->comparison();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
-    }
+    this->expression_depth++;
+    NodePtr<Expr> expr = this->binary(PREC_OR);
+    this->expression_depth--;
 
     return expr;
 }
 
-std::unique_ptr<Expr> Parser::comparison() {
-    std::unique_ptr<Expr> expr = this->term();
+// Parse a chain of binary operators that bind at least as tightly as `min_precedence`
+//
+// Operators of the same precedence are combined in a loop (left-associative), and only the right hand side
+// of a tighter operator recurses. Each recursion raises the minimum precedence, so the recursion is at most
+// one level deep per precedence level
+NodePtr<Expr> Parser::binary(Precedence min_precedence) {
+    NodePtr<Expr> expr = this->unary();
 
-    if (this->match(TokenType::LESS) || this->match(TokenType::LESS_EQUAL) ||
-        this->match(TokenType::GREATER) ||
-        this->match(TokenType::GREATER_EQUAL)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->term();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
-    }
+    // Non-associative operators lower this after they're used, so they can't be chained e.g. `a == b == c`
+    Precedence max_precedence = PREC_HIGHEST;
 
-    return expr;
-}
+    while (true) {
+        BinaryOperator op_info = binary_operator(this->peek().t);
+        if (op_info.precedence == PREC_NONE || op_info.precedence < min_precedence ||
+            op_info.precedence > max_precedence)
+            break;
 
-std::unique_ptr<Expr> Parser::term() {
-    std::unique_ptr<Expr> expr = this->factor();
+        Token op = this->advance();
+        NodePtr<Expr> rhs = this->binary(static_cast<Precedence>(op_info.precedence + 1));
+        expr = this->arena.make<BinaryExpr>(std::move(expr), op, std::move(rhs));
 
-    while (this->match(TokenType::PLUS) || this->match(TokenType::MINUS)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->factor();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
+        max_precedence = op_info.associative ? op_info.precedence : static_cast<Precedence>(op_info.precedence - 1);
     }
 
     return expr;
 }
 
-std::unique_ptr<Expr> Parser::factor() {
-    std::unique_ptr<Expr> expr = this->fallback();
+NodePtr<Expr> Parser::unary() {
+    // Collect prefix operators first, rather than recursing once per operator
+    std::vector<Token> ops;
+    while (this->match(TokenType::BANG) || this->match(TokenType::MINUS))
+        ops.push_back(this->previous());
 
-    while (this->match(TokenType::STAR) || this->match(TokenType::SLASH)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->fallback();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
-    }
+    NodePtr<Expr> expr = this->call();
 
-    return expr;
-}
-
-std::unique_ptr<Expr> Parser::fallback() {
-    std::unique_ptr<Expr> expr = this->unary();
-
-    if (this->match(TokenType::QUESTION_QUESTION)) {
-        Token op = this->previous();
-        std::unique_ptr<Expr> rhs = this->unary();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(rhs));
-    }
+    // Innermost operator is the one closest to the operand
+    for (auto op = ops.rbegin(); op != ops.rend(); op++)
+        expr = this->arena.make<UnaryExpr>(*op, std::move(expr));
 
     return expr;
 }
 
-std::unique_ptr<Expr> Parser::unary() {
-    if (this->match(TokenType::BANG) || this->match(TokenType::MINUS)) {
-        Token prev = this->previous();
-        return std::make_unique<UnaryExpr>(prev, this->unary());
-    }
-
-    return this->call();
-}
-
-std::unique_ptr<Expr> Parser::call() {
-    std::unique_ptr<Expr> expr = this->primary();
+NodePtr<Expr> Parser::call() {
+    NodePtr<Expr> expr = this->primary();
 
     while (true) {
         if (this->match(TokenType::L_BRACKET)) {
             expr = this->finish_call(std::move(expr));
         } else if (this->match(TokenType::COLON_COLON)) {
             // Enum variant
-            Token name = this->consume(TokenType::IDENTIFIER, "Expected variant name after '.'.");
+            Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_VARIANT_NAME_AFTER_DOT);
 
-            auto e = std::unique_ptr<VarExpr>(dynamic_cast<VarExpr *>(expr.release()));
+            auto e = NodePtr<VarExpr>(node_cast<VarExpr>(expr.release()));
             if (!e) {
                 std::cerr << "[BUG] tried to use variant on non-enum." << std::endl;
                 exit(3);
             }
 
-            std::optional<std::unique_ptr<Expr>> payload = std::nullopt;
+            std::optional<NodePtr<Expr>> payload = std::nullopt;
 
             // If variant has a payload
             if (this->match(TokenType::L_BRACKET)) {
                 auto inner = this->expression();
-                this->consume(TokenType::R_BRACKET, "Expected ')' after enum payload.");
+                this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_R_BRACKET_AFTER_ENUM_PAYLOAD);
                 payload = std::move(inner);
             }
 
-            expr = std::make_unique<EnumInitExpr>(
+            expr = this->arena.make<EnumInitExpr>(
                 name,
                 std::move(e),
                 std::move(payload));
         } else if (this->match(TokenType::DOT)) {
             // Property access
-            Token name = this->consume(TokenType::IDENTIFIER, "Expected property name after '.'.");
-            expr = std::make_unique<GetExpr>(std::move(expr), name, false);
+            Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_PROPERTY_NAME_AFTER_DOT);
+            expr = this->arena.make<GetExpr>(std::move(expr), name, false);
         } else if (this->match(TokenType::QUESTION_DOT)) {
             // Optional property access
-            Token name = this->consume(TokenType::IDENTIFIER, "Expected property name after '.'.");
-            expr = std::make_unique<GetExpr>(std::move(expr), name, true);
+            Token name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_PROPERTY_NAME_AFTER_DOT);
+            expr = this->arena.make<GetExpr>(std::move(expr), name, true);
         } else {
             break;
         }
@@ -532,9 +554,9 @@ std::unique_ptr<Expr> Parser::call() {
     return expr;
 }
 
-std::unique_ptr<Expr> Parser::finish_call(std::unique_ptr<Expr> callee) {
+NodePtr<Expr> Parser::finish_call(NodePtr<Expr> callee) {
     auto bracket = this->previous();
-    std::vector<std::unique_ptr<Expr>> args;
+    std::vector<NodePtr<Expr>> args;
 
     if (!this->check(TokenType::R_BRACKET)) {
         // Loop while there are commas
@@ -544,75 +566,101 @@ std::unique_ptr<Expr> Parser::finish_call(std::unique_ptr<Expr> callee) {
         } while (this->match(TokenType::COMMA) && !this->check(TokenType::R_BRACKET));
     }
 
-    this->consume(TokenType::R_BRACKET, "Expected ')' after arguments.");
+    this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_R_BRACKET_AFTER_ARGUMENTS);
 
-    return std::make_unique<CallExpr>(std::move(callee), std::move(args), bracket);
+    return this->arena.make<CallExpr>(std::move(callee), this->arena.list(std::move(args)), bracket);
 }
 
-std::unique_ptr<Expr> Parser::primary() {
+NodePtr<Expr> Parser::primary() {
     if (this->match(TokenType::IDENTIFIER)) {
         auto identifier = this->previous();
-        if (identifier.lexeme != "this" && this->match(TokenType::L_CURLY_BRACKET))
+        if (identifier.symbol != SYM_THIS && this->match(TokenType::L_CURLY_BRACKET))
             return this->finish_struct_init(identifier);
 
-        return std::make_unique<VarExpr>(identifier);
+        return this->arena.make<VarExpr>(identifier);
     }
 
     if (this->match(TokenType::TRUE) || this->match(TokenType::FALSE) ||
         this->match(TokenType::NULL_VAL) || this->match(TokenType::INT_VAL) ||
         this->match(TokenType::FLOAT_VAL) || this->match(TokenType::STR_VAL)) {
-        return std::make_unique<LiteralExpr>(this->previous());
+        return this->arena.make<LiteralExpr>(this->previous());
     }
 
     if (this->match(TokenType::L_BRACKET)) {
-        std::unique_ptr<Expr> expr = this->expression();
-        this->consume(TokenType::R_BRACKET, "Expected closing ')'.");
-        return std::make_unique<GroupingExpr>(std::move(expr));
+        NodePtr<Expr> expr = this->expression();
+        this->consume(TokenType::R_BRACKET, DiagnosticCode::EXPECTED_CLOSING_R_BRACKET);
+        return this->arena.make<GroupingExpr>(std::move(expr));
     }
 
-    this->error(this->peek(), "Expected expression.");
+    this->error(this->peek(), DiagnosticCode::EXPECTED_EXPRESSION);
     exit(2);
 }
 
-std::unique_ptr<Expr> Parser::finish_struct_init(Token name) {
-    std::vector<std::tuple<Token, std::unique_ptr<Expr>>> properties;
+NodePtr<Expr> Parser::finish_struct_init(Token name) {
+    std::vector<std::tuple<Token, NodePtr<Expr>>> properties;
 
     // Loop while there are commas
     // If there is a comma followed by a right bracket, it is a trailing comma
     do {
-        Token prop_name = this->consume(TokenType::IDENTIFIER, "Expected property name.");
-        this->consume(TokenType::COLON, "Expected property value.");
+        Token prop_name = this->consume(TokenType::IDENTIFIER, DiagnosticCode::EXPECTED_PROPERTY_NAME);
+        this->consume(TokenType::COLON, DiagnosticCode::EXPECTED_PROPERTY_VALUE);
 
-        std::unique_ptr<Expr> value = this->expression();
+        NodePtr<Expr> value = this->expression();
         properties.push_back(std::make_tuple(prop_name, std::move(value)));
     } while (this->match(TokenType::COMMA) && !this->check(TokenType::R_CURLY_BRACKET));
 
-    this->consume(TokenType::R_CURLY_BRACKET, "Expected '}' after struct initialisation.");
+    this->consume(TokenType::R_CURLY_BRACKET, DiagnosticCode::EXPECTED_R_CURLY_AFTER_STRUCT_INITIALISATION);
+
+    return this->arena.make<StructInitExpr>(name, this->arena.list(std::move(properties)));
+}
+
+// Make sure the token at index `i` exists, scanning up to it if tokens are pulled from a scanner
+// Returns false past the end of a pre-tokenized file
+bool Parser::scanned(size_t i) {
+    while (i >= this->tokens.size()) {
+        if (!this->scanner)
+            return false;
+
+        this->tokens.push_back(this->scanner->scan_token());
+    }
 
-    return std::make_unique<StructInitExpr>(name, std::move(properties));
+    return true;
+}
+
+// Forget the tokens of declarations that have already been parsed, so scanning a file doesn't keep all of it
+// Lazy bodies are parsed from their tokens later on, and tokenized files are kept whole anyway
+void Parser::drop_parsed_tokens() {
+    if (!this->scanner || this->lazy_bodies || this->current == 0)
+        return;
+
+    this->tokens.erase_front(this->current);
+    this->current = 0;
 }
 
 // Get next token
 Token Parser::advance() {
-    this->prev = this->current;
-    this->current = scanner->scan_token();
+    Token token = this->peek();
+
+    // Stay on the final EOF token rather than walking off the end of the tokens
+    if (this->scanned(this->current + 1))
+        this->current++;
 
-    return this->previous();
+    return token;
 }
 
 // Look at current token
 Token Parser::peek() {
-    return this->current;
+    return this->tokens.get(this->current);
 }
 
 // Look at previous token
 Token Parser::previous() {
-    if (!this->prev.has_value()) {
+    if (this->current == 0) {
         std::cerr << "[BUG] Expected previous token to exist." << std::endl;
         exit(3);
     }
 
-    return this->prev.value();
+    return this->tokens.get(this->current - 1);
 }
 
 // If current token is of the provided type, advance and return true. Else, return false
@@ -627,24 +675,23 @@ bool Parser::match(TokenType t) {
 
 // Return true if the current token matches the provided token type
 bool Parser::check(TokenType t) {
-    Token curr = this->peek();
-    return curr.t == t;
+    return this->tokens.type(this->current) == t;
 }
 
-// Expect the current token to be of type `t`, otherwise error and output the provided message
-Token Parser::consume(TokenType t, std::string error_message) {
+// Expect the current token to be of type `t`, otherwise error with the provided diagnostic
+Token Parser::consume(TokenType t, DiagnosticCode error_code) {
     if (this->check(t))
         return this->advance();
 
-    this->error(this->peek(), error_message);
+    this->error(this->peek(), error_code);
     exit(2);
 }
 
-// Error reporting with line number
-void Parser::error(Token error_token, std::string message) {
-    std::string where = "end";
-    if (error_token.t != TokenType::EOF_)
-        where = "'" + error_token.lexeme + "'";
+// Error reporting with line number, or throw it if the caller is handling errors itself
+void Parser::error(Token error_token, DiagnosticCode code, std::initializer_list<DiagnosticArg> args) {
+    Diagnostic diagnostic(DiagnosticStage::SYNTAX, code, error_token, args);
+    if (this->throw_errors)
+        throw ParserError{diagnostic};
 
-    std::cerr << "[line " << error_token.line << "] Syntax error at " << where << ": " << message << std::endl;
+    report(std::cerr, diagnostic);
 }
@@ -1,75 +1,119 @@
 #pragma once
 
+#include "../ast/ast_arena.h"
 #include "../ast/enum_variant.h"
 #include "../ast/expr.h"
 #include "../ast/stmt.h"
+#include "../diagnostics/diagnostic.h"
 #include "../scanner/scanner.h"
+#include "../scanner/token_buffer.h"
+#include "precedence.h"
 
 #include <memory>
 #include <optional>
 #include <string>
 
-class Parser {
+// Thrown instead of reporting a syntax error and exiting, when a `Parser` is asked to throw its errors
+struct ParserError {
+    Diagnostic diagnostic;
+};
+
+class Parser final : public BodyParser {
   private:
+    // Every node parsed is allocated in here
+    AstArena &arena;
+
+    TokenBuffer tokens;
+
+    // Index of the current token in `tokens`
+    size_t current;
+
+    // Only set when tokens are pulled from a scanner as they are needed, rather than tokenized up front
     std::unique_ptr<Scanner> scanner;
 
-    std::optional<Token> prev;
-    Token current;
+    // How many expressions are currently being parsed inside each other
+    size_t expression_depth;
+
+    bool throw_errors;
+
+    // Whether function bodies are skipped over, to be parsed when first asked for
+    bool lazy_bodies;
 
-    std::optional<std::unique_ptr<Stmt>> top_level_decl();
-    std::unique_ptr<Stmt> nested_decl();
+    // Whether function bodies are skipped over and left empty, never to be parsed
+    bool signatures_only;
 
-    std::unique_ptr<FunDeclStmt> function_decl(FunType fun_type);
-    std::unique_ptr<StructDeclStmt> struct_decl();
-    std::unique_ptr<EnumDeclStmt> enum_decl();
-    std::unique_ptr<VariableDeclStmt> variable_decl();
+    std::optional<NodePtr<Stmt>> top_level_decl();
+    NodePtr<Stmt> nested_decl();
+
+    NodePtr<FunDeclStmt> function_decl(FunType fun_type);
+    NodePtr<StructDeclStmt> struct_decl();
+    NodePtr<EnumDeclStmt> enum_decl();
+    NodePtr<VariableDeclStmt> variable_decl();
 
     // Statements
-    std::unique_ptr<Stmt> statement();
-    std::unique_ptr<Stmt> assignment(Expr &lhs);
-    std::unique_ptr<IfStmt> if_statement();
-    std::unique_ptr<MatchStmt> match_statement();
-    std::unique_ptr<ForStmt> for_statement();
-    std::unique_ptr<WhileStmt> while_statement();
-    std::unique_ptr<PrintStmt> print_statement();
-    std::unique_ptr<PanicStmt> panic_statement();
-    std::unique_ptr<ReturnStmt> return_statement();
+    NodePtr<Stmt> statement();
+    NodePtr<Stmt> assignment(Expr &lhs);
+    NodePtr<IfStmt> if_statement();
+    NodePtr<MatchStmt> match_statement();
+    NodePtr<ForStmt> for_statement();
+    NodePtr<WhileStmt> while_statement();
+    NodePtr<PrintStmt> print_statement();
+    NodePtr<PanicStmt> panic_statement();
+    NodePtr<ReturnStmt> return_statement();
 
     // Expressions
-    std::unique_ptr<Expr> expression();
-    std::unique_ptr<Expr> logical_or();
-    std::unique_ptr<Expr> logical_and();
-    std::unique_ptr<Expr> equality();
-    std::unique_ptr<Expr> comparison();
-    std::unique_ptr<Expr> term();
-    std::unique_ptr<Expr> factor();
-    std::unique_ptr<Expr> fallback();
-    std::unique_ptr<Expr> unary();
-    std::unique_ptr<Expr> call();
-    std::unique_ptr<Expr> primary();
-    std::unique_ptr<Expr> finish_call(std::unique_ptr<Expr> expr);
-    std::unique_ptr<Expr> finish_struct_init(Token name);
+    NodePtr<Expr> expression();
+    NodePtr<Expr> binary(Precedence min_precedence);
+    NodePtr<Expr> unary();
+    NodePtr<Expr> call();
+    NodePtr<Expr> primary();
+    NodePtr<Expr> finish_call(NodePtr<Expr> expr);
+    NodePtr<Expr> finish_struct_init(Token name);
 
     MatchPattern match_pattern();
 
-    std::vector<std::unique_ptr<Stmt>> block();
+    NodeList<Stmt> block();
+    void skip_block();
     TypedVar typed_identifier();
     EnumVariant enum_variant_decl();
     Token type();
 
     // Utility functions
+    bool scanned(size_t i);
+    void drop_parsed_tokens();
     Token advance();
     Token peek();
     Token previous();
 
     bool match(TokenType t);
     bool check(TokenType t);
-    Token consume(TokenType t, std::string error_message);
+    Token consume(TokenType t, DiagnosticCode error_code);
 
-    void error(Token error_token, std::string message);
+    void error(Token error_token, DiagnosticCode code, std::initializer_list<DiagnosticArg> args = {});
 
   public:
-    Parser(std::unique_ptr<Scanner> scanner);
+    // Deeper nesting is reported as a syntax error, rather than overflowing the stack
+    static const size_t MAX_EXPRESSION_DEPTH = 256;
+
+    // Parse an already tokenized file, which must end with an EOF token
+    Parser(TokenBuffer tokens, AstArena &arena, bool throw_errors = false);
+
+    // Adapter for any scanner, scanning each token the first time it is needed
+    // Tokens are dropped once the declaration they are in has been parsed, unless bodies are lazy
+    Parser(std::unique_ptr<Scanner> scanner, AstArena &arena, bool throw_errors = false);
+
+    std::optional<NodePtr<Stmt>> parse_stmt();
+
+    // Skip over function bodies by matching braces, only parsing each one when `FunDeclStmt::get_body` is first
+    // called. Syntax errors in a body aren't reported until then, and the parser must outlive the statements
+    void set_lazy_bodies(bool lazy);
+
+    NodeList<Stmt> parse_body(size_t start) override;
+
+    // Skip over function bodies by matching braces, leaving every body empty. Only the signatures are
+    // parsed, which is all the type environment needs. Syntax errors in a body aren't reported at all
+    void set_signatures_only(bool signatures_only);
 
-    std::optional<std::unique_ptr<Stmt>> parse_stmt();
+    // The token the next declaration starts at, or EOF if there are none left
+    Token next_token();
 };
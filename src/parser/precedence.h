@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../scanner/token.h"
+
+#include <array>
+#include <cstdint>
+
+// How tightly each binary operator binds, from loosest to tightest
+enum Precedence : uint8_t {
+    PREC_NONE, // Not a binary operator
+    PREC_OR,
+    PREC_AND,
+    PREC_EQUALITY,
+    PREC_COMPARISON,
+    PREC_TERM,
+    PREC_FACTOR,
+    PREC_FALLBACK,
+};
+
+// Binds tighter than every binary operator
+inline constexpr Precedence PREC_HIGHEST = PREC_FALLBACK;
+
+struct BinaryOperator {
+    Precedence precedence;
+
+    // Non-associative operators can't be chained without brackets e.g. `a == b == c` or `a ?? b ?? c`
+    bool associative;
+};
+
+constexpr std::array<BinaryOperator, TokenType::EOF_ + 1> make_binary_operators() {
+    std::array<BinaryOperator, TokenType::EOF_ + 1> table{};
+
+    table[TokenType::OR] = {PREC_OR, true};
+    table[TokenType::AND] = {PREC_AND, true};
+
+    table[TokenType::EQUAL_EQUAL] = {PREC_EQUALITY, false};
+    table[TokenType::BANG_EQUAL] = {PREC_EQUALITY, false};
+
+    table[TokenType::LESS] = {PREC_COMPARISON, false};
+    table[TokenType::LESS_EQUAL] = {PREC_COMPARISON, false};
+    table[TokenType::GREATER] = {PREC_COMPARISON, false};
+    table[TokenType::GREATER_EQUAL] = {PREC_COMPARISON, false};
+
+    table[TokenType::PLUS] = {PREC_TERM, true};
+    table[TokenType::MINUS] = {PREC_TERM, true};
+
+    table[TokenType::STAR] = {PREC_FACTOR, true};
+    table[TokenType::SLASH] = {PREC_FACTOR, true};
+
+    table[TokenType::QUESTION_QUESTION] = {PREC_FALLBACK, false};
+
+    return table;
+}
+
+inline constexpr std::array<BinaryOperator, TokenType::EOF_ + 1> BINARY_OPERATORS = make_binary_operators();
+
+constexpr BinaryOperator binary_operator(TokenType t) {
+    return BINARY_OPERATORS[t];
+}
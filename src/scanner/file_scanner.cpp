@@ -0,0 +1,155 @@
+#include "file_scanner.h"
+#include "simd_scan.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <ostream>
+#include <unistd.h>
+
+FileScanner::FileScanner(int fd, size_t chunk_size, bool throw_errors)
+    : fd(fd), chunk_size(chunk_size), reached_eof(false), throw_errors(throw_errors), buffer(chunk_size), token_start(0), current(0), filled(0), line(1),
+      symbols(SymbolTable::global()) {}
+
+// Make a token from the current token at the current line
+Token FileScanner::make_token(TokenType t) {
+    return this->make_token(t, this->line);
+}
+
+// Make a token from the current token, copying the lexeme out of the buffer before it is overwritten
+Token FileScanner::make_token(TokenType t, long line) {
+    return Token{t, this->lexemes.store(this->lexeme()), line};
+}
+
+bool FileScanner::refill() {
+    if (this->reached_eof)
+        return false;
+
+    // Keep the token in progress, moving it to the front of the buffer
+    size_t keep = this->filled - this->token_start;
+    if (this->token_start > 0) {
+        std::memmove(this->buffer.data(), this->buffer.data() + this->token_start, keep);
+        this->current -= this->token_start;
+        this->token_start = 0;
+        this->filled = keep;
+    }
+
+    // Only grows when a token is longer than the space left in the buffer
+    if (this->buffer.size() < keep + this->chunk_size)
+        this->buffer.resize(keep + this->chunk_size);
+
+    while (true) {
+        ssize_t n = read(this->fd, this->buffer.data() + this->filled, this->chunk_size);
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0)
+            this->error(std::string("Failed to read source: ") + std::strerror(errno));
+
+        if (n == 0) {
+            this->reached_eof = true;
+            return false;
+        }
+
+        this->filled += n;
+        return true;
+    }
+}
+
+bool FileScanner::ensure(size_t count) {
+    while (this->filled - this->current < count) {
+        if (!this->refill())
+            return false;
+    }
+
+    return true;
+}
+
+void FileScanner::start_token() {
+    this->token_start = this->current;
+}
+
+std::string_view FileScanner::lexeme() {
+    return std::string_view(this->buffer.data() + this->token_start, this->current - this->token_start);
+}
+
+void FileScanner::skip_identifier_chars() {
+    do {
+        const char *data = this->buffer.data();
+        this->current = ::skip_identifier_chars(data + this->current, data + this->filled) - data;
+    } while (this->current == this->filled && this->refill());
+}
+
+// Whitespace is never part of a token, so the token start follows it and refilling drops it
+void FileScanner::skip_whitespace_chars() {
+    do {
+        const char *data = this->buffer.data();
+        this->current = skip_whitespace_run(data + this->current, data + this->filled, this->line) - data;
+        this->token_start = this->current;
+    } while (this->current == this->filled && this->refill());
+}
+
+// Unless it is kept, what is skipped (e.g. a comment) is dropped as the buffer is refilled
+void FileScanner::skip_to(char c, bool keep) {
+    do {
+        const char *data = this->buffer.data();
+        this->current = find_char_counting_lines(data + this->current, data + this->filled, c, this->line) - data;
+        if (!keep)
+            this->token_start = this->current;
+    } while (this->current == this->filled && this->refill());
+}
+
+bool FileScanner::has_chars(size_t count) {
+    return this->ensure(count);
+}
+
+// If the current character matches the provided one, advance and return true. Else, return false
+bool FileScanner::match(char c) {
+    if (this->peek() == c) {
+        this->current++;
+        return true;
+    }
+
+    return false;
+}
+
+// Move to the next character, and return it
+char FileScanner::advance() {
+    char current = this->peek();
+    this->current++;
+
+    return current;
+}
+
+// Look at the current character, or '\0' at the end of the file
+char FileScanner::peek() {
+    if (!this->ensure(1))
+        return '\0';
+
+    return this->buffer[this->current];
+}
+
+// Look at the next character, or '\0' past the end of the file
+char FileScanner::peek_next() {
+    if (!this->ensure(2))
+        return '\0';
+
+    return this->buffer[this->current + 1];
+}
+
+bool FileScanner::is_at_end() {
+    return !this->ensure(1);
+}
+
+// Report a scanning error and exit, or throw it if the caller is collecting errors
+void FileScanner::error(std::string message) {
+    if (this->throw_errors)
+        throw ScannerError{message};
+
+    std::cerr << message << std::endl;
+    exit(1);
+}
+
+Token FileScanner::scan_token() {
+    return this->scan();
+}
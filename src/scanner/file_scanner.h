@@ -0,0 +1,72 @@
+#pragma once
+
+#include "lexeme_pool.h"
+#include "scanner.h"
+#include "token.h"
+
+#include <vector>
+
+// Scans tokens from a file descriptor (e.g. a pipe or stdin), reading it in fixed size chunks
+// so the whole source never has to be in memory at once
+//
+// The buffer only ever holds the current chunk plus the token being scanned, so memory is bounded by
+// the chunk size plus the longest token. Lexemes are copied into a pool owned by the scanner, so tokens
+// stay valid after the chunk they were scanned from has been dropped
+class FileScanner final : public Scanner, private ScannerRules<FileScanner> {
+  private:
+    friend class ScannerRules<FileScanner>;
+
+    int fd;
+    size_t chunk_size;
+    bool reached_eof;
+    bool throw_errors;
+
+    std::vector<char> buffer;
+
+    // Offsets into `buffer`
+    size_t token_start;
+    size_t current;
+    size_t filled;
+
+    long line;
+
+    LexemePool lexemes;
+    SymbolTable &symbols;
+
+    Token make_token(TokenType t);
+    Token make_token(TokenType t, long line);
+
+    // Reading the source, for the rules shared with other scanners
+    // Runs may carry on into the next chunk, so each is skipped a chunk at a time
+    void start_token();
+    std::string_view lexeme();
+    void skip_identifier_chars();
+    void skip_whitespace_chars();
+    void skip_to(char c, bool keep);
+    bool has_chars(size_t count);
+
+    // Drop everything before the start of the current token and read the next chunk
+    // Returns false if there is nothing left to read
+    bool refill();
+
+    // Make sure at least `count` characters are buffered after the current one, if the file has that many
+    bool ensure(size_t count);
+
+    // Utility functions
+    bool match(char c);
+    char advance();
+    char peek();
+    char peek_next();
+
+    bool is_at_end();
+
+    void error(std::string message);
+
+  public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    // NOTE: does not take ownership of `fd`
+    FileScanner(int fd, size_t chunk_size = DEFAULT_CHUNK_SIZE, bool throw_errors = false);
+
+    Token scan_token() override;
+};
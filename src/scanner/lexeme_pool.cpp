@@ -0,0 +1,43 @@
+#include "lexeme_pool.h"
+
+#include <cstring>
+
+const size_t LEXEME_BLOCK_SIZE = 64 * 1024;
+
+LexemePool::LexemePool() : block_used(0), block_size(0) {}
+
+std::string_view LexemePool::copy(std::string_view lexeme) {
+    if (lexeme.empty())
+        return std::string_view();
+
+    // Lexemes larger than a block get a block to themselves
+    if (lexeme.length() > LEXEME_BLOCK_SIZE) {
+        auto &block = this->large_blocks.emplace_back(new char[lexeme.length()]);
+        std::memcpy(block.get(), lexeme.data(), lexeme.length());
+
+        return std::string_view(block.get(), lexeme.length());
+    }
+
+    if (this->block_size - this->block_used < lexeme.length()) {
+        this->blocks.emplace_back(new char[LEXEME_BLOCK_SIZE]);
+        this->block_used = 0;
+        this->block_size = LEXEME_BLOCK_SIZE;
+    }
+
+    char *dest = this->blocks.back().get() + this->block_used;
+    std::memcpy(dest, lexeme.data(), lexeme.length());
+    this->block_used += lexeme.length();
+
+    return std::string_view(dest, lexeme.length());
+}
+
+std::string_view LexemePool::store(std::string_view lexeme) {
+    auto existing = this->lexemes.find(lexeme);
+    if (existing != this->lexemes.end())
+        return *existing;
+
+    std::string_view stored = this->copy(lexeme);
+    this->lexemes.insert(stored);
+
+    return stored;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Owns copies of lexemes so tokens can point at them after the text they were scanned from is gone
+// Identical lexemes are only stored once
+class LexemePool {
+  private:
+    std::unordered_set<std::string_view> lexemes;
+
+    // Text is copied into large blocks which are never moved or freed until the pool is destroyed
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<std::unique_ptr<char[]>> large_blocks;
+    size_t block_used;
+    size_t block_size;
+
+    std::string_view copy(std::string_view lexeme);
+
+  public:
+    LexemePool();
+
+    // Returns an equal string view that lives as long as the pool
+    std::string_view store(std::string_view lexeme);
+};
@@ -0,0 +1,146 @@
+#include "parallel_tokenizer.h"
+#include "scanner.h"
+#include "simd_scan.h"
+#include "symbol_table.h"
+
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <thread>
+
+std::vector<size_t> find_split_points(std::string_view source, size_t chunk_count) {
+    std::vector<size_t> splits;
+    if (chunk_count <= 1)
+        return splits;
+
+    const char *begin = source.data();
+    const char *end = begin + source.length();
+    const char *p = begin;
+
+    size_t chunk_size = source.length() / chunk_count;
+    const char *target = begin + chunk_size;
+
+    // Only tracks what the scanner does with strings and comments - everything else is just code
+    while (p < end && splits.size() + 1 < chunk_count) {
+        const char *special = find_either_char(p, end, '"', '/');
+
+        // Any newline before the next string or comment is safe to split after
+        while (target < special) {
+            const char *from = target > p ? target : p;
+            auto newline = static_cast<const char *>(std::memchr(from, '\n', special - from));
+            if (newline == nullptr)
+                break;
+
+            splits.push_back(newline + 1 - begin);
+            if (splits.size() + 1 == chunk_count)
+                return splits;
+
+            target = newline + 1 + chunk_size;
+        }
+
+        if (special == end)
+            break;
+
+        if (*special == '"') {
+            // Strings end at the next quote
+            const char *closing = static_cast<const char *>(std::memchr(special + 1, '"', end - special - 1));
+            if (closing == nullptr)
+                break;
+
+            p = closing + 1;
+        } else if (special + 1 < end && special[1] == '/') {
+            // Single line comments end at the newline, which is itself safe to split after
+            auto newline = static_cast<const char *>(std::memchr(special + 2, '\n', end - special - 2));
+            if (newline == nullptr)
+                break;
+
+            p = newline;
+        } else if (special + 1 < end && special[1] == '*') {
+            // Multiline comments end at the first `*/`, which can share the `*` of the opening `/*`
+            const char *star = special + 1;
+            while (true) {
+                star = static_cast<const char *>(std::memchr(star, '*', end - star));
+                if (star == nullptr || end - star < 2 || star[1] == '/')
+                    break;
+
+                star++;
+            }
+
+            if (star == nullptr || end - star < 2)
+                break;
+
+            p = star + 2;
+        } else {
+            // Division
+            p = special + 1;
+        }
+    }
+
+    return splits;
+}
+
+TokenBuffer tokenize_parallel(std::string_view source, size_t chunk_count) {
+    std::vector<size_t> splits = find_split_points(source, chunk_count);
+    splits.push_back(source.length());
+
+    std::vector<TokenBuffer> chunk_tokens(splits.size());
+    std::vector<std::optional<std::string>> chunk_errors(splits.size());
+
+    // The global symbol table isn't thread safe, so each chunk interns into its own, which are merged afterwards
+    std::vector<SymbolTable> chunk_symbols(splits.size());
+
+    std::vector<std::thread> workers;
+    size_t chunk_start = 0;
+    for (size_t i = 0; i < splits.size(); i++) {
+        std::string_view chunk = source.substr(chunk_start, splits[i] - chunk_start);
+        chunk_start = splits[i];
+
+        workers.emplace_back([chunk, i, &chunk_tokens, &chunk_errors, &chunk_symbols]() {
+            try {
+                // Each chunk starts at line 1, and is corrected when stitched back together
+                StringScanner scan = StringScanner(chunk, chunk_symbols[i], true);
+                chunk_tokens[i] = TokenBuffer::tokenize(scan, chunk.length() / 4);
+            } catch (ScannerError e) {
+                chunk_errors[i] = e.message;
+            }
+        });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    for (size_t i = 0; i < chunk_errors.size(); i++) {
+        // Scanning serially would have stopped at the first error
+        if (chunk_errors[i].has_value()) {
+            std::cerr << chunk_errors[i].value() << std::endl;
+            exit(1);
+        }
+    }
+
+    size_t total = 0;
+    for (auto &chunk : chunk_tokens)
+        total += chunk.size();
+
+    // Interning each chunk's symbols in order gives the same IDs as scanning serially
+    std::vector<std::vector<Symbol>> symbol_remaps(chunk_symbols.size());
+    for (size_t i = 0; i < chunk_symbols.size(); i++) {
+        for (Symbol symbol = 0; symbol < chunk_symbols[i].size(); symbol++)
+            symbol_remaps[i].push_back(SymbolTable::global().intern(chunk_symbols[i].name(symbol)));
+    }
+
+    // The first chunk's lines are already right, so the rest are added on to it
+    TokenBuffer tokens = std::move(chunk_tokens[0]);
+    tokens.remap_symbols(symbol_remaps[0]);
+    tokens.reserve(total);
+
+    // Every chunk ends with an EOF token on its last line, so the lines before each chunk can be counted from them
+    for (size_t i = 1; i < chunk_tokens.size(); i++) {
+        long line_offset = tokens.get(tokens.size() - 1).line - 1;
+
+        tokens.pop_back();
+        tokens.append(chunk_tokens[i], line_offset, symbol_remaps[i]);
+    }
+
+    return tokens;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "token_buffer.h"
+
+#include <string_view>
+#include <vector>
+
+// Find up to `chunk_count - 1` places to split `source` so each chunk can be scanned on its own
+// Each split is just after a newline that is outside any string or comment, as close as possible to
+// evenly spaced. Returns the offsets of the splits, which may be fewer than asked for
+std::vector<size_t> find_split_points(std::string_view source, size_t chunk_count);
+
+// Tokenize `source` split into `chunk_count` chunks, each scanned on its own thread
+// The result is identical to tokenizing serially, including which scanning error is reported
+TokenBuffer tokenize_parallel(std::string_view source, size_t chunk_count);
@@ -1,78 +1,16 @@
 #pragma once
 
+#include "scanner_rules.h"
+#include "scanner_tables.h"
+#include "symbol_table.h"
 #include "token.h"
 
-#include <map>
 #include <optional>
+#include <string>
 
-struct EqualSymbol {
-    TokenType single;
-    TokenType with_equal;
-};
-
-// All keywords and associated token type
-const std::map<std::string, TokenType> KEYWORDS = {
-    {"interface", TokenType::INTERFACE},
-    {"struct", TokenType::STRUCT},
-    {"enum", TokenType::ENUM},
-    {"fn", TokenType::FN},
-    {"return", TokenType::RETURN},
-
-    {"print", TokenType::PRINT},
-    {"println", TokenType::PRINT},
-
-    {"panic", TokenType::PANIC},
-
-    {"let", TokenType::LET},
-    {"match", TokenType::MATCH},
-    {"if", TokenType::IF},
-    {"else", TokenType::ELSE},
-
-    {"while", TokenType::WHILE},
-    {"for", TokenType::FOR},
-
-    {"void", TokenType::TYPE},
-    {"int", TokenType::TYPE},
-    {"float", TokenType::TYPE},
-    {"str", TokenType::TYPE},
-    {"bool", TokenType::TYPE},
-
-    {"true", TokenType::TRUE},
-    {"false", TokenType::FALSE},
-    {"null", TokenType::NULL_VAL},
-};
-
-// All symbols that can be singular or have an equal after them e.g. `!=`
-const std::map<char, EqualSymbol> EQUAL_SYMBOLS = {
-    {'=', EqualSymbol{TokenType::EQUAL, TokenType::EQUAL_EQUAL}},
-    {'!', EqualSymbol{TokenType::BANG, TokenType::BANG_EQUAL}},
-    {'<', EqualSymbol{TokenType::LESS, TokenType::LESS_EQUAL}},
-    {'>', EqualSymbol{TokenType::GREATER, TokenType::GREATER_EQUAL}},
-};
-
-// All symbols that are repeated twice e.g. "&&", "||"
-const std::map<char, TokenType> DOUBLE_SYMBOLS = {
-    {'&', TokenType::AND},
-    {'|', TokenType::OR},
-    {'?', TokenType::QUESTION_QUESTION},
-    {':', TokenType::COLON_COLON},
-};
-
-// All symbols that are only singular
-const std::map<char, TokenType> SYMBOLS = {
-    {'{', TokenType::L_CURLY_BRACKET},
-    {'}', TokenType::R_CURLY_BRACKET},
-    {'(', TokenType::L_BRACKET},
-    {')', TokenType::R_BRACKET},
-    {';', TokenType::SEMI_COLON},
-    {':', TokenType::COLON},
-    {',', TokenType::COMMA},
-    {'?', TokenType::QUESTION},
-    {'.', TokenType::DOT},
-    {'+', TokenType::PLUS},
-    {'-', TokenType::MINUS},
-    {'*', TokenType::STAR},
-    {'/', TokenType::SLASH},
+// Thrown instead of exiting when a scanner is asked to throw its errors
+struct ScannerError {
+    std::string message;
 };
 
 class Scanner {
@@ -81,28 +19,28 @@ class Scanner {
     virtual ~Scanner() = default;
 };
 
-class StringScanner : public Scanner {
+class StringScanner final : public Scanner, private ScannerRules<StringScanner> {
   private:
+    friend class ScannerRules<StringScanner>;
+
     const char *token_start;
     const char *current;
     const char *end;
     long line;
+    bool throw_errors;
 
-    Token make_token(TokenType t);
-    Token make_token(TokenType t, std::string lexeme);
-    Token make_token(TokenType t, std::string lexeme, long line);
-
-    // If token is a keyword, return the keyword type,
-    // otherwise it is an identifier
-    Token identifier_or_keyword();
-    Token number();
-    Token string();
+    SymbolTable &symbols;
 
-    // Returns TokenType of keyword if the current token is one
-    std::optional<TokenType> get_keyword_type();
+    Token make_token(TokenType t);
+    Token make_token(TokenType t, long line);
 
-    Token symbol(char start);
-    void skip_whitespace();
+    // Reading the source, for the rules shared with other scanners
+    void start_token();
+    std::string_view lexeme();
+    void skip_identifier_chars();
+    void skip_whitespace_chars();
+    void skip_to(char c, bool keep);
+    bool has_chars(size_t count);
 
     // Utility functions
     bool match(char c);
@@ -112,8 +50,12 @@ class StringScanner : public Scanner {
 
     bool is_at_end();
 
+    void error(std::string message);
+
   public:
-    StringScanner(std::string &source);
+    // NOTE: tokens point into `source`, so it must outlive the scanner and all tokens produced
+    // `line` is the line `source` starts on, for when it is part of a larger file
+    StringScanner(std::string_view source, SymbolTable &symbols = SymbolTable::global(), bool throw_errors = false, long line = 1);
 
     Token scan_token() override;
 };
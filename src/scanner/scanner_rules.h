@@ -0,0 +1,161 @@
+#pragma once
+
+#include "scanner_tables.h"
+#include "symbol_table.h"
+#include "token.h"
+
+#include <string>
+#include <string_view>
+
+// How Baz source is split into tokens, shared by every scanner so they can't disagree
+//
+// Each scanner only decides how its source is read, and `Source` must provide:
+//  - `peek`, `peek_next`, `advance`, `match` and `is_at_end`, which look at characters one at a time
+//  - `has_chars(count)`, whether at least `count` characters are left
+//  - `start_token` and `lexeme`, which mark where the token being scanned starts and give what it has so far
+//  - `skip_identifier_chars` and `skip_whitespace_chars`, which skip whole runs at once
+//  - `skip_to(c, keep)`, which skips up to the next `c` counting lines, keeping what it skips in the token if `keep`
+//  - `make_token(type)` and `make_token(type, line)`, from the token so far
+//  - `error(message)`, which reports a scanning error and doesn't return
+//  - `line` and `symbols` members, for the current line and where identifiers are interned
+template <typename Source>
+class ScannerRules {
+  private:
+    Source &source() {
+        return static_cast<Source &>(*this);
+    }
+
+    Token number() {
+        Source &s = this->source();
+        TokenType type = TokenType::INT_VAL;
+
+        // Consume digits - we already know we've got an initial one
+        while (is_digit(s.peek()))
+            s.advance();
+
+        // If reach a `.`, include it and continue matching digits
+        // We know it is a float at this point
+        if (s.match('.')) {
+            type = TokenType::FLOAT_VAL;
+            while (is_digit(s.peek()))
+                s.advance();
+        }
+
+        Token token = s.make_token(type);
+        // Check that next token isn't alpha (i.e. we don't want "1234a")
+        if (is_alpha(s.peek())) {
+            s.error("Unexpected character in number: '" + std::string(token.lexeme) + s.peek() + "'");
+        }
+
+        return token;
+    }
+
+    // If token is a keyword, return the keyword type,
+    // otherwise it is an identifier
+    Token identifier_or_keyword() {
+        Source &s = this->source();
+
+        // Consume alphanumeric - we've already consumed alpha
+        s.skip_identifier_chars();
+        TokenType type = lookup_keyword(s.lexeme()).value_or(TokenType::IDENTIFIER);
+
+        Token token = s.make_token(type);
+        if (type == TokenType::IDENTIFIER || type == TokenType::TYPE)
+            token.symbol = s.symbols.intern(token.lexeme);
+
+        return token;
+    }
+
+    Token symbol(char start) {
+        Source &s = this->source();
+        const SymbolEntry &entry = SYMBOL_TABLE[static_cast<uint8_t>(start)];
+
+        if (entry.has_equal && s.match('='))
+            return s.make_token(entry.with_equal);
+
+        if (entry.has_double && s.match(start))
+            return s.make_token(entry.doubled);
+
+        if (!entry.has_single) {
+            s.error(std::string("Unrecognised symbol: '") + start + "'");
+        }
+
+        // `?.` syntax
+        if (entry.single == TokenType::QUESTION && s.match('.')) {
+            return s.make_token(TokenType::QUESTION_DOT);
+        }
+
+        return s.make_token(entry.single);
+    }
+
+    void skip_whitespace() {
+        Source &s = this->source();
+
+        // Consume all whitespace and comments, updating line number where necessary
+        while (true) {
+            s.skip_whitespace_chars();
+
+            if (s.is_at_end() || s.peek() != '/')
+                return;
+
+            char next = s.peek_next();
+            if (next == '/') {
+                // Skip single line comments - the newline is consumed as whitespace
+                s.skip_to('\n', false);
+            } else if (next == '*') {
+                // Skip multiline comments, looking for a `*` followed by a `/` (starting from the opening `*`)
+                s.advance();
+                while (true) {
+                    s.skip_to('*', false);
+                    if (!s.has_chars(2)) {
+                        s.error("Unterminated multiline comment.");
+                    }
+
+                    s.advance();
+                    if (s.match('/'))
+                        break;
+                }
+            } else {
+                return;
+            }
+        }
+    }
+
+    // Scan a quoted string
+    Token string() {
+        Source &s = this->source();
+        long start_line = s.line;
+
+        // Remember to increase line number if multiline string
+        s.skip_to('"', true);
+
+        if (s.is_at_end()) {
+            s.error("Unterminated string");
+        }
+
+        s.advance();
+
+        return s.make_token(TokenType::STR_VAL, start_line);
+    }
+
+  protected:
+    Token scan() {
+        Source &s = this->source();
+        this->skip_whitespace();
+
+        if (s.is_at_end())
+            return Token{TokenType::EOF_, "", s.line};
+
+        s.start_token();
+
+        char c = s.advance();
+        if (is_digit(c))
+            return this->number();
+        if (is_alpha(c))
+            return this->identifier_or_keyword();
+        if (c == '"')
+            return this->string();
+
+        return this->symbol(c);
+    }
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "token.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+//// Character classes
+
+enum CharClass : uint8_t {
+    CHAR_ALPHA = 1 << 0,      // a-z, A-Z, _
+    CHAR_DIGIT = 1 << 1,      // 0-9
+    CHAR_WHITESPACE = 1 << 2, // space, tab, carriage return, newline
+    CHAR_NEWLINE = 1 << 3,
+};
+
+constexpr std::array<uint8_t, 256> make_char_classes() {
+    std::array<uint8_t, 256> classes{};
+
+    for (int c = 'a'; c <= 'z'; c++)
+        classes[c] |= CHAR_ALPHA;
+    for (int c = 'A'; c <= 'Z'; c++)
+        classes[c] |= CHAR_ALPHA;
+    classes['_'] |= CHAR_ALPHA;
+
+    for (int c = '0'; c <= '9'; c++)
+        classes[c] |= CHAR_DIGIT;
+
+    classes[' '] |= CHAR_WHITESPACE;
+    classes['\t'] |= CHAR_WHITESPACE;
+    classes['\r'] |= CHAR_WHITESPACE;
+    classes['\n'] |= CHAR_WHITESPACE | CHAR_NEWLINE;
+
+    return classes;
+}
+
+inline constexpr std::array<uint8_t, 256> CHAR_CLASSES = make_char_classes();
+
+constexpr bool has_class(char c, uint8_t char_class) {
+    return CHAR_CLASSES[static_cast<uint8_t>(c)] & char_class;
+}
+
+constexpr bool is_alpha(char c) { return has_class(c, CHAR_ALPHA); }
+constexpr bool is_digit(char c) { return has_class(c, CHAR_DIGIT); }
+constexpr bool is_alphanum(char c) { return has_class(c, CHAR_ALPHA | CHAR_DIGIT); }
+
+//// Symbols
+
+// How a symbol character can start a token. Each form is only valid if its flag is set
+struct SymbolEntry {
+    // e.g. `(`, `<`, `?`
+    bool has_single;
+    TokenType single;
+
+    // Symbols that can have an equal after them e.g. `<=`, `!=`
+    bool has_equal;
+    TokenType with_equal;
+
+    // Symbols that are repeated twice e.g. "&&", "||"
+    bool has_double;
+    TokenType doubled;
+};
+
+constexpr std::array<SymbolEntry, 256> make_symbol_table() {
+    std::array<SymbolEntry, 256> table{};
+
+    // All symbols that can be singular
+    struct {
+        char c;
+        TokenType t;
+    } singles[] = {
+        {'{', TokenType::L_CURLY_BRACKET},
+        {'}', TokenType::R_CURLY_BRACKET},
+        {'(', TokenType::L_BRACKET},
+        {')', TokenType::R_BRACKET},
+        {';', TokenType::SEMI_COLON},
+        {':', TokenType::COLON},
+        {',', TokenType::COMMA},
+        {'?', TokenType::QUESTION},
+        {'.', TokenType::DOT},
+        {'+', TokenType::PLUS},
+        {'-', TokenType::MINUS},
+        {'*', TokenType::STAR},
+        {'/', TokenType::SLASH},
+        {'=', TokenType::EQUAL},
+        {'!', TokenType::BANG},
+        {'<', TokenType::LESS},
+        {'>', TokenType::GREATER},
+    };
+
+    for (auto s : singles) {
+        table[static_cast<uint8_t>(s.c)].has_single = true;
+        table[static_cast<uint8_t>(s.c)].single = s.t;
+    }
+
+    // All symbols that can have an equal after them
+    struct {
+        char c;
+        TokenType t;
+    } equals[] = {
+        {'=', TokenType::EQUAL_EQUAL},
+        {'!', TokenType::BANG_EQUAL},
+        {'<', TokenType::LESS_EQUAL},
+        {'>', TokenType::GREATER_EQUAL},
+    };
+
+    for (auto s : equals) {
+        table[static_cast<uint8_t>(s.c)].has_equal = true;
+        table[static_cast<uint8_t>(s.c)].with_equal = s.t;
+    }
+
+    // All symbols that can be repeated twice
+    struct {
+        char c;
+        TokenType t;
+    } doubles[] = {
+        {'&', TokenType::AND},
+        {'|', TokenType::OR},
+        {'?', TokenType::QUESTION_QUESTION},
+        {':', TokenType::COLON_COLON},
+    };
+
+    for (auto s : doubles) {
+        table[static_cast<uint8_t>(s.c)].has_double = true;
+        table[static_cast<uint8_t>(s.c)].doubled = s.t;
+    }
+
+    return table;
+}
+
+inline constexpr std::array<SymbolEntry, 256> SYMBOL_TABLE = make_symbol_table();
+
+//// Keywords
+
+struct Keyword {
+    std::string_view word;
+    TokenType t;
+};
+
+// All keywords and associated token type
+inline constexpr Keyword KEYWORDS[] = {
+    {"interface", TokenType::INTERFACE},
+    {"struct", TokenType::STRUCT},
+    {"enum", TokenType::ENUM},
+    {"fn", TokenType::FN},
+    {"return", TokenType::RETURN},
+
+    {"print", TokenType::PRINT},
+    {"println", TokenType::PRINT},
+
+    {"panic", TokenType::PANIC},
+
+    {"let", TokenType::LET},
+    {"match", TokenType::MATCH},
+    {"if", TokenType::IF},
+    {"else", TokenType::ELSE},
+
+    {"while", TokenType::WHILE},
+    {"for", TokenType::FOR},
+
+    {"void", TokenType::TYPE},
+    {"int", TokenType::TYPE},
+    {"float", TokenType::TYPE},
+    {"str", TokenType::TYPE},
+    {"bool", TokenType::TYPE},
+
+    {"true", TokenType::TRUE},
+    {"false", TokenType::FALSE},
+    {"null", TokenType::NULL_VAL},
+};
+
+inline constexpr size_t KEYWORD_TABLE_SIZE = 64;
+
+// Perfect hash over the keywords above - only looks at the first character, last character and length
+constexpr size_t keyword_hash(std::string_view word) {
+    return (static_cast<uint8_t>(word.front()) + static_cast<uint8_t>(word.back()) * 7 + word.length() * 7) & (KEYWORD_TABLE_SIZE - 1);
+}
+
+// Table indexed by `keyword_hash`. Empty slots have an empty word
+constexpr std::array<Keyword, KEYWORD_TABLE_SIZE> make_keyword_table() {
+    std::array<Keyword, KEYWORD_TABLE_SIZE> table{};
+    for (auto keyword : KEYWORDS)
+        table[keyword_hash(keyword.word)] = keyword;
+
+    return table;
+}
+
+inline constexpr std::array<Keyword, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = make_keyword_table();
+
+constexpr bool keyword_hash_is_perfect() {
+    for (auto keyword : KEYWORDS) {
+        if (KEYWORD_TABLE[keyword_hash(keyword.word)].word != keyword.word)
+            return false;
+    }
+
+    return true;
+}
+
+static_assert(keyword_hash_is_perfect(), "Keyword hash has collisions - update `keyword_hash`");
+
+// Returns TokenType of keyword if the word is one
+constexpr std::optional<TokenType> lookup_keyword(std::string_view word) {
+    const Keyword &keyword = KEYWORD_TABLE[keyword_hash(word)];
+    if (keyword.word != word)
+        return std::nullopt;
+
+    return keyword.t;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "scanner_tables.h"
+
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Fast paths for skipping runs of characters 16 (SSE2) or 32 (AVX2) bytes at a time
+// Chosen at compile time, with a scalar fallback for the tail and for other architectures
+
+#if defined(__AVX2__)
+inline __m256i avx2_in_range(__m256i v, char low, char high) {
+    // Signed compares - bytes >= 0x80 are negative so are never in an ASCII range
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(low - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), v));
+}
+
+inline __m256i avx2_whitespace_mask(__m256i v) {
+    __m256i spaces = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+    __m256i newlines = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+    return _mm256_or_si256(spaces, newlines);
+}
+
+inline __m256i avx2_alphanum_mask(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i alpha = avx2_in_range(lower, 'a', 'z');
+    __m256i digit = avx2_in_range(v, '0', '9');
+    __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(alpha, digit), underscore);
+}
+#endif
+
+#if defined(__SSE2__)
+inline __m128i sse2_in_range(__m128i v, char low, char high) {
+    // Signed compares - bytes >= 0x80 are negative so are never in an ASCII range
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(low - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(high + 1)));
+}
+
+inline __m128i sse2_whitespace_mask(__m128i v) {
+    __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    __m128i newlines = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    return _mm_or_si128(spaces, newlines);
+}
+
+inline __m128i sse2_alphanum_mask(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i alpha = sse2_in_range(lower, 'a', 'z');
+    __m128i digit = sse2_in_range(v, '0', '9');
+    __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), underscore);
+}
+#endif
+
+// Number of newlines in the lowest `count` bits of a newline mask
+inline long count_newlines(uint32_t newline_mask, int count) {
+    uint32_t below = count >= 32 ? newline_mask : newline_mask & ((1u << count) - 1);
+    return __builtin_popcount(below);
+}
+
+// Returns the first character that isn't whitespace, adding any newlines skipped to `lines`
+inline const char *skip_whitespace_run(const char *p, const char *end, long &lines) {
+#if defined(__AVX2__)
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        uint32_t whitespace = _mm256_movemask_epi8(avx2_whitespace_mask(v));
+        uint32_t newlines = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+
+        if (whitespace != 0xFFFFFFFF) {
+            int first = __builtin_ctz(~whitespace);
+            lines += count_newlines(newlines, first);
+            return p + first;
+        }
+
+        lines += __builtin_popcount(newlines);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        uint32_t whitespace = _mm_movemask_epi8(sse2_whitespace_mask(v));
+        uint32_t newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+
+        if (whitespace != 0xFFFF) {
+            int first = __builtin_ctz(~whitespace);
+            lines += count_newlines(newlines, first);
+            return p + first;
+        }
+
+        lines += __builtin_popcount(newlines);
+        p += 16;
+    }
+#endif
+
+    while (p < end && has_class(*p, CHAR_WHITESPACE)) {
+        if (*p == '\n')
+            lines++;
+
+        p++;
+    }
+
+    return p;
+}
+
+// Returns the first character that can't be part of an identifier
+inline const char *skip_identifier_chars(const char *p, const char *end) {
+#if defined(__AVX2__)
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        uint32_t alphanum = _mm256_movemask_epi8(avx2_alphanum_mask(v));
+        if (alphanum != 0xFFFFFFFF)
+            return p + __builtin_ctz(~alphanum);
+
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        uint32_t alphanum = _mm_movemask_epi8(sse2_alphanum_mask(v));
+        if (alphanum != 0xFFFF)
+            return p + __builtin_ctz(~alphanum);
+
+        p += 16;
+    }
+#endif
+
+    while (p < end && is_alphanum(*p))
+        p++;
+
+    return p;
+}
+
+// Returns the first occurrence of `target` (or `end` if there isn't one), adding any newlines skipped to `lines`
+// Used to skip over comment and string bodies
+inline const char *find_char_counting_lines(const char *p, const char *end, char target, long &lines) {
+#if defined(__AVX2__)
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        uint32_t found = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(target)));
+        uint32_t newlines = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+
+        if (found != 0) {
+            int first = __builtin_ctz(found);
+            lines += count_newlines(newlines, first);
+            return p + first;
+        }
+
+        lines += __builtin_popcount(newlines);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        uint32_t found = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(target)));
+        uint32_t newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+
+        if (found != 0) {
+            int first = __builtin_ctz(found);
+            lines += count_newlines(newlines, first);
+            return p + first;
+        }
+
+        lines += __builtin_popcount(newlines);
+        p += 16;
+    }
+#endif
+
+    while (p < end && *p != target) {
+        if (*p == '\n')
+            lines++;
+
+        p++;
+    }
+
+    return p;
+}
+
+// Returns the first occurrence of either `a` or `b` (or `end` if there isn't one)
+inline const char *find_either_char(const char *p, const char *end, char a, char b) {
+#if defined(__AVX2__)
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(a)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(b)));
+        uint32_t found = _mm256_movemask_epi8(matches);
+        if (found != 0)
+            return p + __builtin_ctz(found);
+
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(a)), _mm_cmpeq_epi8(v, _mm_set1_epi8(b)));
+        uint32_t found = _mm_movemask_epi8(matches);
+        if (found != 0)
+            return p + __builtin_ctz(found);
+
+        p += 16;
+    }
+#endif
+
+    while (p < end && *p != a && *p != b)
+        p++;
+
+    return p;
+}
@@ -0,0 +1,92 @@
+#include "source_buffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceBuffer::SourceBuffer() : data(nullptr), length(0), mapped_length(0) {}
+
+// Read the whole of a file descriptor into a string (used for pipes, empty files, etc.)
+static bool read_all(int fd, std::string &out) {
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n == 0)
+            return true;
+
+        if (n < 0)
+            return false;
+
+        out.append(buffer, n);
+    }
+}
+
+std::optional<SourceBuffer> SourceBuffer::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return std::nullopt;
+
+    SourceBuffer source;
+
+    struct stat st;
+    long page_size = sysconf(_SC_PAGESIZE);
+    bool mappable = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0;
+
+    // The scanner reads one byte past the end, so only map if the zero-filled tail of the last page covers it
+    if (mappable && st.st_size % page_size != 0) {
+        void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+
+            source.data = static_cast<const char *>(mapped);
+            source.length = st.st_size;
+            source.mapped_length = st.st_size;
+
+            close(fd);
+            return source;
+        }
+    }
+
+    if (!read_all(fd, source.fallback)) {
+        close(fd);
+        return std::nullopt;
+    }
+
+    close(fd);
+
+    source.data = source.fallback.c_str();
+    source.length = source.fallback.length();
+    return source;
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer &&other) noexcept : SourceBuffer() {
+    *this = std::move(other);
+}
+
+SourceBuffer &SourceBuffer::operator=(SourceBuffer &&other) noexcept {
+    if (this->mapped_length > 0)
+        munmap(const_cast<char *>(this->data), this->mapped_length);
+
+    this->mapped_length = other.mapped_length;
+    this->length = other.length;
+    this->fallback = std::move(other.fallback);
+
+    // Fallback string has moved, so point at our copy
+    this->data = this->mapped_length > 0 ? other.data : this->fallback.c_str();
+
+    other.data = nullptr;
+    other.length = 0;
+    other.mapped_length = 0;
+
+    return *this;
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (this->mapped_length > 0)
+        munmap(const_cast<char *>(this->data), this->mapped_length);
+}
+
+std::string_view SourceBuffer::view() const {
+    return std::string_view(this->data, this->length);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Read-only contents of a source file, kept alive for the whole compile so tokens can point into it
+// Regular files are memory mapped, anything else (e.g. pipes) is read into memory
+//
+// NOTE: the byte after the end of the source is always readable and is '\0', as the scanner peeks one past the end
+class SourceBuffer {
+  private:
+    const char *data;
+    size_t length;
+
+    // Number of bytes mapped, or 0 if the contents live in `fallback`
+    size_t mapped_length;
+    std::string fallback;
+
+    SourceBuffer();
+
+  public:
+    static std::optional<SourceBuffer> open(const std::string &path);
+
+    SourceBuffer(SourceBuffer &&other) noexcept;
+    SourceBuffer &operator=(SourceBuffer &&other) noexcept;
+    SourceBuffer(const SourceBuffer &) = delete;
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+    ~SourceBuffer();
+
+    std::string_view view() const;
+};
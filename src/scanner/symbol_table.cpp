@@ -0,0 +1,27 @@
+#include "symbol_table.h"
+
+SymbolTable::SymbolTable() {
+    // Must match the order of `WellKnownSymbol`
+    for (auto name : {"", "this", "main", "int", "float", "bool", "str", "void", "null"})
+        this->intern(name);
+}
+
+SymbolTable &SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+// Get the symbol for a name, adding it if it hasn't been seen before
+Symbol SymbolTable::intern(std::string_view name) {
+    auto existing = this->ids.find(name);
+    if (existing != this->ids.end())
+        return existing->second;
+
+    std::string_view stored = this->pool.store(name);
+    Symbol symbol = this->names.size();
+
+    this->names.push_back(stored);
+    this->ids.emplace(stored, symbol);
+
+    return symbol;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "lexeme_pool.h"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Identifiers and type names are interned when scanned, so later passes compare and index by ID rather than by string
+using Symbol = uint32_t;
+
+// Symbols the compiler refers to directly - these are always interned first, in this order
+enum WellKnownSymbol : Symbol {
+    NO_SYMBOL,
+    SYM_THIS,
+    SYM_MAIN,
+    SYM_INT,
+    SYM_FLOAT,
+    SYM_BOOL,
+    SYM_STR,
+    SYM_VOID,
+    SYM_NULL,
+};
+
+class SymbolTable {
+  private:
+    std::unordered_map<std::string_view, Symbol> ids;
+    std::vector<std::string_view> names;
+
+    // Names are copied here, so the table doesn't depend on the source it was scanned from
+    LexemePool pool;
+
+  public:
+    SymbolTable();
+
+    // The table shared by the whole compiler
+    // NOTE: not thread safe - scanners on other threads use their own tables (see `tokenize_parallel`)
+    static SymbolTable &global();
+
+    Symbol intern(std::string_view name);
+
+    std::string_view name(Symbol symbol) const {
+        return this->names[symbol];
+    }
+
+    size_t size() const {
+        return this->names.size();
+    }
+};
+
+// Values for each symbol, stored densely by symbol ID
+// Like `std::map::operator[]`, looking up a symbol without a value gives a default constructed one
+template <typename T>
+class SymbolMap {
+  private:
+    std::vector<T> values;
+
+  public:
+    T &operator[](Symbol symbol) {
+        if (symbol >= this->values.size())
+            this->values.resize(symbol + 1);
+
+        return this->values[symbol];
+    }
+
+    // Look up a value without adding the symbol, giving a default constructed value if it doesn't have one
+    T get(Symbol symbol) const {
+        if (symbol >= this->values.size())
+            return T();
+
+        return this->values[symbol];
+    }
+
+    // One past the largest symbol that may have a value
+    size_t size() const {
+        return this->values.size();
+    }
+};
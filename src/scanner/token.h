@@ -1,14 +1,19 @@
 #pragma once
 
+#include "symbol_table.h"
+
+#include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <ios>
 #include <ostream>
 #include <stddef.h>
 #include <string>
+#include <string_view>
 
 // All possible token types
-enum TokenType {
+// Stored as a byte so the token types of a `TokenBuffer` pack tightly
+enum TokenType : uint8_t {
     L_CURLY_BRACKET,
     R_CURLY_BRACKET,
     L_BRACKET,
@@ -73,9 +78,14 @@ const std::string get_token_type_str(TokenType t);
 
 struct Token {
     TokenType t;
-    std::string lexeme;
+
+    // NOTE: this is a view into the source buffer, so the source must outlive the token
+    std::string_view lexeme;
     long line;
 
+    // Only set for identifiers and type names
+    Symbol symbol = NO_SYMBOL;
+
   public:
     friend std::ostream &operator<<(std::ostream &os, const Token &t);
 };
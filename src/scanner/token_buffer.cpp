@@ -0,0 +1,62 @@
+#include "token_buffer.h"
+
+void TokenBuffer::reserve(size_t count) {
+    this->types.reserve(count);
+    this->starts.reserve(count);
+    this->lengths.reserve(count);
+    this->lines.reserve(count);
+    this->symbols.reserve(count);
+}
+
+void TokenBuffer::push_back(const Token &token) {
+    this->types.push_back(token.t);
+    this->starts.push_back(token.lexeme.data());
+    this->lengths.push_back(token.lexeme.length());
+    this->lines.push_back(token.line);
+    this->symbols.push_back(token.symbol);
+}
+
+void TokenBuffer::pop_back() {
+    this->types.pop_back();
+    this->starts.pop_back();
+    this->lengths.pop_back();
+    this->lines.pop_back();
+    this->symbols.pop_back();
+}
+
+void TokenBuffer::erase_front(size_t count) {
+    this->types.erase(this->types.begin(), this->types.begin() + count);
+    this->starts.erase(this->starts.begin(), this->starts.begin() + count);
+    this->lengths.erase(this->lengths.begin(), this->lengths.begin() + count);
+    this->lines.erase(this->lines.begin(), this->lines.begin() + count);
+    this->symbols.erase(this->symbols.begin(), this->symbols.begin() + count);
+}
+
+void TokenBuffer::append(const TokenBuffer &other, long line_offset, const std::vector<Symbol> &symbol_remap) {
+    this->types.insert(this->types.end(), other.types.begin(), other.types.end());
+    this->starts.insert(this->starts.end(), other.starts.begin(), other.starts.end());
+    this->lengths.insert(this->lengths.end(), other.lengths.begin(), other.lengths.end());
+
+    for (uint32_t line : other.lines)
+        this->lines.push_back(line + line_offset);
+
+    for (Symbol symbol : other.symbols)
+        this->symbols.push_back(symbol_remap[symbol]);
+}
+
+TokenBuffer TokenBuffer::slice(size_t begin, size_t end) const {
+    TokenBuffer tokens;
+    tokens.types.assign(this->types.begin() + begin, this->types.begin() + end);
+    tokens.starts.assign(this->starts.begin() + begin, this->starts.begin() + end);
+    tokens.lengths.assign(this->lengths.begin() + begin, this->lengths.begin() + end);
+    tokens.lines.assign(this->lines.begin() + begin, this->lines.begin() + end);
+    tokens.symbols.assign(this->symbols.begin() + begin, this->symbols.begin() + end);
+
+    tokens.push_back(Token{TokenType::EOF_, "", this->lines[end]});
+    return tokens;
+}
+
+void TokenBuffer::remap_symbols(const std::vector<Symbol> &symbol_remap) {
+    for (Symbol &symbol : this->symbols)
+        symbol = symbol_remap[symbol];
+}
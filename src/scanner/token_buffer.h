@@ -0,0 +1,66 @@
+#pragma once
+
+#include "token.h"
+
+#include <cstdint>
+#include <vector>
+
+// A whole file of tokens, stored as a structure of arrays so the parser can walk it by index
+// Token types are contiguous, so checking the current (or any upcoming) token is a single load
+class TokenBuffer {
+  private:
+    std::vector<TokenType> types;
+
+    // Start of each lexeme - these point into the source (or wherever the scanner keeps its lexemes)
+    std::vector<const char *> starts;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> lines;
+    std::vector<Symbol> symbols;
+
+  public:
+    // Scan every token up to and including EOF
+    // The scanner type is a template parameter so `scan_token` is called directly rather than through the vtable
+    template <typename S>
+    static TokenBuffer tokenize(S &scanner, size_t expected_tokens = 0) {
+        TokenBuffer tokens;
+        tokens.reserve(expected_tokens);
+
+        Token token = scanner.scan_token();
+        while (token.t != TokenType::EOF_) {
+            tokens.push_back(token);
+            token = scanner.scan_token();
+        }
+
+        tokens.push_back(token);
+        return tokens;
+    }
+
+    void reserve(size_t count);
+    void push_back(const Token &token);
+    void pop_back();
+
+    // Drop the first `count` tokens, moving the rest to the front
+    void erase_front(size_t count);
+
+    // Add all of `other`'s tokens to the end, shifting their line numbers by `line_offset`
+    // and swapping their symbols for the ones at the same index in `symbol_remap`
+    void append(const TokenBuffer &other, long line_offset, const std::vector<Symbol> &symbol_remap);
+
+    // Swap every symbol for the one at the same index in `symbol_remap`
+    void remap_symbols(const std::vector<Symbol> &symbol_remap);
+
+    // Copy of the tokens in `[begin, end)`, ended by an EOF token on the line of the token at `end`
+    TokenBuffer slice(size_t begin, size_t end) const;
+
+    size_t size() const {
+        return this->types.size();
+    }
+
+    TokenType type(size_t i) const {
+        return this->types[i];
+    }
+
+    Token get(size_t i) const {
+        return Token{this->types[i], std::string_view(this->starts[i], this->lengths[i]), this->lines[i], this->symbols[i]};
+    }
+};
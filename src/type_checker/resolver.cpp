@@ -1,167 +1,186 @@
 #include "resolver.h"
+#include "../ast/dispatch.h"
 #include "type.h"
 
 #include <algorithm>
 #include <iostream>
 #include <memory>
 
-Resolver::Resolver(std::map<std::string, std::shared_ptr<Type>> type_env) : type_env(type_env) {
+Resolver::Resolver(const TypeTable &type_env, bool throw_errors) : type_env(type_env), throw_errors(throw_errors) {
     // Global scope
-    this->scopes.push_back({});
+    this->begin_scope();
 }
 
-// Print error with line number and exit
-void Resolver::error(Token error_token, std::string message) {
-    std::string where = "end";
-    if (error_token.t != TokenType::EOF_)
-        where = "'" + error_token.lexeme + "'";
+// Print error with line number and exit, or throw it if the caller is handling errors itself
+void Resolver::error(Token error_token, DiagnosticCode code, std::initializer_list<DiagnosticArg> args) {
+    Diagnostic diagnostic(DiagnosticStage::RESOLVING, code, error_token, args);
+    if (this->throw_errors)
+        throw ResolverError{diagnostic};
 
-    std::cerr << "[line " << error_token.line << "] Resolving error at " << where << ": " << message << std::endl;
+    report(std::cerr, diagnostic);
     exit(5);
 }
 
 void Resolver::begin_scope() {
-    this->scopes.push_back({});
+    this->scope_starts.push_back(this->variables.size());
 }
 
+// Drop the variables declared in the current scope, uncovering any they shadowed
 void Resolver::end_scope() {
-    this->scopes.pop_back();
+    uint32_t start = this->scope_starts.back();
+    while (this->variables.size() > start) {
+        auto &variable = this->variables.back();
+        this->innermost[variable.name] = variable.shadowed;
+        this->variables.pop_back();
+    }
+
+    this->scope_starts.pop_back();
 }
 
 // Resolve a list of statements
-void Resolver::resolve(std::vector<std::unique_ptr<Stmt>> &stmts) {
+void Resolver::resolve(NodeList<Stmt> &stmts) {
     for (auto &stmt : stmts) {
-        stmt->accept(*this);
+        dispatch(stmt, *this);
     }
 }
 
 void Resolver::resolve(Stmt *stmt) {
-    stmt->accept(*this);
+    dispatch(stmt, *this);
 }
 
 void Resolver::resolve(Expr *expr) {
-    expr->accept(*this);
+    dispatch(expr, *this);
 }
 
 // Try to find the variable name in an accessible scope
-std::optional<ResolvedVariable> Resolver::resolve_local(Token name) {
-    // Loop from current scope, up to top - find the first one to match the variable name
-    for (int i = this->scopes.size() - 1; i >= 0; i--) {
-        auto scope = this->scopes[i];
-        auto resolved = scope.find(name.lexeme);
-        if (resolved != scope.end()) {
-            return resolved->second;
-        }
-    }
+ResolvedVariable *Resolver::resolve_local(Token name, VariableSlot &slot) {
+    uint32_t index = this->innermost[name.symbol];
+    if (index == 0)
+        return nullptr;
+
+    auto &variable = this->variables[index - 1];
+    slot.depth = this->scope_starts.size() - 1 - variable.scope;
+    slot.slot = index - 1 - this->scope_starts[variable.scope];
 
-    return std::nullopt;
+    return &variable;
 }
 
-void Resolver::resolve_function(FunDeclStmt *fun) {
+// Declare a function, and open its scope with all of its parameters
+void Resolver::begin_function(FunDeclStmt *fun) {
+    // Functions can never be optional
+    this->declare(fun->name.symbol, fun->type, false);
+    this->define(fun->name.symbol);
+
     this->begin_scope();
 
     // Declare and define all parameters
     for (auto param : fun->params) {
-        this->declare(param.name.lexeme, this->type_env[param.type.lexeme], param.is_optional);
-        this->define(param.name.lexeme);
+        this->declare(param.name.symbol, param.resolved_type, param.is_optional);
+        this->define(param.name.symbol);
     }
+}
 
-    // Resolve the body
-    this->resolve(fun->body);
-    this->end_scope();
+// Like `begin_function`, but enum method parameters are never optional
+void Resolver::begin_enum_method(EnumMethodDeclStmt *enum_method) {
+    auto &fun = enum_method->fun_definition;
+
+    this->declare(fun->name.symbol, fun->type, false);
+    this->define(fun->name.symbol);
+
+    this->begin_scope();
+    for (auto param : fun->params) {
+        this->declare(param.name.symbol, param.resolved_type, false);
+        this->define(param.name.symbol);
+    }
 }
 
-void Resolver::resolve_struct(StructDeclStmt *s) {
+// Declare a struct, and open its scope with `this` and all of its properties
+void Resolver::begin_struct(StructDeclStmt *s) {
+    this->declare(s->name.symbol, this->type_env[s->name.symbol], false);
+    this->define(s->name.symbol);
+
     this->begin_scope();
 
     // Always have access to "this" within a struct
-    std::string this_keyword("this");
-    this->declare(this_keyword, this->type_env[s->name.lexeme], false);
-    this->define(this_keyword);
+    this->declare(SYM_THIS, this->type_env[s->name.symbol], false);
+    this->define(SYM_THIS);
 
     // Declare and define all properties
     for (auto &prop : s->properties) {
-        auto type = this->type_env.find(prop.type.lexeme);
-        if (type == this->type_env.end())
-            this->error(prop.type, "Unknown type for struct prop.");
+        if (!prop.resolved_type)
+            this->error(prop.type, DiagnosticCode::UNKNOWN_PROPERTY_TYPE);
 
-        this->declare(prop.name.lexeme, this->type_env[prop.type.lexeme], prop.is_optional);
-        this->define(prop.name.lexeme);
+        this->declare(prop.name.symbol, prop.resolved_type, prop.is_optional);
+        this->define(prop.name.symbol);
     }
-
-    // Resolve all methods
-    for (auto &method : s->methods) {
-        method->accept(*this);
-    }
-
-    this->end_scope();
 }
 
-void Resolver::resolve_enum(EnumDeclStmt *e) {
+// Declare an enum, and open its scope with `this`
+void Resolver::begin_enum(EnumDeclStmt *e) {
+    this->declare(e->name.symbol, this->type_env[e->name.symbol], false);
+    this->define(e->name.symbol);
+
     this->begin_scope();
 
     // Always have access to "this" within an enum
-    std::string this_keyword("this");
-    this->declare(this_keyword, this->type_env[e->name.lexeme], false);
-    this->define(this_keyword);
-
-    // Resolve all methods
-    for (auto &method : e->methods) {
-        method->accept(*this);
-    }
+    this->declare(SYM_THIS, this->type_env[e->name.symbol], false);
+    this->define(SYM_THIS);
+}
 
-    this->end_scope();
+// Declare a local variable - it is defined once its initialiser has been resolved
+void Resolver::declare_variable(VariableDeclStmt *stmt) {
+    // Local variables are only seen here, so their types are resolved here rather than in the type environment
+    stmt->name.resolved_type = this->type_env[stmt->name.type.symbol];
+    this->declare(stmt->name.name.symbol, stmt->name.resolved_type, stmt->name.is_optional);
 }
 
 // Define a variable after it has been declared
-void Resolver::define(std::string &name) {
-    auto &scope = this->scopes.back();
-    auto val = scope.find(name);
-    if (val == scope.end()) {
+void Resolver::define(Symbol name) {
+    uint32_t index = this->innermost[name];
+    if (index == 0 || index - 1 < this->scope_starts.back()) {
         std::cerr << "[BUG] Defining a variable that doesn't exist." << std::endl;
         exit(3);
     }
 
-    scope[name].defined = true;
+    this->variables[index - 1].defined = true;
 }
 
 // Declare a variable and its type in the current scope
-void Resolver::declare(std::string &name, std::shared_ptr<Type> type, bool optional) {
-    auto &scope = this->scopes.back();
+void Resolver::declare(Symbol name, Type *type, bool optional) {
+    uint32_t scope = this->scope_starts.size() - 1;
+    uint32_t &index = this->innermost[name];
+
+    // Redeclaring in the same scope replaces the variable in its existing slot
+    if (index != 0 && index - 1 >= this->scope_starts.back()) {
+        auto &variable = this->variables[index - 1];
+        variable.defined = false;
+        variable.type = type;
+        variable.optional = optional;
+        return;
+    }
 
-    scope[name] = ResolvedVariable{
+    this->variables.push_back(ResolvedVariable{
         name,
         false,
         type,
-        optional};
+        optional,
+        scope,
+        index});
+    index = this->variables.size();
 }
 
 //// Expressions
 
 void Resolver::visit_var_expr(VarExpr *expr) {
-    auto resolved = this->resolve_local(expr->name);
-    if (!resolved.has_value()) {
-        this->error(expr->name, "Unknown variable - not declared at this point.");
-    }
-
-    if (!resolved.value().defined)
-        this->error(expr->name, "Cannot read local variable in its own initialiser.");
-
-    expr->set_type_info(TypeInfo(resolved.value().type, resolved.value().optional));
+    this->type_var_expr(expr);
 }
 
 void Resolver::visit_struct_init_expr(StructInitExpr *expr) {
     for (auto &prop : expr->properties) {
-        std::get<1>(prop)->accept(*this);
+        dispatch(std::get<1>(prop), *this);
     }
 
-    if (auto t = std::dynamic_pointer_cast<StructType>(this->type_env[expr->name.lexeme])) {
-        // Since we are initialising it, it must be non-null
-        expr->set_type_info(TypeInfo(t, false));
-        return;
-    }
-
-    this->error(expr->name, "Cannot use struct initialiser on non-struct.");
+    this->type_struct_init_expr(expr);
 }
 
 void Resolver::visit_binary_expr(BinaryExpr *expr) {
@@ -175,83 +194,125 @@ void Resolver::visit_unary_expr(UnaryExpr *expr) {
 
 void Resolver::visit_get_expr(GetExpr *expr) {
     this->resolve(expr->object.get());
+    this->type_get_expr(expr);
+}
+
+void Resolver::visit_enum_init_expr(EnumInitExpr *expr) {
+    if (expr->payload.has_value()) {
+        dispatch(expr->payload.value(), *this);
+    }
+
+    this->type_enum_init_expr(expr);
+}
+
+void Resolver::visit_call_expr(CallExpr *expr) {
+    this->resolve(expr->callee.get());
+    this->type_call_expr(expr);
+
+    for (auto &arg : expr->args) {
+        this->resolve(arg.get());
+    }
+}
+
+void Resolver::visit_grouping_expr(GroupingExpr *expr) {
+    this->resolve(expr->expr.get());
+}
+
+// NOTE: no variables to resolve here
+void Resolver::visit_literal_expr(LiteralExpr *expr) {
+    this->type_literal_expr(expr);
+}
+
+//// Expression types, once the expression's children have been resolved
+
+void Resolver::type_var_expr(VarExpr *expr) {
+    auto resolved = this->resolve_local(expr->name, expr->slot);
+    if (!resolved) {
+        this->error(expr->name, DiagnosticCode::UNKNOWN_VARIABLE);
+    }
+
+    if (!resolved->defined)
+        this->error(expr->name, DiagnosticCode::READ_IN_OWN_INITIALISER);
 
-    if (auto t = std::dynamic_pointer_cast<StructType>(expr->object->get_type_info().type)) {
-        auto method_type = t->get_method_type(expr->name.lexeme);
-        if (method_type.has_value()) {
+    expr->set_type_info(TypeInfo(resolved->type, resolved->optional));
+}
+
+void Resolver::type_struct_init_expr(StructInitExpr *expr) {
+    if (auto t = type_cast<StructType>(this->type_env[expr->name.symbol])) {
+        // Since we are initialising it, it must be non-null
+        expr->set_type_info(TypeInfo(t, false));
+        return;
+    }
+
+    this->error(expr->name, DiagnosticCode::STRUCT_INIT_ON_NON_STRUCT);
+}
+
+void Resolver::type_get_expr(GetExpr *expr) {
+    if (auto t = type_cast<StructType>(expr->object->get_type_info().type)) {
+        auto method_type = t->get_method_type(expr->name.symbol);
+        if (method_type) {
             // If the struct is optional, we are using optional chaining - the result is optional
-            expr->set_type_info(TypeInfo(method_type.value(), expr->object->get_type_info().optional));
+            expr->set_type_info(TypeInfo(method_type, expr->object->get_type_info().optional));
             return;
         }
 
-        auto prop_type = t->get_prop_type(expr->name.lexeme);
+        auto prop_type = t->get_prop_type(expr->name.symbol);
         if (prop_type.has_value()) {
             // If the struct is optional, we are using optional chaining - the result is optional
             // Otherwise, check if the property is optional
-            expr->set_type_info(TypeInfo(this->type_env[prop_type.value().type.lexeme], expr->object->get_type_info().optional || prop_type.value().optional));
+            expr->set_type_info(TypeInfo(prop_type.value().type, expr->object->get_type_info().optional || prop_type.value().optional));
             return;
         }
 
-        this->error(expr->name, "Could not find member on struct.");
-    } else if (auto t = std::dynamic_pointer_cast<EnumType>(expr->object->get_type_info().type)) {
-        auto type = t->get_method_type(expr->name.lexeme);
-        if (type.has_value()) {
+        this->error(expr->name, DiagnosticCode::UNKNOWN_STRUCT_MEMBER);
+    } else if (auto t = type_cast<EnumType>(expr->object->get_type_info().type)) {
+        auto type = t->get_method_type(expr->name.symbol);
+        if (type) {
             // If the enum is optional, we are using optional chaining - the result is optional
-            expr->set_type_info(TypeInfo(type.value(), expr->object->get_type_info().optional));
+            expr->set_type_info(TypeInfo(type, expr->object->get_type_info().optional));
             return;
         }
 
-        this->error(expr->name, "Could not find property on enum.");
+        this->error(expr->name, DiagnosticCode::UNKNOWN_ENUM_MEMBER);
     } else {
-        this->error(expr->name, "Cannot get property on a variable that is neither a struct nor enum.");
+        this->error(expr->name, DiagnosticCode::GET_ON_NON_STRUCT_OR_ENUM);
     }
 }
 
-void Resolver::visit_enum_init_expr(EnumInitExpr *expr) {
-    if (expr->payload.has_value()) {
-        expr->payload.value()->accept(*this);
-    }
-
+void Resolver::type_enum_init_expr(EnumInitExpr *expr) {
     auto enum_name = expr->enum_namespace->name;
-    if (auto t = std::dynamic_pointer_cast<EnumType>(this->type_env[enum_name.lexeme])) {
+    if (auto t = type_cast<EnumType>(this->type_env[enum_name.symbol])) {
+        if (!t->variant_index(expr->variant.symbol).has_value())
+            this->error(expr->variant, DiagnosticCode::UNKNOWN_VARIANT);
+
         // Since we are initialising it, it must be non-null
         expr->set_type_info(TypeInfo(t, false));
         return;
     }
 
-    this->error(enum_name, "Cannot use struct initialiser on non-struct.");
+    this->error(enum_name, DiagnosticCode::STRUCT_INIT_ON_NON_STRUCT);
 }
 
-void Resolver::visit_call_expr(CallExpr *expr) {
-    this->resolve(expr->callee.get());
-
-    if (auto t = std::dynamic_pointer_cast<FunctionType>(expr->callee->get_type_info().type)) {
-        expr->set_type_info(TypeInfo(this->type_env[t->return_type.lexeme], t->return_type_optional));
+// NOTE: the arguments don't need to be resolved first
+void Resolver::type_call_expr(CallExpr *expr) {
+    if (auto t = type_cast<FunctionType>(expr->callee->get_type_info().type)) {
+        expr->set_type_info(TypeInfo(t->return_type, t->return_type_optional));
     } else {
-        this->error(expr->bracket, "Cannot call non-function.");
-    }
-
-    for (auto &arg : expr->args) {
-        this->resolve(arg.get());
+        this->error(expr->bracket, DiagnosticCode::CANNOT_CALL_NON_FUNCTION);
     }
 }
 
-void Resolver::visit_grouping_expr(GroupingExpr *expr) {
-    this->resolve(expr->expr.get());
-}
-
-// NOTE: no variables to resolve here
-void Resolver::visit_literal_expr(LiteralExpr *expr) {
+void Resolver::type_literal_expr(LiteralExpr *expr) {
     // Set type info if literal
     switch (expr->literal.t) {
-        case TokenType::INT_VAL:   expr->set_type_info(TypeInfo(this->type_env["int"], false)); break;
-        case TokenType::FLOAT_VAL: expr->set_type_info(TypeInfo(this->type_env["float"], false)); break;
-        case TokenType::BOOL_VAL:  expr->set_type_info(TypeInfo(this->type_env["bool"], false)); break;
-        case TokenType::NULL_VAL:  expr->set_type_info(TypeInfo(this->type_env["null"], true)); break;
-        case TokenType::STR_VAL:   expr->set_type_info(TypeInfo(this->type_env["str"], false)); break;
+        case TokenType::INT_VAL:   expr->set_type_info(TypeInfo(this->type_env[SYM_INT], false)); break;
+        case TokenType::FLOAT_VAL: expr->set_type_info(TypeInfo(this->type_env[SYM_FLOAT], false)); break;
+        case TokenType::BOOL_VAL:  expr->set_type_info(TypeInfo(this->type_env[SYM_BOOL], false)); break;
+        case TokenType::NULL_VAL:  expr->set_type_info(TypeInfo(this->type_env[SYM_NULL], true)); break;
+        case TokenType::STR_VAL:   expr->set_type_info(TypeInfo(this->type_env[SYM_STR], false)); break;
         case TokenType::TRUE:
         case TokenType::FALSE:
-            expr->set_type_info(TypeInfo(this->type_env["bool"], false));
+            expr->set_type_info(TypeInfo(this->type_env[SYM_BOOL], false));
             break;
         default:
             std::cout << "[BUG] Literal type unknown" << std::endl;
@@ -262,59 +323,43 @@ void Resolver::visit_literal_expr(LiteralExpr *expr) {
 //// Statements
 
 void Resolver::visit_fun_decl_stmt(FunDeclStmt *stmt) {
-    auto func_type = std::make_shared<FunctionType>(
-        stmt->name,
-        stmt->params,
-        stmt->return_type,
-        stmt->return_type_optional);
-
-    // Functions can never be optional
-    this->declare(stmt->name.lexeme, func_type, false);
-    this->define(stmt->name.lexeme);
-
-    this->resolve_function(stmt);
+    this->begin_function(stmt);
+    this->resolve(stmt->get_body());
+    this->end_scope();
 }
 
 void Resolver::visit_enum_method_decl_stmt(EnumMethodDeclStmt *enum_stmt) {
-    auto &stmt = enum_stmt->fun_definition;
-
-    auto func_type = std::make_shared<FunctionType>(
-        stmt->name,
-        stmt->params,
-        stmt->return_type,
-        stmt->return_type_optional);
-
-    this->declare(stmt->name.lexeme, func_type, false);
-    this->define(stmt->name.lexeme);
-
-    this->begin_scope();
-    for (auto param : stmt->params) {
-        this->declare(param.name.lexeme, this->type_env[param.type.lexeme], false);
-        this->define(param.name.lexeme);
-    }
-
-    this->resolve(stmt->body);
+    this->begin_enum_method(enum_stmt);
+    this->resolve(enum_stmt->fun_definition->get_body());
     this->end_scope();
 }
 
 void Resolver::visit_struct_decl_stmt(StructDeclStmt *stmt) {
-    this->declare(stmt->name.lexeme, this->type_env[stmt->name.lexeme], false);
-    this->define(stmt->name.lexeme);
+    this->begin_struct(stmt);
+
+    // Resolve all methods
+    for (auto &method : stmt->methods) {
+        dispatch(method, *this);
+    }
 
-    this->resolve_struct(stmt);
+    this->end_scope();
 }
 
 void Resolver::visit_enum_decl_stmt(EnumDeclStmt *stmt) {
-    this->declare(stmt->name.lexeme, this->type_env[stmt->name.lexeme], false);
-    this->define(stmt->name.lexeme);
+    this->begin_enum(stmt);
+
+    // Resolve all methods
+    for (auto &method : stmt->methods) {
+        dispatch(method, *this);
+    }
 
-    this->resolve_enum(stmt);
+    this->end_scope();
 }
 
 void Resolver::visit_variable_decl_stmt(VariableDeclStmt *stmt) {
-    this->declare(stmt->name.name.lexeme, this->type_env[stmt->name.type.lexeme], stmt->name.is_optional);
+    this->declare_variable(stmt);
     this->resolve(stmt->initialiser.get());
-    this->define(stmt->name.name.lexeme);
+    this->define(stmt->name.name.symbol);
 }
 
 void Resolver::visit_expr_stmt(ExprStmt *stmt) {
@@ -337,50 +382,54 @@ void Resolver::visit_if_stmt(IfStmt *stmt) {
 
 void Resolver::visit_match_stmt(MatchStmt *stmt) {
     this->resolve(stmt->target.get());
-
-    auto enum_type = std::dynamic_pointer_cast<EnumType>(stmt->target->get_type_info().type);
-    if (!(enum_type || stmt->target->get_type_info().optional)) {
-        this->error(stmt->keyword, "Can only match on enum or optional.");
-    }
+    this->check_match_target(stmt);
 
     for (auto &branch : stmt->branches) {
-        if (std::holds_alternative<EnumPattern>(branch.pattern)) {
-            auto &enum_pattern = std::get<EnumPattern>(branch.pattern);
+        this->bind_pattern(stmt, branch);
+        this->resolve(branch.body);
+    }
+}
 
-            // If we have a bound value - check its type and declare/define it
-            if (enum_pattern.bound_variable.has_value()) {
-                auto &var = enum_pattern.bound_variable.value();
-                auto name = enum_pattern.enum_variant.lexeme;
+void Resolver::check_match_target(MatchStmt *stmt) {
+    auto enum_type = type_cast<EnumType>(stmt->target->get_type_info().type);
+    if (!(enum_type || stmt->target->get_type_info().optional)) {
+        this->error(stmt->keyword, DiagnosticCode::MATCH_ON_NON_ENUM);
+    }
+}
 
-                auto pattern_type = std::dynamic_pointer_cast<EnumType>(this->type_env[enum_pattern.enum_type.lexeme]);
-                if (!pattern_type) {
-                    this->error(enum_pattern.enum_type, "Pattern must be an enum variant.");
-                }
+// Declare the variable a branch's pattern binds, if there is one
+void Resolver::bind_pattern(MatchStmt *stmt, MatchBranch &branch) {
+    if (std::holds_alternative<EnumPattern>(branch.pattern)) {
+        auto &enum_pattern = std::get<EnumPattern>(branch.pattern);
 
-                auto variant = std::find_if(pattern_type->variants.begin(), pattern_type->variants.end(), [name](const auto &t) {
-                    return t.name.lexeme == name;
-                });
+        // If we have a bound value - check its type and declare/define it
+        if (enum_pattern.bound_variable.has_value()) {
+            auto &var = enum_pattern.bound_variable.value();
 
-                if (variant == pattern_type->variants.end()) {
-                    this->error(enum_pattern.enum_variant, "Could not find variant on enum.");
-                }
+            auto pattern_type = type_cast<EnumType>(this->type_env[enum_pattern.enum_type.symbol]);
+            if (!pattern_type) {
+                this->error(enum_pattern.enum_type, DiagnosticCode::PATTERN_NOT_ENUM_VARIANT);
+            }
 
-                if (!variant->payload_type.has_value()) {
-                    this->error(enum_pattern.bound_variable.value()->name, "Enum variant has no payload - cannot bind a variable.");
-                }
+            auto index = pattern_type->variant_index(enum_pattern.enum_variant.symbol);
+            if (!index.has_value()) {
+                this->error(enum_pattern.enum_variant, DiagnosticCode::UNKNOWN_VARIANT);
+            }
 
-                this->declare(var->name.lexeme, this->type_env[variant->payload_type.value().lexeme], variant->is_optional);
-                this->define(var->name.lexeme);
+            auto &variant = pattern_type->variants[index.value()];
+            if (!variant.payload_type.has_value()) {
+                this->error(enum_pattern.bound_variable.value()->name, DiagnosticCode::BIND_WITHOUT_PAYLOAD);
             }
-        } else if (std::holds_alternative<CatchAllPattern>(branch.pattern)) {
-            auto &catch_all_pattern = std::get<CatchAllPattern>(branch.pattern);
-            auto &var = catch_all_pattern.bound_variable;
 
-            this->declare(var->name.lexeme, stmt->target->get_type_info().type, false);
-            this->define(var->name.lexeme);
+            this->declare(var->name.symbol, variant.resolved_payload_type, variant.is_optional);
+            this->define(var->name.symbol);
         }
+    } else if (std::holds_alternative<CatchAllPattern>(branch.pattern)) {
+        auto &catch_all_pattern = std::get<CatchAllPattern>(branch.pattern);
+        auto &var = catch_all_pattern.bound_variable;
 
-        this->resolve(branch.body);
+        this->declare(var->name.symbol, stmt->target->get_type_info().type, false);
+        this->define(var->name.symbol);
     }
 }
 
@@ -413,30 +462,38 @@ void Resolver::visit_return_stmt(ReturnStmt *stmt) {
 
 void Resolver::visit_assign_stmt(AssignStmt *stmt) {
     this->resolve(stmt->value.get());
-    auto var = this->resolve_local(stmt->name);
-
-    if (!var.has_value())
-        this->error(stmt->name, "Cannot assign to a variable that hasn't been declared.");
-
-    stmt->set_target_type_info(TypeInfo(var.value().type, var.value().optional));
+    this->resolve_assign_target(stmt);
 }
 
 void Resolver::visit_set_stmt(SetStmt *stmt) {
     this->resolve(stmt->value.get());
     this->resolve(stmt->object.get());
+    this->resolve_set_target(stmt);
+}
+
+void Resolver::resolve_assign_target(AssignStmt *stmt) {
+    auto var = this->resolve_local(stmt->name, stmt->slot);
+
+    if (!var)
+        this->error(stmt->name, DiagnosticCode::ASSIGN_TO_UNDECLARED_VARIABLE);
+
+    stmt->set_target_type_info(TypeInfo(var->type, var->optional));
+}
 
+// NOTE: the object must have been resolved first
+void Resolver::resolve_set_target(SetStmt *stmt) {
     if (stmt->object->get_type_info().optional) {
-        this->error(stmt->name, "Assigning to a property of an optional struct is not currently supported.");
+        this->error(stmt->name, DiagnosticCode::SET_ON_OPTIONAL_STRUCT);
     }
 
-    if (auto t = std::dynamic_pointer_cast<StructType>(stmt->object->get_type_info().type)) {
-        auto prop_type = t->get_prop_type(stmt->name.lexeme);
+    if (auto t = type_cast<StructType>(stmt->object->get_type_info().type)) {
+        auto prop_type = t->get_prop_type(stmt->name.symbol);
         if (!prop_type.has_value()) {
-            this->error(stmt->name, "Could not find property on struct.");
+            this->error(stmt->name, DiagnosticCode::UNKNOWN_STRUCT_PROPERTY);
         }
 
-        stmt->set_target_type_info(TypeInfo(this->type_env[prop_type.value().type.lexeme], prop_type.value().optional));
+        stmt->set_target_type_info(TypeInfo(prop_type.value().type, prop_type.value().optional));
     } else {
-        this->error(stmt->name, "Cannot get property on a variable that is not a struct.");
+        this->error(stmt->name, DiagnosticCode::SET_ON_NON_STRUCT);
     }
 }
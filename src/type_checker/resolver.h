@@ -2,43 +2,85 @@
 
 #include "../ast/expr_visitor.h"
 #include "../ast/stmt_visitor.h"
+#include "../diagnostics/diagnostic.h"
 #include "../type_checker/type.h"
 
+#include <cstdint>
 #include <fstream>
-#include <map>
 #include <string>
+#include <vector>
 
 struct ResolvedVariable {
-    std::string name;
+    Symbol name;
     bool defined;
-    std::shared_ptr<Type> type;
+    Type *type;
     bool optional;
+
+    // Index of the scope the variable was declared in (0 is the global scope)
+    uint32_t scope;
+
+    // The variable with the same name this one shadows, as an index into `variables` plus one (0 if none)
+    uint32_t shadowed;
 };
 
-class Resolver : public ExprVisitor, public StmtVisitor {
+// Thrown instead of reporting a resolving error and exiting, when a `Resolver` is asked to throw its errors
+struct ResolverError {
+    Diagnostic diagnostic;
+};
+
+class Resolver final : public ExprVisitor, public StmtVisitor {
   private:
-    std::vector<std::map<std::string, ResolvedVariable>> scopes;
-    std::map<std::string, std::shared_ptr<Type>> type_env;
+    // Every variable in an open scope, in declaration order - each scope is a contiguous run at the end
+    // Reused for the whole resolve, so entering and leaving scopes doesn't allocate
+    std::vector<ResolvedVariable> variables;
+
+    // Index into `variables` where each open scope starts
+    std::vector<uint32_t> scope_starts;
+
+    // Innermost visible variable for each name, as an index into `variables` plus one (0 if none)
+    SymbolMap<uint32_t> innermost;
+
+    const TypeTable &type_env;
+
+    bool throw_errors;
 
   public:
-    Resolver(std::map<std::string, std::shared_ptr<Type>> type_env);
+    Resolver(const TypeTable &type_env, bool throw_errors = false);
 
-    void error(Token t, std::string message);
+    void error(Token t, DiagnosticCode code, std::initializer_list<DiagnosticArg> args = {});
 
     void begin_scope();
     void end_scope();
 
-    void resolve(std::vector<std::unique_ptr<Stmt>> &stmts);
+    void resolve(NodeList<Stmt> &stmts);
     void resolve(Stmt *stmt);
     void resolve(Expr *expr);
-    void resolve_function(FunDeclStmt *fun);
-    void resolve_struct(StructDeclStmt *s);
-    void resolve_enum(EnumDeclStmt *e);
 
-    std::optional<ResolvedVariable> resolve_local(Token name);
+    // Find the innermost variable with this name, and where it is relative to the current scope
+    // NOTE: the pointer is only valid until the next scope change or declaration
+    ResolvedVariable *resolve_local(Token name, VariableSlot &slot);
+
+    void declare(Symbol name, Type *type, bool optional);
+    void define(Symbol name);
+
+    // Each step of resolving a node that doesn't resolve its children, so a pass that walks the tree itself
+    // (i.e. the type checker, when resolving as it checks) can resolve in the same order as the resolver does
+    void begin_function(FunDeclStmt *fun);
+    void begin_enum_method(EnumMethodDeclStmt *enum_method);
+    void begin_struct(StructDeclStmt *s);
+    void begin_enum(EnumDeclStmt *e);
+    void declare_variable(VariableDeclStmt *stmt);
+    void check_match_target(MatchStmt *stmt);
+    void bind_pattern(MatchStmt *stmt, MatchBranch &branch);
+    void resolve_assign_target(AssignStmt *stmt);
+    void resolve_set_target(SetStmt *stmt);
 
-    void declare(std::string &name, std::shared_ptr<Type> type, bool optional);
-    void define(std::string &name);
+    void type_var_expr(VarExpr *expr);
+    void type_struct_init_expr(StructInitExpr *expr);
+    void type_get_expr(GetExpr *expr);
+    void type_enum_init_expr(EnumInitExpr *expr);
+    void type_call_expr(CallExpr *expr);
+    void type_literal_expr(LiteralExpr *expr);
 
     void visit_var_expr(VarExpr *expr);
     void visit_struct_init_expr(StructInitExpr *expr);
@@ -1,7 +1,6 @@
 #include "type.h"
-#include <algorithm>
 
-bool Type::can_coerce_to(std::shared_ptr<Type> t) { return this == t.get(); }
+bool Type::can_coerce_to(Type *t) { return this == t; }
 
 // String values for error reporting
 std::string IntType::to_string() { return "int"; }
@@ -11,58 +10,106 @@ std::string NullType::to_string() { return "null"; }
 std::string StrType::to_string() { return "str"; }
 std::string VoidType::to_string() { return "void"; }
 
-std::string StructType::to_string() { return this->name.lexeme; }
-std::string FunctionType::to_string() { return this->name.lexeme; }
-std::string EnumType::to_string() { return this->name.lexeme; }
+std::string StructType::to_string() { return std::string(this->name.lexeme); }
+std::string FunctionType::to_string() { return std::string(this->name.lexeme); }
+std::string EnumType::to_string() { return std::string(this->name.lexeme); }
 
-// Finds the the type of a method on a struct given the method name
-std::optional<std::shared_ptr<Type>> StructType::get_method_type(std::string name) {
-    auto m = std::find_if(this->methods.begin(), this->methods.end(), [name](const auto &t) {
-        return std::get<0>(t).lexeme == name;
-    });
+// Look up an index by name, if there is one
+std::optional<uint32_t> find_index(const std::unordered_map<Symbol, uint32_t> &indices, Symbol name) {
+    auto index = indices.find(name);
+    if (index == indices.end())
+        return std::nullopt;
 
-    if (m != this->methods.end())
-        return std::get<1>(*m);
+    return index->second;
+}
+
+// If a name is used more than once, the first one is found (like searching the members in order)
+void StructType::index_members() {
+    this->prop_indices.clear();
+    this->method_indices.clear();
+
+    for (uint32_t i = 0; i < this->props.size(); i++) {
+        this->prop_indices.emplace(this->props[i].name.symbol, i);
+    }
 
-    return std::nullopt;
+    for (uint32_t i = 0; i < this->methods.size(); i++) {
+        this->method_indices.emplace(std::get<0>(this->methods[i]).symbol, i);
+    }
 }
 
-// Finds the the type of a property on a struct given the property name
-std::optional<OptionalTypeInfo> StructType::get_prop_type(std::string name) {
-    auto p = std::find_if(this->props.begin(), this->props.end(), [name](const auto &t) {
-        return t.name.lexeme == name;
-    });
+std::optional<uint32_t> StructType::prop_index(Symbol name) {
+    return find_index(this->prop_indices, name);
+}
 
-    if (p != this->props.end())
-        return OptionalTypeInfo{p->type, p->is_optional};
+// Finds the the type of a method on a struct given the method name (nullptr if there isn't one)
+Type *StructType::get_method_type(Symbol name) {
+    auto index = find_index(this->method_indices, name);
+    if (!index.has_value())
+        return nullptr;
 
-    return std::nullopt;
+    return std::get<1>(this->methods[index.value()]);
 }
 
-// Finds the the type of a method on an enum given the method name
-std::optional<std::shared_ptr<Type>> EnumType::get_method_type(std::string name) {
-    auto m = std::find_if(this->methods.begin(), this->methods.end(), [name](const auto &t) {
-        return std::get<0>(t).lexeme == name;
-    });
+// Finds the the type of a property on a struct given the property name
+std::optional<OptionalTypeInfo> StructType::get_prop_type(Symbol name) {
+    auto index = this->prop_index(name);
+    if (!index.has_value())
+        return std::nullopt;
 
-    if (m != this->methods.end())
-        return std::get<1>(*m);
+    auto &prop = this->props[index.value()];
+    return OptionalTypeInfo{prop.resolved_type, prop.is_optional};
+}
 
-    return std::nullopt;
+// Variants and methods are generated as `<enum>_<member>`
+std::string enum_member_cpp_name(std::string_view enum_name, std::string_view member_name) {
+    return std::string(enum_name) + "_" + std::string(member_name);
 }
 
-// Finds the type of an enum variant's payload given the variant name
-std::optional<OptionalTypeInfo> EnumType::get_variant_payload_type(std::string name) {
-    auto m = std::find_if(this->variants.begin(), this->variants.end(), [name](const auto &v) {
-        return v.name.lexeme == name;
-    });
+// If a name is used more than once, the first one is found (like searching the members in order)
+void EnumType::index_members() {
+    this->variant_indices.clear();
+    this->method_indices.clear();
+    this->variant_cpp_names.clear();
+    this->method_cpp_names.clear();
 
-    if (m != this->variants.end()) {
-        if (!m->payload_type.has_value())
-            return std::nullopt;
+    for (uint32_t i = 0; i < this->variants.size(); i++) {
+        this->variant_indices.emplace(this->variants[i].name.symbol, i);
+        this->variant_cpp_names.push_back(enum_member_cpp_name(this->name.lexeme, this->variants[i].name.lexeme));
+    }
 
-        return OptionalTypeInfo{m->payload_type.value(), m->is_optional};
+    for (uint32_t i = 0; i < this->methods.size(); i++) {
+        auto &method_name = std::get<0>(this->methods[i]);
+        this->method_indices.emplace(method_name.symbol, i);
+        this->method_cpp_names.push_back(enum_member_cpp_name(this->name.lexeme, method_name.lexeme));
     }
+}
+
+std::optional<uint32_t> EnumType::variant_index(Symbol name) {
+    return find_index(this->variant_indices, name);
+}
+
+std::optional<uint32_t> EnumType::method_index(Symbol name) {
+    return find_index(this->method_indices, name);
+}
+
+// Finds the the type of a method on an enum given the method name (nullptr if there isn't one)
+Type *EnumType::get_method_type(Symbol name) {
+    auto index = this->method_index(name);
+    if (!index.has_value())
+        return nullptr;
+
+    return std::get<1>(this->methods[index.value()]);
+}
+
+// Finds the type of an enum variant's payload given the variant name
+std::optional<OptionalTypeInfo> EnumType::get_variant_payload_type(Symbol name) {
+    auto index = this->variant_index(name);
+    if (!index.has_value())
+        return std::nullopt;
+
+    auto &variant = this->variants[index.value()];
+    if (!variant.payload_type.has_value())
+        return std::nullopt;
 
-    return std::nullopt;
+    return OptionalTypeInfo{variant.resolved_payload_type, variant.is_optional};
 }
@@ -1,16 +1,21 @@
 #pragma once
 
+#include "../ast/ast_arena.h"
 #include "../ast/enum_variant.h"
 #include "../ast/typed_var.h"
+#include "../scanner/symbol_table.h"
 #include "../scanner/token.h"
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 struct OptionalTypeInfo {
-    Token type;
+    Type *type;
     bool optional;
 };
 
@@ -33,7 +38,7 @@ struct Type {
 
     virtual ~Type() = default;
 
-    virtual bool can_coerce_to(std::shared_ptr<Type> t);
+    virtual bool can_coerce_to(Type *t);
     virtual std::string to_string() = 0;
 };
 
@@ -41,36 +46,48 @@ struct Type {
 
 // Primitive types will be unique
 struct IntType : public Type {
+    static const TypeClass CLASS = TypeClass::INT;
+
     IntType() : Type(TypeClass::INT) {}
 
     std::string to_string() override;
 };
 
 struct FloatType : public Type {
+    static const TypeClass CLASS = TypeClass::FLOAT;
+
     FloatType() : Type(TypeClass::FLOAT) {}
 
     std::string to_string() override;
 };
 
 struct BoolType : public Type {
+    static const TypeClass CLASS = TypeClass::BOOL;
+
     BoolType() : Type(TypeClass::BOOL) {}
 
     std::string to_string() override;
 };
 
 struct NullType : public Type {
+    static const TypeClass CLASS = TypeClass::NULL_;
+
     NullType() : Type(TypeClass::NULL_) {}
 
     std::string to_string() override;
 };
 
 struct StrType : public Type {
+    static const TypeClass CLASS = TypeClass::STR;
+
     StrType() : Type(TypeClass::STR) {}
 
     std::string to_string() override;
 };
 
 struct VoidType : public Type {
+    static const TypeClass CLASS = TypeClass::VOID;
+
     VoidType() : Type(TypeClass::VOID) {}
 
     std::string to_string() override;
@@ -78,40 +95,125 @@ struct VoidType : public Type {
 
 // There may be many function types with different parameters/return types
 struct FunctionType : public Type {
+    static const TypeClass CLASS = TypeClass::FUNC;
+
     Token name;
     std::vector<TypedVar> params;
-    Token return_type;
+    Type *return_type;
     bool return_type_optional;
 
-    FunctionType(Token name, std::vector<TypedVar> params, Token return_type, bool return_type_optional) : Type(TypeClass::FUNC), name(name), params(params), return_type(return_type), return_type_optional(return_type_optional) {}
+    FunctionType(Token name, std::vector<TypedVar> params, Type *return_type, bool return_type_optional) : Type(TypeClass::FUNC), name(name), params(params), return_type(return_type), return_type_optional(return_type_optional) {}
 
     std::string to_string() override;
 };
 
 // There may be many struct types with different properties/methods
 struct StructType : public Type {
+    static const TypeClass CLASS = TypeClass::STRUCT_;
+
     Token name;
     std::vector<TypedVar> props;
-    std::vector<std::tuple<Token, std::shared_ptr<Type>>> methods;
+    std::vector<std::tuple<Token, Type *>> methods;
 
-    StructType(Token name, std::vector<TypedVar> props, std::vector<std::tuple<Token, std::shared_ptr<Type>>> methods) : Type(TypeClass::STRUCT_), name(name), props(props), methods(methods) {}
+    // Position of each property and method above, by name
+    // NOTE: these get built by `index_members` once the type environment has filled in the members
+    std::unordered_map<Symbol, uint32_t> prop_indices;
+    std::unordered_map<Symbol, uint32_t> method_indices;
 
-    std::optional<std::shared_ptr<Type>> get_method_type(std::string name);
-    std::optional<OptionalTypeInfo> get_prop_type(std::string name);
+    StructType(Token name, std::vector<TypedVar> props, std::vector<std::tuple<Token, Type *>> methods) : Type(TypeClass::STRUCT_), name(name), props(props), methods(methods) {}
+
+    void index_members();
+    std::optional<uint32_t> prop_index(Symbol name);
+
+    Type *get_method_type(Symbol name);
+    std::optional<OptionalTypeInfo> get_prop_type(Symbol name);
 
     std::string to_string() override;
 };
 
 // There may be many enum types with different properties/methods
 struct EnumType : public Type {
+    static const TypeClass CLASS = TypeClass::ENUM_;
+
     Token name;
     std::vector<EnumVariant> variants;
-    std::vector<std::tuple<Token, std::shared_ptr<Type>>> methods;
+    std::vector<std::tuple<Token, Type *>> methods;
+
+    // Position of each variant and method above, by name
+    // NOTE: these get built by `index_members` once the type environment has filled in the members
+    std::unordered_map<Symbol, uint32_t> variant_indices;
+    std::unordered_map<Symbol, uint32_t> method_indices;
 
-    EnumType(Token name, std::vector<EnumVariant> variants, std::vector<std::tuple<Token, std::shared_ptr<Type>>> methods) : Type(TypeClass::ENUM_), name(name), variants(variants), methods(methods) {}
+    // Names of the C++ struct generated for each variant and function generated for each method, in the same
+    // order as above. These are inside the `Baz` namespace
+    std::vector<std::string> variant_cpp_names;
+    std::vector<std::string> method_cpp_names;
 
-    std::optional<std::shared_ptr<Type>> get_method_type(std::string name);
-    std::optional<OptionalTypeInfo> get_variant_payload_type(std::string name);
+    EnumType(Token name, std::vector<EnumVariant> variants, std::vector<std::tuple<Token, Type *>> methods) : Type(TypeClass::ENUM_), name(name), variants(variants), methods(methods) {}
+
+    void index_members();
+    std::optional<uint32_t> variant_index(Symbol name);
+    std::optional<uint32_t> method_index(Symbol name);
+
+    Type *get_method_type(Symbol name);
+    std::optional<OptionalTypeInfo> get_variant_payload_type(Symbol name);
 
     std::string to_string() override;
 };
+
+// Cast to a specific type, or nullptr if it is a different class of type (or there is no type)
+// Like `dynamic_cast`, but only compares the type class
+template <typename T>
+T *type_cast(Type *type) {
+    if (!type || type->type_class != T::CLASS)
+        return nullptr;
+
+    return static_cast<T *>(type);
+}
+
+// Owns every type in a compilation, and names the ones declared in the source
+//
+// Built by `TypeEnvironment`, then frozen - later passes only see it through a `const` reference, and refer
+// to types with plain `Type *` handles, which stay valid for as long as the table does
+class TypeTable {
+  private:
+    AstArena arena;
+    std::vector<NodePtr<Type>> types;
+
+    // Named types, indexed by the symbol of their name
+    SymbolMap<Type *> named;
+
+  public:
+    TypeTable() = default;
+
+    TypeTable(const TypeTable &) = delete;
+    TypeTable &operator=(const TypeTable &) = delete;
+
+    template <typename T, typename... Args>
+    T *make(Args &&...args) {
+        NodePtr<T> type = this->arena.make<T>(std::forward<Args>(args)...);
+        T *handle = type.get();
+        this->types.push_back(std::move(type));
+
+        return handle;
+    }
+
+    // Make a type that can be looked up by `name`, replacing any previous type with that name
+    template <typename T, typename... Args>
+    T *make_named(Symbol name, Args &&...args) {
+        T *handle = this->make<T>(std::forward<Args>(args)...);
+        this->named[name] = handle;
+
+        return handle;
+    }
+
+    // The type with this name, or nullptr if there isn't one
+    Type *operator[](Symbol name) const {
+        return this->named.get(name);
+    }
+
+    // One past the largest symbol that may name a type
+    size_t size() const {
+        return this->named.size();
+    }
+};
@@ -1,11 +1,12 @@
 #include "type_checker.h"
+#include "../ast/dispatch.h"
 #include "type.h"
 
 #include <algorithm>
 #include <iostream>
 #include <memory>
 
-bool can_coerce_to(std::shared_ptr<Type> from, bool from_optional, std::shared_ptr<Type> to, bool to_optional) {
+bool can_coerce_to(Type *from, bool from_optional, Type *to, bool to_optional) {
     // If going from an optional to non-optional, it cannot coerce
     if (from_optional && !to_optional) {
         return false;
@@ -19,26 +20,100 @@ bool can_coerce_to(std::shared_ptr<Type> from, bool from_optional, std::shared_p
     return from->can_coerce_to(to);
 }
 
-TypeChecker::TypeChecker(std::map<std::string, std::shared_ptr<Type>> type_env) : type_env(type_env), result(TypeInfo(nullptr, false)) {}
+TypeChecker::TypeChecker(const TypeTable &type_env) : type_env(type_env), result(TypeInfo(nullptr, false)), resolver(nullptr), defer_errors(false) {}
 
 bool TypeChecker::is_numeric(Type *t) {
-    return t->can_coerce_to(this->type_env["int"]) || t->can_coerce_to(this->type_env["float"]);
+    return t->can_coerce_to(this->type_env[SYM_INT]) || t->can_coerce_to(this->type_env[SYM_FLOAT]);
 }
 
 // Check all statements have valid types
-void TypeChecker::check(std::vector<std::unique_ptr<Stmt>> &stmts) {
+void TypeChecker::check(NodeList<Stmt> &stmts) {
     for (auto &stmt : stmts) {
-        stmt->accept(*this);
+        dispatch(stmt, *this);
     }
 }
 
+// Resolve names and check types in a single walk over the AST, instead of resolving all of it first
+//
+// Reports the same error as running the resolver then `check` would. Resolving errors come first, so if there
+// is a type error, the whole AST is resolved on its own before the type error is reported
+void TypeChecker::resolve_and_check(NodeList<Stmt> &stmts) {
+    Resolver resolver(this->type_env);
+    this->resolver = &resolver;
+    this->defer_errors = true;
+
+    try {
+        this->check(stmts);
+    } catch (TypeCheckerError) {
+        this->resolver = nullptr;
+        this->defer_errors = false;
+
+        // Exits if there is a resolving error anywhere
+        Resolver(this->type_env).resolve(stmts);
+
+        report(std::cerr, this->failure.value());
+        throw;
+    }
+
+    this->resolver = nullptr;
+    this->defer_errors = false;
+}
+
+// Check every function and method with its own checker, spread across the pool's threads
+//
+// Names must already be resolved. Bodies only read the type table, so can be checked at the same time, and the
+// error reported is the one checking them in order would have found
+void TypeChecker::check_parallel(NodeList<Stmt> &stmts, ThreadPool &pool) {
+    std::vector<Stmt *> bodies;
+    for (auto &stmt : stmts) {
+        if (auto s = node_cast<StructDeclStmt>(stmt.get())) {
+            for (auto &method : s->methods)
+                bodies.push_back(method.get());
+        } else if (auto e = node_cast<EnumDeclStmt>(stmt.get())) {
+            for (auto &method : e->methods)
+                bodies.push_back(method.get());
+        } else {
+            bodies.push_back(stmt.get());
+        }
+    }
+
+    std::vector<std::optional<Diagnostic>> failures(bodies.size());
+    pool.for_each(bodies.size(), [&](size_t i) {
+        failures[i] = TypeChecker(this->type_env).check_decl(bodies[i]);
+    });
+
+    for (auto &failure : failures) {
+        if (failure.has_value()) {
+            report(std::cerr, failure.value());
+            throw TypeCheckerError::OP_ON_INCOMPATIBLE_TYPES;
+        }
+    }
+}
+
+// Check one declaration on its own, giving back its type error (if there is one) rather than reporting it
+// Names must already be resolved
+std::optional<Diagnostic> TypeChecker::check_decl(Stmt *stmt) {
+    this->defer_errors = true;
+    this->failure.reset();
+
+    try {
+        dispatch(stmt, *this);
+    } catch (TypeCheckerError) {
+    }
+
+    this->defer_errors = false;
+    return std::move(this->failure);
+}
+
 // Error message with line number
-void TypeChecker::error(Token error_token, std::string message) {
-    std::string where = "end";
-    if (error_token.t != TokenType::EOF_)
-        where = "'" + error_token.lexeme + "'";
+void TypeChecker::error(Token error_token, DiagnosticCode code, std::initializer_list<DiagnosticArg> args) {
+    Diagnostic diagnostic(DiagnosticStage::TYPE, code, error_token, args);
 
-    std::cerr << "[line " << error_token.line << "] Type error at " << where << ": " << message << std::endl;
+    // Reported by the caller, e.g. as resolving errors later on come first (see `resolve_and_check`)
+    if (this->defer_errors)
+        this->failure = diagnostic;
+    else
+        report(std::cerr, diagnostic);
 
     throw TypeCheckerError::OP_ON_INCOMPATIBLE_TYPES;
 }
@@ -46,36 +121,49 @@ void TypeChecker::error(Token error_token, std::string message) {
 //// Expressions
 
 void TypeChecker::visit_var_expr(VarExpr *expr) {
+    if (this->resolver)
+        this->resolver->type_var_expr(expr);
+
     this->result = expr->get_type_info();
     expr->set_type_info(this->result);
     this->always_returns = false;
 }
 
 void TypeChecker::visit_struct_init_expr(StructInitExpr *expr) {
-    if (auto t = std::dynamic_pointer_cast<StructType>(expr->get_type_info().type)) {
-        if (expr->properties.size() != t->props.size())
-            this->error(expr->name, "Expected " + std::to_string(t->props.size()) + " arguments, received " + std::to_string(expr->properties.size()) + ".");
-
-        // Loop through in order of declared type props
-        for (auto &prop : t->props) {
-            auto name = prop.name.lexeme;
+    for (auto &prop : expr->properties) {
+        dispatch(std::get<1>(prop), *this);
+    }
 
-            // Find corresponding property
-            auto p = std::find_if(expr->properties.begin(), expr->properties.end(), [name](const auto &p) {
-                return std::get<0>(p).lexeme == name;
-            });
+    if (this->resolver)
+        this->resolver->type_struct_init_expr(expr);
 
-            if (p == expr->properties.end())
-                this->error(expr->name, "Missing property " + name + " from constructor.");
+    if (auto t = type_cast<StructType>(expr->get_type_info().type)) {
+        if (expr->properties.size() != t->props.size())
+            this->error(expr->name, DiagnosticCode::ARGUMENT_COUNT, {t->props.size(), expr->properties.size()});
+
+        // Find the initialiser for each property - if a property is given more than once, the first is used
+        std::vector<std::optional<uint32_t>> initialisers(t->props.size());
+        for (uint32_t i = 0; i < expr->properties.size(); i++) {
+            auto index = t->prop_index(std::get<0>(expr->properties[i]).symbol);
+            if (index.has_value() && !initialisers[index.value()].has_value())
+                initialisers[index.value()] = i;
+        }
 
-            auto from = std::get<1>(*p)->get_type_info();
-            auto to = this->type_env[prop.type.lexeme];
+        // Loop through in order of declared type props
+        for (uint32_t i = 0; i < t->props.size(); i++) {
+            auto &prop = t->props[i];
+            if (!initialisers[i].has_value())
+                this->error(expr->name, DiagnosticCode::MISSING_PROPERTY, {prop.name.lexeme});
+
+            auto &p = expr->properties[initialisers[i].value()];
+            auto from = std::get<1>(p)->get_type_info();
+            auto to = prop.resolved_type;
             if (!can_coerce_to(from.type, from.optional, to, prop.is_optional)) {
-                this->error(std::get<0>(*p), "Cannot assign a type '" + from.type->to_string() + (from.optional && from.type->type_class != TypeClass::NULL_ ? "?" : "") + "' to variable of type '" + to->to_string() + (prop.is_optional ? "?" : "") + "'.");
+                this->error(std::get<0>(p), DiagnosticCode::ASSIGN_INCOMPATIBLE_TYPE, {TypeArg{from.type, from.optional && from.type->type_class != TypeClass::NULL_}, TypeArg{to, prop.is_optional}});
             }
         }
     } else {
-        this->error(expr->name, "Cannot initialise non-struct.");
+        this->error(expr->name, DiagnosticCode::CANNOT_INITIALISE_NON_STRUCT);
     }
 
     this->result = expr->get_type_info();
@@ -90,18 +178,18 @@ void TypeChecker::visit_binary_expr(BinaryExpr *expr) {
         case TokenType::STAR:
         case TokenType::SLASH: {
             // Check left and right are the same type
-            expr->left->accept(*this);
+            dispatch(expr->left, *this);
             auto left_t = this->result;
 
             // If not numeric or string, we can't operate
-            if (left_t.optional || !(is_numeric(left_t.type.get()) || left_t.type.get()->type_class == TypeClass::STR))
-                this->error(expr->op, "Operator can only be used on numeric or string types.");
+            if (left_t.optional || !(is_numeric(left_t.type) || left_t.type->type_class == TypeClass::STR))
+                this->error(expr->op, DiagnosticCode::OPERATOR_NEEDS_NUMERIC_OR_STRING);
 
-            expr->right->accept(*this);
+            dispatch(expr->right, *this);
             auto right_t = this->result;
 
             if (!can_coerce_to(right_t.type, right_t.optional, left_t.type, left_t.optional))
-                this->error(expr->op, "Operands must be the same type, or coercible to the same type.");
+                this->error(expr->op, DiagnosticCode::OPERAND_TYPES_DIFFER);
 
             this->result = left_t;
             expr->set_type_info(this->result);
@@ -113,38 +201,38 @@ void TypeChecker::visit_binary_expr(BinaryExpr *expr) {
         case TokenType::GREATER:
         case TokenType::GREATER_EQUAL: {
             // Check left and right are the same type, and numeric
-            expr->left->accept(*this);
+            dispatch(expr->left, *this);
             auto left_t = this->result;
 
             // If not numeric, we can't compare
-            if (left_t.optional || !is_numeric(left_t.type.get()))
-                this->error(expr->op, "Operator can only be used on numeric types.");
+            if (left_t.optional || !is_numeric(left_t.type))
+                this->error(expr->op, DiagnosticCode::OPERATOR_NEEDS_NUMERIC);
 
-            expr->right->accept(*this);
+            dispatch(expr->right, *this);
             auto right_t = this->result;
 
             if (!can_coerce_to(right_t.type, right_t.optional, left_t.type, left_t.optional))
-                this->error(expr->op, "Operands must be the same type, or coercible to the same type.");
+                this->error(expr->op, DiagnosticCode::OPERAND_TYPES_DIFFER);
 
-            this->result = TypeInfo(this->type_env["bool"], false);
+            this->result = TypeInfo(this->type_env[SYM_BOOL], false);
             expr->set_type_info(this->result);
             this->always_returns = false;
             return;
         }
         case TokenType::QUESTION_QUESTION: {
             // Check left and right are the same type
-            expr->left->accept(*this);
+            dispatch(expr->left, *this);
             auto left_t = this->result;
 
-            expr->right->accept(*this);
+            dispatch(expr->right, *this);
             auto right_t = this->result;
 
             if (!left_t.optional)
-                this->error(expr->op, "Cannot use '\?\?' operator on a non-nullable type.");
+                this->error(expr->op, DiagnosticCode::FALLBACK_ON_NON_NULLABLE);
 
             // Has to coerce to non-nullable version of left type
             if (!can_coerce_to(right_t.type, right_t.optional, left_t.type, false))
-                this->error(expr->op, "Operands must be the same type, or coercible to the same type.");
+                this->error(expr->op, DiagnosticCode::OPERAND_TYPES_DIFFER);
 
             // Always go to non-optional form of left type
             this->result = left_t;
@@ -156,38 +244,38 @@ void TypeChecker::visit_binary_expr(BinaryExpr *expr) {
         }
         case TokenType::EQUAL_EQUAL:
         case TokenType::BANG_EQUAL:  {
-            expr->left->accept(*this);
+            dispatch(expr->left, *this);
             auto left_t = this->result;
 
-            expr->right->accept(*this);
+            dispatch(expr->right, *this);
             auto right_t = this->result;
 
             // Left can coerce to right or right to left
             if (!(can_coerce_to(right_t.type, right_t.optional, left_t.type, left_t.optional) || can_coerce_to(left_t.type, left_t.optional, right_t.type, right_t.optional)))
-                this->error(expr->op, "Operands must be the same type, or coercible to the same type.");
+                this->error(expr->op, DiagnosticCode::OPERAND_TYPES_DIFFER);
 
-            this->result = TypeInfo(this->type_env["bool"], false);
+            this->result = TypeInfo(this->type_env[SYM_BOOL], false);
             expr->set_type_info(this->result);
             this->always_returns = false;
             return;
         }
         case TokenType::AND:
         case TokenType::OR:  {
-            expr->left->accept(*this);
+            dispatch(expr->left, *this);
             auto left_t = this->result;
 
             auto from = this->result;
-            auto to = this->type_env["bool"];
+            auto to = this->type_env[SYM_BOOL];
             if (!can_coerce_to(from.type, from.optional, to, false))
-                this->error(expr->op, "Operator can only be used on boolean types.");
+                this->error(expr->op, DiagnosticCode::OPERATOR_NEEDS_BOOLEANS);
 
-            expr->right->accept(*this);
+            dispatch(expr->right, *this);
             auto right_t = this->result;
 
             if (left_t.type != right_t.type)
-                this->error(expr->op, "Operands must be the same type, or coercible to the same type.");
+                this->error(expr->op, DiagnosticCode::OPERAND_TYPES_DIFFER);
 
-            this->result = TypeInfo(this->type_env["bool"], false);
+            this->result = TypeInfo(this->type_env[SYM_BOOL], false);
             expr->set_type_info(this->result);
             this->always_returns = false;
             return;
@@ -199,22 +287,22 @@ void TypeChecker::visit_binary_expr(BinaryExpr *expr) {
 }
 
 void TypeChecker::visit_unary_expr(UnaryExpr *expr) {
-    expr->right->accept(*this);
+    dispatch(expr->right, *this);
 
     switch (expr->op.t) {
         case TokenType::BANG: {
             // If not boolean, we can't invert
             auto from = this->result;
-            auto to = this->type_env["bool"];
+            auto to = this->type_env[SYM_BOOL];
             if (!can_coerce_to(from.type, from.optional, to, false))
-                this->error(expr->op, "Operator can only be used on a boolean type.");
+                this->error(expr->op, DiagnosticCode::OPERATOR_NEEDS_BOOLEAN);
 
             break;
         }
         case TokenType::MINUS:
             // If not numeric, we can't invert
-            if (this->result.optional || !is_numeric(this->result.type.get()))
-                this->error(expr->op, "Operator can only be used on numeric types.");
+            if (this->result.optional || !is_numeric(this->result.type))
+                this->error(expr->op, DiagnosticCode::OPERATOR_NEEDS_NUMERIC);
             break;
         default:
             std::cerr << "[BUG] Unary operator type '" << get_token_type_str(expr->op.t) << "' not handled." << std::endl;
@@ -226,13 +314,16 @@ void TypeChecker::visit_unary_expr(UnaryExpr *expr) {
 }
 
 void TypeChecker::visit_get_expr(GetExpr *expr) {
-    expr->object->accept(*this);
+    dispatch(expr->object, *this);
+    if (this->resolver)
+        this->resolver->type_get_expr(expr);
+
     if (expr->optional && !this->result.optional) {
-        this->error(expr->name, "Cannot use optional chaining on non-optional type.");
+        this->error(expr->name, DiagnosticCode::OPTIONAL_CHAINING_ON_NON_OPTIONAL);
     }
 
     if (!expr->optional && this->result.optional) {
-        this->error(expr->name, "Must use optional chaining for optional type.");
+        this->error(expr->name, DiagnosticCode::MISSING_OPTIONAL_CHAINING);
     }
 
     this->result = expr->get_type_info();
@@ -241,22 +332,26 @@ void TypeChecker::visit_get_expr(GetExpr *expr) {
 }
 
 void TypeChecker::visit_enum_init_expr(EnumInitExpr *expr) {
+    if (expr->payload.has_value())
+        dispatch(expr->payload.value(), *this);
+
+    if (this->resolver)
+        this->resolver->type_enum_init_expr(expr);
+
     // Check payload if there is one
     if (expr->payload.has_value()) {
-        expr->payload.value()->accept(*this);
-
         // Cast to enum type (should always be enum type)
-        if (auto t = std::dynamic_pointer_cast<EnumType>(expr->get_type_info().type)) {
+        if (auto t = type_cast<EnumType>(expr->get_type_info().type)) {
             // Check type of payload for this variant
-            auto payload_type_info = t->get_variant_payload_type(expr->variant.lexeme);
-            auto payload_type = this->type_env[payload_type_info->type.lexeme];
+            auto payload_type_info = t->get_variant_payload_type(expr->variant.symbol);
+            auto payload_type = payload_type_info->type;
 
             if (!can_coerce_to(this->result.type, this->result.optional, payload_type, payload_type_info->optional)) {
-                this->error(expr->variant, "Payload of enum cannot be coerced to a valid type.");
+                this->error(expr->variant, DiagnosticCode::INVALID_PAYLOAD_TYPE);
             }
 
             if (this->result.optional && !payload_type_info->optional) {
-                this->error(expr->variant, "Expected non-optional type. Received optional type.");
+                this->error(expr->variant, DiagnosticCode::UNEXPECTED_OPTIONAL);
             }
         } else {
             std::cerr << "[BUG] Enum doesn't have enum type" << std::endl;
@@ -270,28 +365,30 @@ void TypeChecker::visit_enum_init_expr(EnumInitExpr *expr) {
 }
 
 void TypeChecker::visit_call_expr(CallExpr *expr) {
-    expr->callee->accept(*this);
+    dispatch(expr->callee, *this);
+    if (this->resolver)
+        this->resolver->type_call_expr(expr);
 
     // Check we are calling a function
-    auto t = std::dynamic_pointer_cast<FunctionType>(expr->callee->get_type_info().type);
+    auto t = type_cast<FunctionType>(expr->callee->get_type_info().type);
     if (!t) {
-        this->error(expr->bracket, "Cannot call non-function.");
+        this->error(expr->bracket, DiagnosticCode::CANNOT_CALL_NON_FUNCTION);
     }
 
     // Check the number of arguments equals the number of parameters
     if (expr->args.size() != t->params.size()) {
-        this->error(expr->bracket, "Expected " + std::to_string(t->params.size()) + " arguments, received " + std::to_string(expr->args.size()) + ".");
+        this->error(expr->bracket, DiagnosticCode::ARGUMENT_COUNT, {t->params.size(), expr->args.size()});
     }
 
     // Check that all parameters have the correct type
     for (int i = 0; i < expr->args.size(); i++) {
-        expr->args[i]->accept(*this);
-        if (!this->result.type->can_coerce_to(this->type_env[t->params[i].type.lexeme])) {
-            this->error(expr->bracket, "Invalid type passed to function.");
+        dispatch(expr->args[i], *this);
+        if (!this->result.type->can_coerce_to(t->params[i].resolved_type)) {
+            this->error(expr->bracket, DiagnosticCode::INVALID_TYPE_PASSED_TO_FUNCTION);
         }
 
         if (this->result.optional && !t->params[i].is_optional) {
-            this->error(expr->bracket, "Expected non-optional type. Received optional type.");
+            this->error(expr->bracket, DiagnosticCode::UNEXPECTED_OPTIONAL);
         }
     }
 
@@ -304,12 +401,15 @@ void TypeChecker::visit_call_expr(CallExpr *expr) {
 }
 
 void TypeChecker::visit_grouping_expr(GroupingExpr *expr) {
-    expr->expr->accept(*this);
+    dispatch(expr->expr, *this);
     expr->set_type_info(this->result);
     this->always_returns = false;
 }
 
 void TypeChecker::visit_literal_expr(LiteralExpr *expr) {
+    if (this->resolver)
+        this->resolver->type_literal_expr(expr);
+
     this->result = expr->get_type_info();
     expr->set_type_info(this->result);
     this->always_returns = false;
@@ -318,100 +418,140 @@ void TypeChecker::visit_literal_expr(LiteralExpr *expr) {
 //// Statements
 
 void TypeChecker::visit_fun_decl_stmt(FunDeclStmt *fun) {
+    if (this->resolver)
+        this->resolver->begin_function(fun);
+
+    this->check_function(fun);
+
+    if (this->resolver)
+        this->resolver->end_scope();
+}
+
+void TypeChecker::check_function(FunDeclStmt *fun) {
     auto prev_fn_ret_type = this->surrounding_fn_return_type;
     this->surrounding_fn_return_type = OptionalTypeInfo{
-        fun->return_type,
+        fun->type->return_type,
         fun->return_type_optional,
     };
 
     // Ensure at least one line of the body returns
     bool returns = false;
-    for (auto &s : fun->body) {
-        s->accept(*this);
+    for (auto &s : fun->get_body()) {
+        dispatch(s, *this);
         returns = returns || this->always_returns;
     }
 
     this->surrounding_fn_return_type = prev_fn_ret_type;
 
     // If not void, it must return a value from every path
-    if (fun->return_type.lexeme != "void" && !returns) {
-        this->error(fun->name, "Not all code paths return.");
+    if (fun->return_type.symbol != SYM_VOID && !returns) {
+        this->error(fun->name, DiagnosticCode::NOT_ALL_CODE_PATHS_RETURN);
     }
 
     this->always_returns = false;
 }
 
 void TypeChecker::visit_enum_method_decl_stmt(EnumMethodDeclStmt *fun) {
-    fun->fun_definition->accept(*this);
+    if (this->resolver)
+        this->resolver->begin_enum_method(fun);
+
+    this->check_function(fun->fun_definition.get());
+
+    if (this->resolver)
+        this->resolver->end_scope();
 
     this->always_returns = false;
 }
 
 void TypeChecker::visit_struct_decl_stmt(StructDeclStmt *stmt) {
+    if (this->resolver)
+        this->resolver->begin_struct(stmt);
+
     for (auto &method : stmt->methods) {
-        method->accept(*this);
+        dispatch(method, *this);
     }
 
+    if (this->resolver)
+        this->resolver->end_scope();
+
     this->always_returns = false;
 }
 
 void TypeChecker::visit_enum_decl_stmt(EnumDeclStmt *stmt) {
+    if (this->resolver)
+        this->resolver->begin_enum(stmt);
+
     for (auto &method : stmt->methods) {
-        method->accept(*this);
+        dispatch(method, *this);
     }
 
+    if (this->resolver)
+        this->resolver->end_scope();
+
     this->always_returns = false;
 }
 
 void TypeChecker::visit_variable_decl_stmt(VariableDeclStmt *stmt) {
-    stmt->initialiser->accept(*this);
+    if (this->resolver)
+        this->resolver->declare_variable(stmt);
+
+    dispatch(stmt->initialiser, *this);
+
+    if (this->resolver)
+        this->resolver->define(stmt->name.name.symbol);
 
     auto from = this->result;
-    auto to = this->type_env[stmt->name.type.lexeme];
+    auto to = stmt->name.resolved_type;
     if (!can_coerce_to(from.type, from.optional, to, stmt->name.is_optional)) {
-        this->error(stmt->name.name, "Cannot assign a type '" + from.type->to_string() + (from.optional && from.type->type_class != TypeClass::NULL_ ? "?" : "") + "' to variable of type '" + to->to_string() + (stmt->name.is_optional ? "?" : "") + "'.");
+        this->error(stmt->name.name, DiagnosticCode::ASSIGN_INCOMPATIBLE_TYPE, {TypeArg{from.type, from.optional && from.type->type_class != TypeClass::NULL_}, TypeArg{to, stmt->name.is_optional}});
     }
 
     this->always_returns = false;
 }
 
 void TypeChecker::visit_expr_stmt(ExprStmt *stmt) {
-    stmt->expr->accept(*this);
+    dispatch(stmt->expr, *this);
     this->always_returns = false;
 }
 
 void TypeChecker::visit_block_stmt(BlockStmt *stmt) {
+    if (this->resolver)
+        this->resolver->begin_scope();
+
     bool returns = false;
 
     for (auto &s : stmt->stmts) {
-        s->accept(*this);
+        dispatch(s, *this);
 
         // If any statement always returns, the block always returns
         returns = returns || this->always_returns;
     }
 
+    if (this->resolver)
+        this->resolver->end_scope();
+
     this->always_returns = returns;
 }
 
 void TypeChecker::visit_if_stmt(IfStmt *stmt) {
-    stmt->condition->accept(*this);
+    dispatch(stmt->condition, *this);
 
     auto from = this->result;
-    auto to = this->type_env["bool"];
+    auto to = this->type_env[SYM_BOOL];
     if (!can_coerce_to(from.type, from.optional, to, false)) {
-        this->error(stmt->keyword, "If condition must be a boolean value.");
+        this->error(stmt->keyword, DiagnosticCode::NON_BOOLEAN_IF_CONDITION);
     }
 
     bool true_block_returns = false;
     for (auto &line : stmt->true_block) {
-        line->accept(*this);
+        dispatch(line, *this);
         true_block_returns = true_block_returns || this->always_returns;
     }
 
     bool false_block_returns = false;
     if (stmt->false_block.has_value()) {
         for (auto &line : stmt->false_block.value()) {
-            line->accept(*this);
+            dispatch(line, *this);
             false_block_returns = false_block_returns || this->always_returns;
         }
     }
@@ -422,15 +562,21 @@ void TypeChecker::visit_if_stmt(IfStmt *stmt) {
 void TypeChecker::visit_match_stmt(MatchStmt *stmt) {
     bool all_branches_return = true;
 
-    auto t = std::dynamic_pointer_cast<EnumType>(stmt->target->get_type_info().type);
+    // The target is only resolved, not checked
+    if (this->resolver) {
+        this->resolver->resolve(stmt->target.get());
+        this->resolver->check_match_target(stmt);
+    }
+
+    auto t = type_cast<EnumType>(stmt->target->get_type_info().type);
     if (!(t || stmt->target->get_type_info().optional)) {
-        this->error(stmt->keyword, "Can only match on enum or optional.");
+        this->error(stmt->keyword, DiagnosticCode::MATCH_ON_NON_ENUM);
     }
 
     if (t) {
         // Enum
         if (stmt->branches.size() != (t->variants.size() + (stmt->target->get_type_info().optional ? 1 : 0))) {
-            this->error(stmt->keyword, "Not all variants covered in pattern matching.");
+            this->error(stmt->keyword, DiagnosticCode::VARIANTS_NOT_COVERED);
         }
 
         bool has_null_branch = false;
@@ -438,37 +584,37 @@ void TypeChecker::visit_match_stmt(MatchStmt *stmt) {
             if (std::holds_alternative<EnumPattern>(branch.pattern)) {
                 // Check that match pattern is valid and matches the type of the target
                 auto &enum_pattern = std::get<EnumPattern>(branch.pattern);
-                if (enum_pattern.enum_type.lexeme != t->name.lexeme) {
-                    this->error(enum_pattern.enum_type, "Match pattern must be for the same enum type.");
+                if (enum_pattern.enum_type.symbol != t->name.symbol) {
+                    this->error(enum_pattern.enum_type, DiagnosticCode::PATTERN_FOR_DIFFERENT_ENUM);
                 }
 
-                auto variant_name = enum_pattern.enum_variant.lexeme;
-                auto v = std::find_if(t->variants.begin(), t->variants.end(), [variant_name](const auto &v) {
-                    return v.name.lexeme == variant_name;
-                });
-
-                if (v == t->variants.end()) {
-                    this->error(enum_pattern.enum_type, "Could not find variant on enum type.");
+                auto index = t->variant_index(enum_pattern.enum_variant.symbol);
+                if (!index.has_value()) {
+                    this->error(enum_pattern.enum_type, DiagnosticCode::UNKNOWN_MATCH_VARIANT);
                 }
 
-                if (v->payload_type.has_value()) {
+                auto &v = t->variants[index.value()];
+                if (v.payload_type.has_value()) {
                     if (!enum_pattern.bound_variable.has_value()) {
-                        this->error(enum_pattern.enum_variant, "Enum variant expects payload.");
+                        this->error(enum_pattern.enum_variant, DiagnosticCode::VARIANT_EXPECTS_PAYLOAD);
                     }
                 } else {
                     if (enum_pattern.bound_variable.has_value()) {
-                        this->error(enum_pattern.enum_type, "No payload available for this enum variant.");
+                        this->error(enum_pattern.enum_type, DiagnosticCode::VARIANT_HAS_NO_PAYLOAD);
                     }
                 }
             } else if (std::holds_alternative<NullPattern>(branch.pattern)) {
                 has_null_branch = true;
             } else {
-                this->error(stmt->keyword, "Can only match enum variant or null on enum.");
+                this->error(stmt->keyword, DiagnosticCode::INVALID_ENUM_PATTERN);
             }
 
+            if (this->resolver)
+                this->resolver->bind_pattern(stmt, branch);
+
             bool returns = false;
             for (auto &line : branch.body) {
-                line->accept(*this);
+                dispatch(line, *this);
                 returns = returns || this->always_returns;
             }
 
@@ -477,14 +623,14 @@ void TypeChecker::visit_match_stmt(MatchStmt *stmt) {
         }
 
         if (stmt->target->get_type_info().optional && !has_null_branch) {
-            this->error(stmt->keyword, "Null variant not provided.");
+            this->error(stmt->keyword, DiagnosticCode::NULL_VARIANT_NOT_PROVIDED);
         }
 
         this->always_returns = all_branches_return;
     } else {
         // Either null or bound variable
         if (stmt->branches.size() != 2) {
-            this->error(stmt->keyword, "Not all variants covered in pattern matching.");
+            this->error(stmt->keyword, DiagnosticCode::VARIANTS_NOT_COVERED);
         }
 
         bool has_null_branch = false;
@@ -495,12 +641,15 @@ void TypeChecker::visit_match_stmt(MatchStmt *stmt) {
             } else if (std::holds_alternative<NullPattern>(branch.pattern)) {
                 has_null_branch = true;
             } else {
-                this->error(stmt->keyword, "Can only match existing or null on enum.");
+                this->error(stmt->keyword, DiagnosticCode::INVALID_OPTIONAL_PATTERN);
             }
 
+            if (this->resolver)
+                this->resolver->bind_pattern(stmt, branch);
+
             bool returns = false;
             for (auto &line : branch.body) {
-                line->accept(*this);
+                dispatch(line, *this);
                 returns = returns || this->always_returns;
             }
 
@@ -509,7 +658,7 @@ void TypeChecker::visit_match_stmt(MatchStmt *stmt) {
         }
 
         if (!has_null_branch || !has_catch_all_branch) {
-            this->error(stmt->keyword, "Not all variants covered in pattern matching.");
+            this->error(stmt->keyword, DiagnosticCode::VARIANTS_NOT_COVERED);
         }
 
         this->always_returns = all_branches_return;
@@ -517,17 +666,17 @@ void TypeChecker::visit_match_stmt(MatchStmt *stmt) {
 }
 
 void TypeChecker::visit_while_stmt(WhileStmt *stmt) {
-    stmt->condition->accept(*this);
+    dispatch(stmt->condition, *this);
 
     auto from = this->result;
-    auto to = this->type_env["bool"];
+    auto to = this->type_env[SYM_BOOL];
     if (!can_coerce_to(from.type, from.optional, to, false)) {
-        this->error(stmt->keyword, "While condition must be a boolean value.");
+        this->error(stmt->keyword, DiagnosticCode::NON_BOOLEAN_WHILE_CONDITION);
     }
 
     bool returns = false;
     for (auto &s : stmt->stmts) {
-        s->accept(*this);
+        dispatch(s, *this);
         returns = returns || this->always_returns;
     }
 
@@ -535,13 +684,13 @@ void TypeChecker::visit_while_stmt(WhileStmt *stmt) {
 }
 
 void TypeChecker::visit_for_stmt(ForStmt *stmt) {
-    stmt->var->accept(*this);
-    stmt->condition->accept(*this);
-    stmt->increment->accept(*this);
+    dispatch(stmt->var, *this);
+    dispatch(stmt->condition, *this);
+    dispatch(stmt->increment, *this);
 
     bool returns = false;
     for (auto &s : stmt->stmts) {
-        s->accept(*this);
+        dispatch(s, *this);
         returns = returns || this->always_returns;
     }
 
@@ -550,32 +699,32 @@ void TypeChecker::visit_for_stmt(ForStmt *stmt) {
 
 void TypeChecker::visit_print_stmt(PrintStmt *stmt) {
     if (stmt->expr.has_value())
-        stmt->expr.value()->accept(*this);
+        dispatch(stmt->expr.value(), *this);
 
     this->always_returns = false;
 }
 
 void TypeChecker::visit_panic_stmt(PanicStmt *stmt) {
     if (stmt->expr.has_value())
-        stmt->expr.value()->accept(*this);
+        dispatch(stmt->expr.value(), *this);
 
     this->always_returns = true;
 }
 
 void TypeChecker::visit_return_stmt(ReturnStmt *stmt) {
     if (!this->surrounding_fn_return_type.has_value()) {
-        this->error(stmt->keyword, "Cannot return from outside of a function.");
+        this->error(stmt->keyword, DiagnosticCode::RETURN_OUTSIDE_FUNCTION);
     }
 
     if (stmt->expr.has_value()) {
-        stmt->expr.value()->accept(*this);
+        dispatch(stmt->expr.value(), *this);
 
-        if (!can_coerce_to(this->result.type, this->result.optional, this->type_env[this->surrounding_fn_return_type->type.lexeme], this->surrounding_fn_return_type->optional)) {
-            this->error(stmt->keyword, "Must return a type that equals or can coerce to the return type of the function.");
+        if (!can_coerce_to(this->result.type, this->result.optional, this->surrounding_fn_return_type->type, this->surrounding_fn_return_type->optional)) {
+            this->error(stmt->keyword, DiagnosticCode::RETURN_TYPE_MISMATCH);
         }
     } else {
-        if (this->surrounding_fn_return_type->type.lexeme != "void") {
-            this->error(stmt->keyword, "Must return a value from a non-void function.");
+        if (this->surrounding_fn_return_type->type != this->type_env[SYM_VOID]) {
+            this->error(stmt->keyword, DiagnosticCode::MISSING_RETURN_VALUE);
         }
     }
 
@@ -583,24 +732,32 @@ void TypeChecker::visit_return_stmt(ReturnStmt *stmt) {
 }
 
 void TypeChecker::visit_assign_stmt(AssignStmt *stmt) {
-    stmt->value->accept(*this);
+    dispatch(stmt->value, *this);
+    if (this->resolver)
+        this->resolver->resolve_assign_target(stmt);
 
     auto from = this->result;
     auto to = stmt->get_target_type_info();
     if (!can_coerce_to(from.type, from.optional, to.type, to.optional)) {
-        this->error(stmt->name, "Cannot assign a different type to this variable.");
+        this->error(stmt->name, DiagnosticCode::ASSIGN_DIFFERENT_TYPE);
     }
 
     this->always_returns = false;
 }
 
 void TypeChecker::visit_set_stmt(SetStmt *stmt) {
-    stmt->value->accept(*this);
+    dispatch(stmt->value, *this);
+
+    // The object is only resolved, not checked
+    if (this->resolver) {
+        this->resolver->resolve(stmt->object.get());
+        this->resolver->resolve_set_target(stmt);
+    }
 
     auto from = this->result;
     auto to = stmt->get_target_type_info();
     if (!can_coerce_to(from.type, from.optional, to.type, to.optional)) {
-        this->error(stmt->name, "Cannot assign a different type to this variable.");
+        this->error(stmt->name, DiagnosticCode::ASSIGN_DIFFERENT_TYPE);
     }
 
     this->always_returns = false;
@@ -2,6 +2,9 @@
 
 #include "../ast/expr_visitor.h"
 #include "../ast/stmt_visitor.h"
+#include "../diagnostics/diagnostic.h"
+#include "../util/thread_pool.h"
+#include "resolver.h"
 #include "type.h"
 
 #include <fstream>
@@ -13,20 +16,33 @@ enum TypeCheckerError {
     OP_ON_INCOMPATIBLE_TYPES,
 };
 
-class TypeChecker : public ExprVisitor, public StmtVisitor {
+class TypeChecker final : public ExprVisitor, public StmtVisitor {
   private:
     TypeInfo result;
-    std::map<std::string, std::shared_ptr<Type>> type_env;
+    const TypeTable &type_env;
     std::optional<OptionalTypeInfo> surrounding_fn_return_type;
 
     bool always_returns;
 
+    // Resolves names as the checker goes, when running `resolve_and_check`
+    // Otherwise nullptr, and the resolver must have already been run
+    Resolver *resolver;
+
+    // When set, the first type error is kept in `failure` for the caller to report, instead of being reported
+    bool defer_errors;
+    std::optional<Diagnostic> failure;
+
+    void check_function(FunDeclStmt *fun);
+
   public:
-    TypeChecker(std::map<std::string, std::shared_ptr<Type>> type_env);
+    TypeChecker(const TypeTable &type_env);
 
-    void check(std::vector<std::unique_ptr<Stmt>> &stmts);
+    void check(NodeList<Stmt> &stmts);
+    void resolve_and_check(NodeList<Stmt> &stmts);
+    void check_parallel(NodeList<Stmt> &stmts, ThreadPool &pool);
+    std::optional<Diagnostic> check_decl(Stmt *stmt);
 
-    void error(Token t, std::string message);
+    void error(Token t, DiagnosticCode code, std::initializer_list<DiagnosticArg> args = {});
 
     bool is_numeric(Type *t);
 
@@ -1,4 +1,5 @@
 #include "type_environment.h"
+#include "../ast/dispatch.h"
 
 #include <iostream>
 #include <memory>
@@ -7,66 +8,140 @@
 
 TypeEnvironment::TypeEnvironment() {
     // Add primitives
-    this->type_env["int"] = std::make_unique<IntType>();
-    this->type_env["float"] = std::make_unique<FloatType>();
-    this->type_env["bool"] = std::make_unique<BoolType>();
-    this->type_env["null"] = std::make_unique<NullType>();
-    this->type_env["str"] = std::make_unique<StrType>();
-    this->type_env["void"] = std::make_unique<VoidType>();
+    this->type_env.make_named<IntType>(SYM_INT);
+    this->type_env.make_named<FloatType>(SYM_FLOAT);
+    this->type_env.make_named<BoolType>(SYM_BOOL);
+    this->type_env.make_named<NullType>(SYM_NULL);
+    this->type_env.make_named<StrType>(SYM_STR);
+    this->type_env.make_named<VoidType>(SYM_VOID);
 }
 
-void TypeEnvironment::generate_type_env(std::vector<std::unique_ptr<Stmt>> &stmts) {
+void TypeEnvironment::generate_type_env(NodeList<Stmt> &stmts) {
+    // Name all user defined types first, so declarations can refer to types declared after them
     for (auto &stmt : stmts) {
-        stmt->accept(*this);
+        this->add_type_name(stmt.get());
     }
+
+    this->add_signatures(stmts);
+}
+
+// Name the type a struct or enum declares, leaving its members to be filled in by `add_signatures`
+void TypeEnvironment::add_type_name(Stmt *stmt) {
+    std::vector<std::tuple<Token, Type *>> methods;
+    if (auto s = node_cast<StructDeclStmt>(stmt)) {
+        this->type_env.make_named<StructType>(s->name.symbol, s->name, std::vector<TypedVar>(), methods);
+    } else if (auto e = node_cast<EnumDeclStmt>(stmt)) {
+        this->type_env.make_named<EnumType>(e->name.symbol, e->name, std::vector<EnumVariant>(), methods);
+    }
+}
+
+void TypeEnvironment::add_signatures(NodeList<Stmt> &stmts) {
+    for (auto &stmt : stmts) {
+        dispatch(stmt, *this);
+    }
+}
+
+// Copy the types resolved for the parameters of a function declaration, along with its own type
+static void reuse_function_type(FunDeclStmt *signature, FunDeclStmt *fun) {
+    fun->type = signature->type;
+    for (size_t i = 0; i < fun->params.size(); i++) {
+        fun->params[i].resolved_type = signature->params[i].resolved_type;
+    }
+}
+
+void TypeEnvironment::reuse_signature(Stmt *signature, Stmt *stmt) {
+    if (auto fun = node_cast<FunDeclStmt>(stmt)) {
+        reuse_function_type(node_cast<FunDeclStmt>(signature), fun);
+    } else if (auto s = node_cast<StructDeclStmt>(stmt)) {
+        auto original = node_cast<StructDeclStmt>(signature);
+        for (size_t i = 0; i < s->properties.size(); i++) {
+            s->properties[i].resolved_type = original->properties[i].resolved_type;
+        }
+
+        for (size_t i = 0; i < s->methods.size(); i++) {
+            reuse_function_type(original->methods[i].get(), s->methods[i].get());
+        }
+    } else if (auto e = node_cast<EnumDeclStmt>(stmt)) {
+        auto original = node_cast<EnumDeclStmt>(signature);
+        for (size_t i = 0; i < e->variants.size(); i++) {
+            e->variants[i].resolved_payload_type = original->variants[i].resolved_payload_type;
+        }
+
+        for (size_t i = 0; i < e->methods.size(); i++) {
+            reuse_function_type(original->methods[i]->fun_definition.get(), e->methods[i]->fun_definition.get());
+        }
+    }
+}
+
+void TypeEnvironment::resolve(TypedVar &var) {
+    var.resolved_type = this->type_env[var.type.symbol];
+}
+
+FunctionType *TypeEnvironment::function_type(Token name, FunDeclStmt *fun) {
+    for (auto &param : fun->params) {
+        this->resolve(param);
+    }
+
+    return this->type_env.make<FunctionType>(
+        name,
+        fun->params,
+        this->type_env[fun->return_type.symbol],
+        fun->return_type_optional);
 }
 
 //// Statements
 
-// Do nothing - no new type
-void TypeEnvironment::visit_fun_decl_stmt(FunDeclStmt *stmt) {}
+void TypeEnvironment::visit_fun_decl_stmt(FunDeclStmt *stmt) {
+    stmt->type = this->function_type(stmt->name, stmt);
+}
 
-// Do nothing - no new type
+// Do nothing - handled by the enum declaration
 void TypeEnvironment::visit_enum_method_decl_stmt(EnumMethodDeclStmt *stmt) {}
 
 // User defined struct type
 void TypeEnvironment::visit_struct_decl_stmt(StructDeclStmt *stmt) {
-    std::vector<std::tuple<Token, std::shared_ptr<Type>>> methods;
-    this->type_env[stmt->name.lexeme] = std::make_unique<StructType>(stmt->name, stmt->properties, methods);
-
-    auto t = std::dynamic_pointer_cast<StructType>(this->type_env[stmt->name.lexeme]);
+    auto t = type_cast<StructType>(this->type_env[stmt->name.symbol]);
     if (!t)
         std::cerr << "[BUG] Struct does not have struct type";
 
+    for (auto &prop : stmt->properties) {
+        this->resolve(prop);
+    }
+
+    t->props = stmt->properties;
+
     for (auto &method : stmt->methods) {
-        std::shared_ptr<Type> func_type = std::make_unique<FunctionType>(
-            stmt->name,
-            method->params,
-            method->return_type,
-            method->return_type_optional);
+        method->type = this->function_type(method->name, method.get());
 
-        t->methods.push_back(std::make_tuple(method->name, func_type));
+        // Method types found through the struct are named after the struct
+        t->methods.push_back(std::make_tuple(method->name, this->function_type(stmt->name, method.get())));
     }
+
+    t->index_members();
 }
 
-// User defined email
+// User defined enum
 void TypeEnvironment::visit_enum_decl_stmt(EnumDeclStmt *stmt) {
-    std::vector<std::tuple<Token, std::shared_ptr<Type>>> methods;
-    this->type_env[stmt->name.lexeme] = std::make_unique<EnumType>(stmt->name, stmt->variants, methods);
-
-    auto t = std::dynamic_pointer_cast<EnumType>(this->type_env[stmt->name.lexeme]);
+    auto t = type_cast<EnumType>(this->type_env[stmt->name.symbol]);
     if (!t)
         std::cerr << "[BUG] Enum does not have enum type";
 
+    for (auto &variant : stmt->variants) {
+        if (variant.payload_type.has_value())
+            variant.resolved_payload_type = this->type_env[variant.payload_type.value().symbol];
+    }
+
+    t->variants = stmt->variants;
+
     for (auto &method : stmt->methods) {
-        std::shared_ptr<Type> func_type = std::make_unique<FunctionType>(
-            stmt->name,
-            method->fun_definition->params,
-            method->fun_definition->return_type,
-            method->fun_definition->return_type_optional);
+        auto &fun = method->fun_definition;
+        fun->type = this->function_type(fun->name, fun.get());
 
-        t->methods.push_back(std::make_tuple(method->fun_definition->name, func_type));
+        // Method types found through the enum are named after the enum
+        t->methods.push_back(std::make_tuple(fun->name, this->function_type(stmt->name, fun.get())));
     }
+
+    t->index_members();
 }
 
 //// These are "unimplemented" as the type environment only checks top level, so should never reach these
@@ -10,13 +10,31 @@
 #include <string>
 
 // Only implements `StmtVisitor` as it does not need to check expressions
-class TypeEnvironment : public StmtVisitor {
+//
+// Every type name in a declaration is resolved to a `Type *` here, once, so later passes never look them up again
+class TypeEnvironment final : public StmtVisitor {
+  private:
+    // Point a typed variable at the type it names
+    void resolve(TypedVar &var);
+
+    // Make the type of a function, resolving its parameters
+    FunctionType *function_type(Token name, FunDeclStmt *fun);
+
   public:
-    std::map<std::string, std::shared_ptr<Type>> type_env;
+    TypeTable type_env;
 
     TypeEnvironment();
 
-    void generate_type_env(std::vector<std::unique_ptr<Stmt>> &stmts);
+    void generate_type_env(NodeList<Stmt> &stmts);
+
+    // The two halves of `generate_type_env`, for when declarations arrive one at a time
+    // Every type must be named before any signature is added, as declarations can refer to types declared after them
+    void add_type_name(Stmt *stmt);
+    void add_signatures(NodeList<Stmt> &stmts);
+
+    // Give `stmt` the types already added for `signature`, an earlier parse of the same declaration
+    // Lets a declaration be parsed again, without adding anything more to the type environment
+    void reuse_signature(Stmt *signature, Stmt *stmt);
 
     void visit_fun_decl_stmt(FunDeclStmt *stmt);
     void visit_enum_method_decl_stmt(EnumMethodDeclStmt *stmt);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Queue for handing items from one thread to another, in the order they were pushed
+template <typename T>
+class BlockingQueue {
+  private:
+    std::deque<T> items;
+    bool closed = false;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+
+  public:
+    void push(T item) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->items.push_back(std::move(item));
+        }
+
+        this->ready.notify_one();
+    }
+
+    // Nothing more will be pushed, so `pop` stops waiting once the queue is empty
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->closed = true;
+        }
+
+        this->ready.notify_all();
+    }
+
+    // Wait for the next item, or nothing once the queue is closed and empty
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->ready.wait(lock, [&]() { return this->closed || !this->items.empty(); });
+
+        if (this->items.empty())
+            return std::nullopt;
+
+        T item = std::move(this->items.front());
+        this->items.pop_front();
+        return item;
+    }
+};
@@ -0,0 +1,36 @@
+#include "content_hash.h"
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+ContentHash::ContentHash() : hash(FNV_OFFSET_BASIS) {}
+
+ContentHash &ContentHash::update(std::string_view data) {
+    for (unsigned char c : data) {
+        this->hash ^= c;
+        this->hash *= FNV_PRIME;
+    }
+
+    uint64_t length = data.length();
+    for (size_t i = 0; i < sizeof(length); i++) {
+        this->hash ^= (length >> (i * 8)) & 0xff;
+        this->hash *= FNV_PRIME;
+    }
+
+    return *this;
+}
+
+uint64_t ContentHash::value() const {
+    return this->hash;
+}
+
+std::string ContentHash::hex() const {
+    const char *digits = "0123456789abcdef";
+
+    std::string hex(16, '0');
+    for (size_t i = 0; i < hex.length(); i++) {
+        hex[hex.length() - 1 - i] = digits[(this->hash >> (i * 4)) & 0xf];
+    }
+
+    return hex;
+}
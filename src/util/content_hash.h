@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 64-bit FNV-1a hash, used to name cache entries after what they were built from
+//
+// Not cryptographic - it only has to tell apart the inputs a single machine builds
+class ContentHash {
+  private:
+    uint64_t hash;
+
+  public:
+    ContentHash();
+
+    // Each piece is followed by its length, so splitting the same bytes differently gives a different hash
+    ContentHash &update(std::string_view data);
+
+    uint64_t value() const;
+
+    // The hash as 16 hex digits, for use as a file name
+    std::string hex() const;
+};
@@ -0,0 +1,75 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t thread_count) : job(nullptr), job_count(0), next_job(0), running(0), batch(0), stopping(false) {
+    for (size_t i = 1; i < thread_count; i++) {
+        this->workers.emplace_back([this]() { this->work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+
+    this->work_ready.notify_all();
+    for (auto &worker : this->workers)
+        worker.join();
+}
+
+size_t ThreadPool::size() const {
+    return this->workers.size() + 1;
+}
+
+void ThreadPool::work() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->work_ready.wait(lock, [&]() { return this->stopping || this->batch != seen; });
+            if (this->stopping)
+                return;
+
+            seen = this->batch;
+        }
+
+        this->run_jobs();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->running == 0)
+            this->work_done.notify_one();
+    }
+}
+
+// Keep claiming jobs from the current batch until there are none left
+void ThreadPool::run_jobs() {
+    for (size_t i = this->next_job++; i < this->job_count; i = this->next_job++) {
+        (*this->job)(i);
+    }
+}
+
+void ThreadPool::for_each(size_t count, const std::function<void(size_t)> &job) {
+    if (this->workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; i++)
+            job(i);
+
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->job = &job;
+        this->job_count = count;
+        this->next_job = 0;
+        this->running = this->workers.size();
+        this->batch++;
+    }
+
+    this->work_ready.notify_all();
+    this->run_jobs();
+
+    // Every worker has to have seen the batch before the next one can start
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->work_done.wait(lock, [&]() { return this->running == 0; });
+    this->job = nullptr;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads which run batches of independent jobs
+//
+// The threads are started once and reused for every batch, so a pass can be split into many small jobs
+// without paying to start threads each time
+class ThreadPool {
+  private:
+    // The calling thread also runs jobs, so there is one fewer worker than the pool's size
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    // The batch being run. Workers claim the next job by incrementing `next_job`
+    const std::function<void(size_t)> *job;
+    size_t job_count;
+    std::atomic<size_t> next_job;
+
+    // Number of workers yet to finish the current batch
+    size_t running;
+
+    // Incremented for each batch, so a worker can tell when there is a new one
+    uint64_t batch;
+    bool stopping;
+
+    void work();
+    void run_jobs();
+
+  public:
+    // How many jobs to split work into for each thread, when it is split up front into runs of declarations
+    // Some declarations cost far more than others, so smaller runs stop one expensive run from holding up the rest
+    static constexpr size_t JOBS_PER_THREAD = 4;
+
+    ThreadPool(size_t thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Number of threads jobs are run on, including the calling thread
+    size_t size() const;
+
+    // Run `job(i)` for every `i` in `[0, count)`, returning once they have all finished
+    // Jobs may run in any order and at the same time as each other, so must not throw
+    void for_each(size_t count, const std::function<void(size_t)> &job);
+};
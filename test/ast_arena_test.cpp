@@ -0,0 +1,63 @@
+#include "../src/ast/ast_arena.h"
+#include "../src/ast/expr.h"
+
+#include <gtest/gtest.h>
+
+TEST(AstArenaTest, ParseOrder) {
+    AstArena arena;
+
+    auto first = arena.make<LiteralExpr>(Token{TokenType::INT_VAL, "1", 1});
+    auto second = arena.make<LiteralExpr>(Token{TokenType::INT_VAL, "2", 1});
+    NodePtr<Expr> binary = arena.make<BinaryExpr>(std::move(first), Token{TokenType::PLUS, "+", 1}, std::move(second));
+
+    // Nodes are laid out one after another in the order they were made
+    auto b = dynamic_cast<BinaryExpr *>(binary.get());
+    EXPECT_LT(reinterpret_cast<char *>(b->left.get()), reinterpret_cast<char *>(b->right.get()));
+    EXPECT_LT(reinterpret_cast<char *>(b->right.get()), reinterpret_cast<char *>(b));
+}
+
+TEST(AstArenaTest, Lists) {
+    AstArena arena;
+
+    std::vector<NodePtr<Expr>> args;
+    for (int i = 0; i < 100; i++)
+        args.push_back(arena.make<LiteralExpr>(Token{TokenType::INT_VAL, "1", 1}));
+
+    // Finished lists take up exactly as much space as they need
+    NodeList<Expr> list = arena.list(std::move(args));
+    EXPECT_EQ(list.size(), 100);
+    EXPECT_EQ(list.capacity(), 100);
+    EXPECT_EQ(list.get_allocator().resource(), &arena);
+}
+
+TEST(AstArenaTest, LargeAllocation) {
+    AstArena arena;
+
+    // Larger than a block
+    ArenaVector<char> large = arena.list<char>();
+    large.resize(AstArena::BLOCK_SIZE * 2, 'a');
+    EXPECT_EQ(large.back(), 'a');
+
+    // Smaller allocations carry on afterwards
+    auto node = arena.make<LiteralExpr>(Token{TokenType::INT_VAL, "1", 1});
+    EXPECT_EQ(node->literal.lexeme, "1");
+}
+
+struct CountedNode {
+    int &destroyed;
+
+    CountedNode(int &destroyed) : destroyed(destroyed) {}
+    ~CountedNode() { this->destroyed++; }
+};
+
+TEST(AstArenaTest, RunsDestructors) {
+    AstArena arena;
+
+    int destroyed = 0;
+    {
+        auto a = arena.make<CountedNode>(destroyed);
+        auto b = arena.make<CountedNode>(destroyed);
+    }
+
+    EXPECT_EQ(destroyed, 2);
+}
@@ -0,0 +1,47 @@
+#include "../src/driver/binary_cache.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+
+const std::string BINARY_CACHE_TEST_DIR = "binary_cache_test";
+
+TEST(BinaryCacheTest, KeyDependsOnFlags) {
+    BinaryCache cache(BINARY_CACHE_TEST_DIR, "g++", {"-O2"});
+    EXPECT_EQ(cache.key("int main() {}"), cache.key("int main() {}"));
+    EXPECT_NE(cache.key("int main() {}"), cache.key("int main() { return 0; }"));
+
+    EXPECT_NE(cache.key("int main() {}"), BinaryCache(BINARY_CACHE_TEST_DIR, "g++", {"-O0"}).key("int main() {}"));
+    EXPECT_NE(cache.key("int main() {}"), BinaryCache(BINARY_CACHE_TEST_DIR, "clang++", {"-O2"}).key("int main() {}"));
+}
+
+TEST(BinaryCacheTest, ReusesBuiltBinary) {
+    std::filesystem::remove_all(BINARY_CACHE_TEST_DIR);
+    std::string binary = BINARY_CACHE_TEST_DIR + "_main";
+    std::string cpp = "#include \"baz_runtime.h\"\nint main() { return Baz::to_string(true) == \"true\" ? 7 : 0; }\n";
+
+    BinaryCache cache(BINARY_CACHE_TEST_DIR);
+    EXPECT_EQ(cache.build(cpp, binary), BuildResult::COMPILED);
+    EXPECT_TRUE(std::filesystem::exists(BINARY_CACHE_TEST_DIR + "/" + cache.key(cpp)));
+    EXPECT_EQ(WEXITSTATUS(std::system(("./" + binary).c_str())), 7);
+
+    std::filesystem::remove(binary);
+    EXPECT_EQ(cache.build(cpp, binary), BuildResult::CACHED);
+    EXPECT_EQ(WEXITSTATUS(std::system(("./" + binary).c_str())), 7);
+
+    std::filesystem::remove(binary);
+    std::filesystem::remove_all(BINARY_CACHE_TEST_DIR);
+}
+
+TEST(BinaryCacheTest, CompilerErrorIsNotCached) {
+    std::filesystem::remove_all(BINARY_CACHE_TEST_DIR);
+    std::string binary = BINARY_CACHE_TEST_DIR + "_main";
+
+    BinaryCache cache(BINARY_CACHE_TEST_DIR);
+    EXPECT_EQ(cache.build("int main() { not c++ }", binary), BuildResult::FAILED);
+    EXPECT_FALSE(std::filesystem::exists(binary));
+    EXPECT_TRUE(std::filesystem::is_empty(BINARY_CACHE_TEST_DIR));
+
+    std::filesystem::remove_all(BINARY_CACHE_TEST_DIR);
+}
@@ -0,0 +1,75 @@
+#include "../src/driver/compile_cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+const std::string COMPILE_CACHE_TEST_DIR = "compile_cache_test";
+
+TEST(CompileCacheTest, KeyDependsOnSource) {
+    EXPECT_EQ(CompileCache::key("fn main() -> int {}"), CompileCache::key("fn main() -> int {}"));
+    EXPECT_NE(CompileCache::key("fn main() -> int {}"), CompileCache::key("fn main() -> int { return 0; }"));
+}
+
+TEST(CompileCacheTest, RestoresStoredOutput) {
+    std::filesystem::remove_all(COMPILE_CACHE_TEST_DIR);
+    CompileCache cache(COMPILE_CACHE_TEST_DIR, 1024);
+
+    std::string key = CompileCache::key("fn main() -> int {}");
+    EXPECT_FALSE(cache.find(key).has_value());
+
+    cache.store(key, "int main() {}\n");
+    auto cached = cache.find(key);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->view(), "int main() {}\n");
+
+    CompileCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.evictions, 0);
+    EXPECT_EQ(stats.entries, 1);
+    EXPECT_EQ(stats.size, 14);
+
+    std::filesystem::remove_all(COMPILE_CACHE_TEST_DIR);
+}
+
+TEST(CompileCacheTest, EvictsLeastRecentlyUsed) {
+    std::filesystem::remove_all(COMPILE_CACHE_TEST_DIR);
+    CompileCache cache(COMPILE_CACHE_TEST_DIR, 250);
+    std::string cpp(100, 'a');
+
+    // Each entry is used at a distinct time, as eviction goes by modification time
+    auto now = std::filesystem::file_time_type::clock::now();
+    for (int i = 0; i < 2; i++) {
+        std::string key = CompileCache::key(std::to_string(i));
+        cache.store(key, cpp);
+        std::filesystem::last_write_time(COMPILE_CACHE_TEST_DIR + "/" + key + ".cpp", now - std::chrono::hours(2 - i));
+    }
+
+    // Using the oldest makes the other the least recently used
+    EXPECT_TRUE(cache.find(CompileCache::key("0")).has_value());
+    cache.store(CompileCache::key("2"), cpp);
+
+    EXPECT_TRUE(cache.find(CompileCache::key("0")).has_value());
+    EXPECT_FALSE(cache.find(CompileCache::key("1")).has_value());
+    EXPECT_TRUE(cache.find(CompileCache::key("2")).has_value());
+
+    CompileCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_EQ(stats.entries, 2);
+    EXPECT_EQ(stats.size, 200);
+
+    std::filesystem::remove_all(COMPILE_CACHE_TEST_DIR);
+}
+
+TEST(CompileCacheTest, OpenCreatesDirectory) {
+    std::filesystem::remove_all(COMPILE_CACHE_TEST_DIR);
+    EXPECT_TRUE(CompileCache::open(COMPILE_CACHE_TEST_DIR + "/cpp", 1024).has_value());
+    EXPECT_TRUE(std::filesystem::is_directory(COMPILE_CACHE_TEST_DIR + "/cpp"));
+
+    // A file is in the way, so the directory can't be made
+    std::ofstream(COMPILE_CACHE_TEST_DIR + "/file") << "not a directory";
+    EXPECT_FALSE(CompileCache::open(COMPILE_CACHE_TEST_DIR + "/file/cpp", 1024).has_value());
+
+    std::filesystem::remove_all(COMPILE_CACHE_TEST_DIR);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../src/code_generator/cpp_generator.h"
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+
+#include <string>
+
+// Parse every declaration left in `parser`, adding them to `stmts`
+inline void parse_all(Parser &parser, NodeList<Stmt> &stmts) {
+    auto stmt = parser.parse_stmt();
+    while (stmt.has_value()) {
+        stmts.push_back(std::move(stmt.value()));
+        stmt = parser.parse_stmt();
+    }
+}
+
+// Parse and check a valid program, ready to generate
+inline void parse_and_check(std::string &source, AstArena &arena, NodeList<Stmt> &stmts, TypeEnvironment &type_env) {
+    Parser parser = Parser(std::make_unique<StringScanner>(source), arena);
+    parse_all(parser, stmts);
+
+    type_env.generate_type_env(stmts);
+
+    auto type_checker = TypeChecker(type_env.type_env);
+    type_checker.resolve_and_check(stmts);
+}
+
+// Check and generate C++ for parsed statements, which shows everything that was parsed
+inline std::string check_and_generate(NodeList<Stmt> &stmts) {
+    auto type_env = TypeEnvironment();
+    type_env.generate_type_env(stmts);
+
+    auto type_checker = TypeChecker(type_env.type_env);
+    type_checker.resolve_and_check(stmts);
+
+    MemorySink output;
+    CppGenerator(output, type_env.type_env).generate(stmts);
+    return std::string(output.view());
+}
+
+// Compile a valid program one stage after another, with the whole AST alive at once
+// Every other way of compiling should give exactly the same C++
+inline std::string compile_serially(std::string &source) {
+    AstArena arena;
+    Parser parser = Parser(std::make_unique<StringScanner>(source), arena);
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    parse_all(parser, stmts);
+    return check_and_generate(stmts);
+}
@@ -0,0 +1,25 @@
+#include "../src/util/content_hash.h"
+
+#include <gtest/gtest.h>
+
+TEST(ContentHashTest, EmptyIsStable) {
+    EXPECT_EQ(ContentHash().value(), 14695981039346656037ull);
+    EXPECT_EQ(ContentHash().hex(), "cbf29ce484222325");
+}
+
+TEST(ContentHashTest, DependsOnContents) {
+    EXPECT_EQ(ContentHash().update("abc").value(), ContentHash().update("abc").value());
+    EXPECT_NE(ContentHash().update("abc").value(), ContentHash().update("abd").value());
+    EXPECT_NE(ContentHash().update("abc").value(), ContentHash().update("").value());
+}
+
+TEST(ContentHashTest, DependsOnHowContentsAreSplit) {
+    EXPECT_NE(ContentHash().update("ab").update("c").value(), ContentHash().update("a").update("bc").value());
+    EXPECT_NE(ContentHash().update("abc").value(), ContentHash().update("abc").update("").value());
+}
+
+TEST(ContentHashTest, HexIsFixedWidth) {
+    std::string hex = ContentHash().update("baz").hex();
+    EXPECT_EQ(hex.length(), 16);
+    EXPECT_EQ(hex.find_first_not_of("0123456789abcdef"), std::string::npos);
+}
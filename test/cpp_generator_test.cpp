@@ -0,0 +1,123 @@
+#include "../src/code_generator/cpp_generator.h"
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+#include "../src/util/thread_pool.h"
+#include "./compile_helpers.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+// Generate C++ for a valid program, in parallel if given a pool
+std::string generate_cpp(std::string &source, ThreadPool *pool) {
+    AstArena arena;
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    auto type_env = TypeEnvironment();
+    parse_and_check(source, arena, stmts, type_env);
+
+    MemorySink output;
+    auto cpp_generator = CppGenerator(output, type_env.type_env);
+    if (pool) {
+        cpp_generator.generate(stmts, *pool);
+    } else {
+        cpp_generator.generate(stmts);
+    }
+
+    return std::string(output.view());
+}
+
+TEST(CppGeneratorTest, ParallelMatchesSerial) {
+    auto files = {
+        "../examples/enums.baz",
+        "../examples/linked_list.baz",
+        "../examples/structs.baz",
+        "../examples/turing_machine.baz",
+        "../test/test_cases/optional_type_checking_succeed.baz",
+        "../test/test_cases/type_checking.baz",
+    };
+
+    for (size_t threads : {2, 3, 8}) {
+        ThreadPool pool(threads);
+
+        for (auto file : files) {
+            std::ifstream t(file);
+            std::string source((std::istreambuf_iterator<char>(t)),
+                               std::istreambuf_iterator<char>());
+
+            EXPECT_EQ(generate_cpp(source, &pool), generate_cpp(source, nullptr)) << file;
+        }
+    }
+}
+
+TEST(CppGeneratorTest, StructInitOrder) {
+    std::string source = R"(
+struct Point {
+    x: int;
+    y: int;
+    z: int;
+}
+
+fn main(): void {
+    let p: Point = Point { z: 30, x: 10, y: 20 };
+}
+)";
+
+    // Initialisers are given in the order the struct declares its properties, whatever order they were written in
+    std::string cpp = generate_cpp(source, nullptr);
+    size_t init = cpp.find("new Point{");
+    ASSERT_NE(init, std::string::npos);
+
+    size_t x = cpp.find("10", init);
+    size_t y = cpp.find("20", init);
+    size_t z = cpp.find("30", init);
+    EXPECT_LT(x, y);
+    EXPECT_LT(y, z);
+    EXPECT_NE(z, std::string::npos);
+}
+
+TEST(CppGeneratorTest, ShardedOutput) {
+    std::string source = R"(
+struct Node {
+    value: int;
+    fn get(): int { return this.value; }
+}
+
+enum Shape {
+    Square(int);
+    fn area(): int { return 1; }
+}
+
+fn main(): void {
+    println(1);
+}
+)";
+
+    AstArena arena;
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    auto type_env = TypeEnvironment();
+    parse_and_check(source, arena, stmts, type_env);
+
+    // The header has every type, and only prototypes for functions and methods
+    MemorySink header;
+    CppGenerator(header, type_env.type_env).generate_header(stmts);
+    std::string header_cpp(header.view());
+    EXPECT_EQ(header_cpp.rfind("#pragma once", 0), 0);
+    EXPECT_NE(header_cpp.find("int value;\n\nint get();\n};"), std::string::npos);
+    EXPECT_NE(header_cpp.find("struct Shape_Square{ int value; };"), std::string::npos);
+    EXPECT_NE(header_cpp.find("int Shape_area(Shape *baz_this);"), std::string::npos);
+    EXPECT_NE(header_cpp.find("int main();"), std::string::npos);
+    EXPECT_EQ(header_cpp.find("return (this->value);"), std::string::npos);
+    EXPECT_EQ(header_cpp.find("return 1;"), std::string::npos);
+
+    // Each source file only has the bodies of its own declarations
+    MemorySink first;
+    CppGenerator(first, type_env.type_env).generate_source(stmts, 0, 2, "output.h");
+    EXPECT_EQ(first.view(), "#include \"baz_runtime.h\"\n#include \"output.h\"\n\n"
+                            "int Node::get() {\nreturn (this->value);\n}\n\n"
+                            "namespace Baz {\nint Shape_area(Shape *baz_this) {\nreturn 1;\n}\n}\n\n");
+
+    MemorySink second;
+    CppGenerator(second, type_env.type_env).generate_source(stmts, 2, 3, "output.h");
+    EXPECT_EQ(second.view(), "#include \"baz_runtime.h\"\n#include \"output.h\"\n\nint main() {\nstd::cout << Baz::to_string(1) << std::endl;\n}\n\n");
+}
@@ -0,0 +1,41 @@
+#include "../src/diagnostics/diagnostic.h"
+#include "../src/type_checker/type.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(DiagnosticTest, Message) {
+    Token token = Token{TokenType::SEMI_COLON, ";", 3};
+
+    Diagnostic diagnostic = Diagnostic(DiagnosticStage::SYNTAX, DiagnosticCode::EXPECTED_EXPRESSION, token);
+    EXPECT_EQ(diagnostic.message(), "Expected expression.");
+
+    // Messages can contain braces without being treated as arguments
+    diagnostic = Diagnostic(DiagnosticStage::SYNTAX, DiagnosticCode::EXPECTED_L_CURLY_BEFORE_IF_BRANCH, token);
+    EXPECT_EQ(diagnostic.message(), "Expected '{' before if branch.");
+}
+
+TEST(DiagnosticTest, Arguments) {
+    Token token = Token{TokenType::IDENTIFIER, "p", 1};
+
+    Diagnostic count = Diagnostic(DiagnosticStage::TYPE, DiagnosticCode::ARGUMENT_COUNT, token, {size_t(2), size_t(3)});
+    EXPECT_EQ(count.message(), "Expected 2 arguments, received 3.");
+
+    Diagnostic missing = Diagnostic(DiagnosticStage::TYPE, DiagnosticCode::MISSING_PROPERTY, token, {std::string_view("x")});
+    EXPECT_EQ(missing.message(), "Missing property x from constructor.");
+
+    IntType int_type;
+    StrType str_type;
+    Diagnostic assign = Diagnostic(DiagnosticStage::TYPE, DiagnosticCode::ASSIGN_INCOMPATIBLE_TYPE, token, {TypeArg{&int_type, true}, TypeArg{&str_type, false}});
+    EXPECT_EQ(assign.message(), "Cannot assign a type 'int?' to variable of type 'str'.");
+}
+
+TEST(DiagnosticTest, Report) {
+    std::stringstream out;
+    report(out, Diagnostic(DiagnosticStage::RESOLVING, DiagnosticCode::UNKNOWN_VARIABLE, Token{TokenType::IDENTIFIER, "a", 7}));
+    EXPECT_EQ(out.str(), "[line 7] Resolving error at 'a': Unknown variable - not declared at this point.\n");
+
+    out.str("");
+    report(out, Diagnostic(DiagnosticStage::SYNTAX, DiagnosticCode::EXPECTED_R_CURLY_AFTER_BLOCK, Token{TokenType::EOF_, "", 9}));
+    EXPECT_EQ(out.str(), "[line 9] Syntax error at end: Expected '}' after block.\n");
+}
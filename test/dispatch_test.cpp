@@ -0,0 +1,70 @@
+#include "../src/ast/ast_arena.h"
+#include "../src/ast/dispatch.h"
+#include "../src/ast/expr_visitor.h"
+#include "../src/type_checker/type.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Records which visit method was called
+class KindRecorder : public ExprVisitor {
+  public:
+    std::string visited;
+
+    void visit_var_expr(VarExpr *expr) { this->visited = "var"; }
+    void visit_struct_init_expr(StructInitExpr *expr) { this->visited = "struct_init"; }
+    void visit_binary_expr(BinaryExpr *expr) { this->visited = "binary"; }
+    void visit_unary_expr(UnaryExpr *expr) { this->visited = "unary"; }
+    void visit_get_expr(GetExpr *expr) { this->visited = "get"; }
+    void visit_enum_init_expr(EnumInitExpr *expr) { this->visited = "enum_init"; }
+    void visit_call_expr(CallExpr *expr) { this->visited = "call"; }
+    void visit_grouping_expr(GroupingExpr *expr) { this->visited = "grouping"; }
+    void visit_literal_expr(LiteralExpr *expr) { this->visited = "literal"; }
+};
+
+TEST(DispatchTest, MatchesAccept) {
+    AstArena arena;
+    Token one = Token{TokenType::INT_VAL, "1", 1};
+
+    NodePtr<Expr> literal = arena.make<LiteralExpr>(one);
+    NodePtr<Expr> grouping = arena.make<GroupingExpr>(arena.make<LiteralExpr>(one));
+    NodePtr<Expr> unary = arena.make<UnaryExpr>(Token{TokenType::MINUS, "-", 1}, arena.make<LiteralExpr>(one));
+
+    for (auto *expr : {literal.get(), grouping.get(), unary.get()}) {
+        KindRecorder accepted;
+        expr->accept(accepted);
+
+        KindRecorder dispatched;
+        dispatch(expr, dispatched);
+
+        EXPECT_EQ(accepted.visited, dispatched.visited);
+    }
+
+    KindRecorder recorder;
+    dispatch(grouping, recorder);
+    EXPECT_EQ(recorder.visited, "grouping");
+}
+
+TEST(DispatchTest, NodeCast) {
+    AstArena arena;
+    NodePtr<Expr> var = arena.make<VarExpr>(Token{TokenType::IDENTIFIER, "a", 1});
+
+    EXPECT_EQ(node_cast<VarExpr>(var.get()), var.get());
+    EXPECT_EQ(node_cast<GetExpr>(var.get()), nullptr);
+    EXPECT_EQ(node_cast<VarExpr>(static_cast<Expr *>(nullptr)), nullptr);
+
+    NodePtr<Stmt> stmt = arena.make<ExprStmt>(std::move(var));
+    EXPECT_EQ(node_cast<ExprStmt>(stmt.get()), stmt.get());
+    EXPECT_EQ(node_cast<ReturnStmt>(stmt.get()), nullptr);
+}
+
+TEST(DispatchTest, TypeCast) {
+    TypeTable types;
+    Type *int_type = types.make<IntType>();
+    Type *struct_type = types.make<StructType>(Token{TokenType::IDENTIFIER, "Point", 1}, std::vector<TypedVar>(), std::vector<std::tuple<Token, Type *>>());
+
+    EXPECT_EQ(type_cast<StructType>(struct_type), struct_type);
+    EXPECT_EQ(type_cast<EnumType>(struct_type), nullptr);
+    EXPECT_EQ(type_cast<StructType>(int_type), nullptr);
+    EXPECT_EQ(type_cast<StructType>(nullptr), nullptr);
+}
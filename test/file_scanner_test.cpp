@@ -0,0 +1,127 @@
+#include "../src/scanner/file_scanner.h"
+#include "../src/scanner/scanner.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+// Scan every token up to and including EOF
+std::vector<Token> scan_in_chunks(FileScanner &scan) {
+    std::vector<Token> tokens;
+    Token next = scan.scan_token();
+    while (next.t != TokenType::EOF_) {
+        tokens.push_back(next);
+        next = scan.scan_token();
+    }
+
+    tokens.push_back(next);
+    return tokens;
+}
+
+void expect_same_as_string_scanner(std::string source, size_t chunk_size) {
+    std::string path("file_scanner_test.baz");
+    {
+        std::ofstream out(path);
+        out << source;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+
+    FileScanner file_scan = FileScanner(fd, chunk_size);
+    auto tokens = scan_in_chunks(file_scan);
+
+    close(fd);
+    std::remove(path.c_str());
+
+    StringScanner string_scan = StringScanner(source);
+    for (auto &token : tokens) {
+        Token expected = string_scan.scan_token();
+        EXPECT_EQ(token.t, expected.t);
+        EXPECT_EQ(token.lexeme, expected.lexeme);
+        EXPECT_EQ(token.line, expected.line);
+    }
+}
+
+TEST(FileScannerTest, TokensSpanChunks) {
+    std::string source = "fn some_long_identifier(a: int): float { return 1234.5678 >= a && b != c; }";
+
+    // Chunk sizes that split tokens at every possible point
+    for (size_t chunk_size = 1; chunk_size < 12; chunk_size++) {
+        expect_same_as_string_scanner(source, chunk_size);
+    }
+}
+
+TEST(FileScannerTest, StringsAndCommentsSpanChunks) {
+    std::string source = "a /* a multiline\ncomment ** with stars */ b // line comment\n\"a\nmultiline\nstring\" c /**/ d";
+
+    for (size_t chunk_size = 1; chunk_size < 12; chunk_size++) {
+        expect_same_as_string_scanner(source, chunk_size);
+    }
+}
+
+TEST(FileScannerTest, MatchesStringScanner) {
+    auto files = {"returns_success.baz", "type_checking.baz", "optional_type_checking_succeed.baz"};
+
+    for (auto file : files) {
+        std::ifstream t(std::string("../test/test_cases/") + file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        expect_same_as_string_scanner(source, 7);
+        expect_same_as_string_scanner(source, FileScanner::DEFAULT_CHUNK_SIZE);
+    }
+}
+
+TEST(FileScannerTest, UnterminatedString) {
+    std::string source = "a \"never closed";
+    std::string path("file_scanner_unterminated_test.baz");
+    {
+        std::ofstream out(path);
+        out << source;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    std::remove(path.c_str());
+
+    FileScanner scan = FileScanner(fd, 4);
+    scan.scan_token();
+
+    EXPECT_DEATH({ scan.scan_token(); }, "Unterminated string");
+    close(fd);
+}
+
+TEST(FileScannerTest, ThrowsErrors) {
+    std::string path("file_scanner_throw_test.baz");
+    for (std::string source : {"a \"never closed", "/* never closed", "1234a", "a # b"}) {
+        {
+            std::ofstream out(path);
+            out << source;
+        }
+
+        int fd = open(path.c_str(), O_RDONLY);
+        std::remove(path.c_str());
+
+        // Throws the same error as scanning a string would
+        std::string expected;
+        try {
+            StringScanner string_scan = StringScanner(source, SymbolTable::global(), true);
+            while (string_scan.scan_token().t != TokenType::EOF_) {}
+        } catch (ScannerError e) {
+            expected = e.message;
+        }
+
+        FileScanner scan = FileScanner(fd, 4, true);
+        try {
+            while (scan.scan_token().t != TokenType::EOF_) {}
+            ADD_FAILURE() << "Expected an error scanning: " << source;
+        } catch (ScannerError e) {
+            EXPECT_FALSE(expected.empty());
+            EXPECT_EQ(e.message, expected);
+        }
+
+        close(fd);
+    }
+}
@@ -0,0 +1,19 @@
+#include "../src/code_generator/makefile_generator.h"
+#include "../src/code_generator/runtime.h"
+
+#include <gtest/gtest.h>
+
+TEST(MakefileGeneratorTest, CompilesEachSource) {
+    MemorySink sink;
+    generate_makefile(sink, "output.h", {"output_0.cpp", "output_1.cpp"}, "main");
+
+    std::string makefile(sink.view());
+    EXPECT_NE(makefile.find("OBJECTS = output_0.o output_1.o\n"), std::string::npos);
+    EXPECT_NE(makefile.find("main: $(OBJECTS)\n\t$(CXX) $(CXXFLAGS) $(LDFLAGS) $(OBJECTS) $(LDLIBS) -o main\n"), std::string::npos);
+    EXPECT_NE(makefile.find("%.o: %.cpp output.h\n\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -c $< -o $@\n"), std::string::npos);
+
+    // Built against the runtime, with the flags its header was precompiled with
+    EXPECT_NE(makefile.find("CXXFLAGS ?= " + RUNTIME_FLAGS + "\n"), std::string::npos);
+    EXPECT_NE(makefile.find("CPPFLAGS += -I" + RUNTIME_DIR + "\n"), std::string::npos);
+    EXPECT_NE(makefile.find("LDLIBS += -lbazrt\n"), std::string::npos);
+}
@@ -0,0 +1,62 @@
+#include "../src/code_generator/output_sink.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <ostream>
+
+std::string read_file(const std::string &path) {
+    std::ifstream t(path);
+    return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+}
+
+TEST(OutputSinkTest, MemoryGrows) {
+    MemorySink sink;
+    std::ostream out(&sink);
+    EXPECT_EQ(sink.view(), "");
+
+    std::string expected;
+    for (int i = 0; i < 10000; i++) {
+        out << "line " << i << std::endl;
+        expected += "line " + std::to_string(i) + "\n";
+    }
+
+    EXPECT_EQ(sink.view(), expected);
+}
+
+TEST(OutputSinkTest, FileOnlyWritesFullBlocks) {
+    std::string path("output_sink_test.cpp");
+    std::string line(99, 'a');
+    line += '\n';
+
+    // Just over two blocks
+    size_t line_count = FileSink::BLOCK_SIZE * 2 / line.size() + 1;
+    {
+        FileSink sink(path);
+        ASSERT_TRUE(sink.is_open());
+        std::ostream out(&sink);
+
+        // Flushing the stream doesn't write anything
+        out << line << std::flush;
+        EXPECT_EQ(read_file(path), "");
+
+        for (size_t i = 1; i < line_count; i++) {
+            out << line;
+        }
+
+        // Only the full blocks have been written
+        EXPECT_EQ(read_file(path).size(), FileSink::BLOCK_SIZE * 2);
+    }
+
+    // The rest is written when the sink is destroyed
+    std::string contents = read_file(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(contents.size(), line.size() * line_count);
+    EXPECT_EQ(contents.substr(contents.size() - line.size()), line);
+}
+
+TEST(OutputSinkTest, FileCanFail) {
+    FileSink sink("missing_directory/output.cpp");
+    EXPECT_FALSE(sink.is_open());
+}
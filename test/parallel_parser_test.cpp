@@ -0,0 +1,72 @@
+#include "../src/code_generator/cpp_generator.h"
+#include "../src/parser/parallel_parser.h"
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+#include "./compile_helpers.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+TokenBuffer tokenize(std::string &source) {
+    StringScanner scan = StringScanner(source);
+    return TokenBuffer::tokenize(scan);
+}
+
+TEST(ParallelParserTest, SplitsAtTopLevelDeclarations) {
+    std::string source = "struct A { fn m(): void {} }\nenum B { C; }\nfn d(): void {}";
+    TokenBuffer tokens = tokenize(source);
+
+    // Not at the method, which is inside the struct
+    std::vector<size_t> expected = {12, 18};
+    EXPECT_EQ(find_decl_split_points(tokens, 100), expected);
+}
+
+TEST(ParallelParserTest, UnbalancedHasNoMoreSplits) {
+    std::string source = "fn a(): void {} fn b(): void {}} fn c(): void {}";
+    TokenBuffer tokens = tokenize(source);
+
+    std::vector<size_t> expected = {8};
+    EXPECT_EQ(find_decl_split_points(tokens, 100), expected);
+}
+
+TEST(ParallelParserTest, MatchesSerial) {
+    auto files = {"../test/test_cases/type_checking.baz", "../examples/linked_list.baz", "../examples/turing_machine.baz"};
+
+    for (auto file : files) {
+        std::ifstream t(file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        AstArena serial_arena;
+        Parser parser = Parser(tokenize(source), serial_arena);
+        NodeList<Stmt> serial = serial_arena.nodes<Stmt>();
+        parse_all(parser, serial);
+
+        std::string expected = check_and_generate(serial);
+
+        for (size_t threads : {1, 2, 3, 8}) {
+            ThreadPool pool(threads);
+            AstArena arena;
+            NodeList<Stmt> stmts = parse_parallel(tokenize(source), arena, pool);
+
+            ASSERT_EQ(stmts.size(), serial.size()) << file;
+            EXPECT_EQ(check_and_generate(stmts), expected) << file;
+        }
+    }
+}
+
+TEST(ParallelParserTest, ReportsFirstError) {
+    std::string source = "fn a(): void {}\nfn b(): void { let; }\nfn c(): void {}\nfn d(): void { 1 + ; }\nfn e(): void {}";
+
+    // Only the forking thread is copied into a death test, so the pool has to be made inside it
+    EXPECT_DEATH({ ThreadPool pool(4); AstArena arena; parse_parallel(tokenize(source), arena, pool); }, "\\[line 2\\] Syntax error at ';'");
+}
+
+TEST(ParallelParserTest, DeclarationAcrossSplit) {
+    // The split is at `fn b`, but parsing serially reports the missing body there instead
+    std::string source = "fn a(): void {}\nfn b(): void\nfn c(): void {}";
+
+    EXPECT_DEATH({ ThreadPool pool(4); AstArena arena; parse_parallel(tokenize(source), arena, pool); }, "\\[line 3\\] Syntax error at 'fn'");
+}
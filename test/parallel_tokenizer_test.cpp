@@ -0,0 +1,57 @@
+#include "../src/scanner/parallel_tokenizer.h"
+#include "../src/scanner/scanner.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+void expect_same_as_serial(std::string &source, size_t chunk_count) {
+    StringScanner scan = StringScanner(source);
+    TokenBuffer expected = TokenBuffer::tokenize(scan);
+    TokenBuffer tokens = tokenize_parallel(source, chunk_count);
+
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (size_t i = 0; i < tokens.size(); i++) {
+        EXPECT_EQ(tokens.type(i), expected.type(i));
+        EXPECT_EQ(tokens.get(i).lexeme.data(), expected.get(i).lexeme.data());
+        EXPECT_EQ(tokens.get(i).lexeme.length(), expected.get(i).lexeme.length());
+        EXPECT_EQ(tokens.get(i).line, expected.get(i).line);
+        EXPECT_EQ(tokens.get(i).symbol, expected.get(i).symbol);
+    }
+}
+
+TEST(ParallelTokenizerTest, SplitsOutsideStringsAndComments) {
+    std::string source = "a\n\"b\nc\"\n/* d\ne */\n// f\ng\n/*/ h\n*/\ni";
+    std::vector<size_t> splits = find_split_points(source, 100);
+
+    // Every newline except the ones in the string and first comment
+    // `/*/` is a whole comment, so `h` and the `*/` after it are code
+    std::vector<size_t> expected = {2, 8, 18, 23, 25, 31, 34};
+    EXPECT_EQ(splits, expected);
+}
+
+TEST(ParallelTokenizerTest, UnterminatedCommentHasNoMoreSplits) {
+    std::string source = "a\nb\n/* c\nd\ne";
+    std::vector<size_t> splits = find_split_points(source, 100);
+
+    std::vector<size_t> expected = {2, 4};
+    EXPECT_EQ(splits, expected);
+}
+
+TEST(ParallelTokenizerTest, MatchesSerial) {
+    auto files = {"../test/test_cases/type_checking.baz", "../test/test_cases/optional_type_checking_succeed.baz", "../examples/linked_list.baz"};
+
+    for (auto file : files) {
+        std::ifstream t(file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        for (size_t chunk_count : {1, 2, 3, 8, 1000})
+            expect_same_as_serial(source, chunk_count);
+    }
+}
+
+TEST(ParallelTokenizerTest, ReportsFirstError) {
+    std::string source = "a\nb ^\nc\nd \"never closed";
+
+    EXPECT_DEATH({ tokenize_parallel(source, 4); }, "Unrecognised symbol: '\\^'");
+}
@@ -1,7 +1,9 @@
 #include "../src/parser/parser.h"
+#include "../src/scanner/token_buffer.h"
 #include "./scanner_mock.h"
 
 #include "gmock/gmock.h"
+#include <deque>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -42,7 +44,8 @@ TEST(ParserTest, BinaryOperator) {
     FunctionWrappedTokenGenerator gen({INT_VAL, PLUS, FLOAT_VAL, SEMI_COLON});
     EXPECT_CALL(*scan, scan_token).WillRepeatedly(testing::Invoke(&gen, &FunctionWrappedTokenGenerator::generate_token));
 
-    Parser p = Parser(std::move(scan));
+    AstArena arena;
+    Parser p = Parser(std::move(scan), arena);
     auto s = p.parse_stmt();
 
     auto fn = CHECK_AND_CAST(s->get(), FunDeclStmt *);
@@ -56,3 +59,193 @@ TEST(ParserTest, BinaryOperator) {
     auto right = CHECK_AND_CAST(expr->right.get(), LiteralExpr *);
     EXPECT_EQ(right->literal.t, TokenType::FLOAT_VAL);
 }
+
+TEST(ParserTest, PreTokenized) {
+    std::string source = "fn main(): void { 1 + 2.5; }";
+    StringScanner scan = StringScanner(source);
+    TokenBuffer tokens = TokenBuffer::tokenize(scan);
+
+    EXPECT_EQ(tokens.size(), 13);
+    EXPECT_EQ(tokens.type(tokens.size() - 1), TokenType::EOF_);
+
+    AstArena arena;
+    Parser p = Parser(std::move(tokens), arena);
+    auto s = p.parse_stmt();
+
+    auto fn = CHECK_AND_CAST(s->get(), FunDeclStmt *);
+    EXPECT_EQ(fn->name.lexeme, "main");
+
+    auto expr_stmt = CHECK_AND_CAST(fn->body[0].get(), ExprStmt *);
+    auto expr = CHECK_AND_CAST(expr_stmt->expr.get(), BinaryExpr *);
+    EXPECT_EQ(expr->op.t, TokenType::PLUS);
+
+    auto left = CHECK_AND_CAST(expr->left.get(), LiteralExpr *);
+    EXPECT_EQ(left->literal.lexeme, "1");
+
+    auto right = CHECK_AND_CAST(expr->right.get(), LiteralExpr *);
+    EXPECT_EQ(right->literal.lexeme, "2.5");
+
+    // Parsing past the end keeps returning nothing rather than running off the end of the tokens
+    EXPECT_FALSE(p.parse_stmt().has_value());
+    EXPECT_FALSE(p.parse_stmt().has_value());
+}
+
+// Parse `source` as the only statement in `main`, returning the expression
+NodePtr<Expr> parse_expression(std::string source) {
+    // The returned expression points into both of these, so they are kept for the rest of the tests
+    static std::deque<std::string> sources;
+    static AstArena arena;
+    sources.push_back("fn main(): void { " + source + "; }");
+
+    StringScanner scan = StringScanner(sources.back());
+    Parser p = Parser(TokenBuffer::tokenize(scan), arena);
+    auto s = p.parse_stmt();
+
+    auto fn = dynamic_cast<FunDeclStmt *>(s->get());
+    auto expr_stmt = dynamic_cast<ExprStmt *>(fn->body[0].get());
+    return std::move(expr_stmt->expr);
+}
+
+TEST(ParserTest, Precedence) {
+    // a || (b && (c == ((d + (e * (f ?? g))) < h)))
+    auto expr = parse_expression("a || b && c == d + e * f ?? g < h");
+
+    auto logical_or = CHECK_AND_CAST(expr.get(), BinaryExpr *);
+    EXPECT_EQ(logical_or->op.t, TokenType::OR);
+
+    auto logical_and = CHECK_AND_CAST(logical_or->right.get(), BinaryExpr *);
+    EXPECT_EQ(logical_and->op.t, TokenType::AND);
+
+    auto equality = CHECK_AND_CAST(logical_and->right.get(), BinaryExpr *);
+    EXPECT_EQ(equality->op.t, TokenType::EQUAL_EQUAL);
+
+    auto comparison = CHECK_AND_CAST(equality->right.get(), BinaryExpr *);
+    EXPECT_EQ(comparison->op.t, TokenType::LESS);
+
+    auto term = CHECK_AND_CAST(comparison->left.get(), BinaryExpr *);
+    EXPECT_EQ(term->op.t, TokenType::PLUS);
+
+    auto factor = CHECK_AND_CAST(term->right.get(), BinaryExpr *);
+    EXPECT_EQ(factor->op.t, TokenType::STAR);
+
+    auto fallback = CHECK_AND_CAST(factor->right.get(), BinaryExpr *);
+    EXPECT_EQ(fallback->op.t, TokenType::QUESTION_QUESTION);
+}
+
+TEST(ParserTest, LeftAssociative) {
+    // (a - b) - c
+    auto expr = parse_expression("a - b - c");
+
+    auto outer = CHECK_AND_CAST(expr.get(), BinaryExpr *);
+    auto inner = CHECK_AND_CAST(outer->left.get(), BinaryExpr *);
+    EXPECT_EQ(inner->op.t, TokenType::MINUS);
+    EXPECT_EQ(CHECK_AND_CAST(outer->right.get(), VarExpr *)->name.lexeme, "c");
+
+    // (a * b) / c + d
+    expr = parse_expression("a * b / c + d");
+
+    auto term = CHECK_AND_CAST(expr.get(), BinaryExpr *);
+    EXPECT_EQ(term->op.t, TokenType::PLUS);
+    auto divide = CHECK_AND_CAST(term->left.get(), BinaryExpr *);
+    EXPECT_EQ(divide->op.t, TokenType::SLASH);
+    auto multiply = CHECK_AND_CAST(divide->left.get(), BinaryExpr *);
+    EXPECT_EQ(multiply->op.t, TokenType::STAR);
+}
+
+TEST(ParserTest, Unary) {
+    // (!(-a)) * b
+    auto expr = parse_expression("!-a * b");
+
+    auto factor = CHECK_AND_CAST(expr.get(), BinaryExpr *);
+    EXPECT_EQ(factor->op.t, TokenType::STAR);
+
+    auto bang = CHECK_AND_CAST(factor->left.get(), UnaryExpr *);
+    EXPECT_EQ(bang->op.t, TokenType::BANG);
+
+    auto minus = CHECK_AND_CAST(bang->right.get(), UnaryExpr *);
+    EXPECT_EQ(minus->op.t, TokenType::MINUS);
+    CHECK_AND_CAST(minus->right.get(), VarExpr *);
+}
+
+TEST(ParserTest, NonAssociative) {
+    // Lower precedence operators can still follow
+    auto expr = parse_expression("a < b == c ?? d");
+    auto equality = CHECK_AND_CAST(expr.get(), BinaryExpr *);
+    EXPECT_EQ(equality->op.t, TokenType::EQUAL_EQUAL);
+
+    EXPECT_DEATH({ parse_expression("a == b == c"); }, "Syntax error at '==': Expected ';' after expression.");
+    EXPECT_DEATH({ parse_expression("a < b > c"); }, "Syntax error at '>': Expected ';' after expression.");
+    EXPECT_DEATH({ parse_expression("a ?? b ?? c"); }, "Syntax error at '\\?\\?': Expected ';' after expression.");
+}
+
+TEST(ParserTest, NestingLimit) {
+    int depth = Parser::MAX_EXPRESSION_DEPTH;
+    parse_expression(std::string(depth - 1, '(') + "a" + std::string(depth - 1, ')'));
+
+    EXPECT_DEATH({ parse_expression(std::string(depth, '(') + "a" + std::string(depth, ')')); }, "Expression nested too deeply.");
+}
+
+TEST(ParserTest, LazyBodies) {
+    std::string source = "struct P { x: int; fn get(): int { if (true) { return this.x; } return 0; } }\nfn main(): void { let a: int = 1; println(a); }";
+    StringScanner scan = StringScanner(source);
+
+    AstArena arena;
+    Parser p = Parser(TokenBuffer::tokenize(scan), arena);
+    p.set_lazy_bodies(true);
+
+    auto s = p.parse_stmt();
+    auto method = CHECK_AND_CAST(s->get(), StructDeclStmt *)->methods[0].get();
+    auto fn = CHECK_AND_CAST(p.parse_stmt()->get(), FunDeclStmt *);
+    EXPECT_FALSE(p.parse_stmt().has_value());
+
+    // Bodies are skipped over until they are asked for, in any order
+    EXPECT_TRUE(fn->body.empty());
+    ASSERT_EQ(fn->get_body().size(), 2);
+    CHECK_AND_CAST(fn->get_body()[1].get(), PrintStmt *);
+
+    ASSERT_EQ(method->get_body().size(), 2);
+    CHECK_AND_CAST(method->get_body()[0].get(), IfStmt *);
+}
+
+TEST(ParserTest, LazyBodyErrors) {
+    std::string source = "fn a(): void { 1 + ; }\nfn b(): void {}";
+    StringScanner scan = StringScanner(source);
+
+    AstArena arena;
+    Parser p = Parser(TokenBuffer::tokenize(scan), arena);
+    p.set_lazy_bodies(true);
+
+    // Only reported once the body is parsed
+    auto fn = CHECK_AND_CAST(p.parse_stmt()->get(), FunDeclStmt *);
+    EXPECT_TRUE(p.parse_stmt().has_value());
+    EXPECT_DEATH({ fn->get_body(); }, "Syntax error at ';'");
+
+    // An unclosed body is parsed straight away, reporting the same error as it always would
+    std::string unclosed = "fn a(): void { let a: int = 1;";
+    StringScanner unclosed_scan = StringScanner(unclosed);
+    Parser q = Parser(TokenBuffer::tokenize(unclosed_scan), arena);
+    q.set_lazy_bodies(true);
+    EXPECT_DEATH({ q.parse_stmt(); }, "Syntax error at end: Expected expression.");
+}
+
+TEST(ParserTest, SignaturesOnly) {
+    std::string source = "struct P { x: int; fn get(): int { return 1 + ; } }\nfn main(): void { let; }";
+
+    AstArena arena;
+    Parser p = Parser(std::make_unique<StringScanner>(source), arena);
+    p.set_signatures_only(true);
+
+    // Bodies are skipped over without ever being parsed, so errors in them aren't found
+    EXPECT_EQ(p.next_token().t, TokenType::STRUCT);
+    auto s = p.parse_stmt();
+    auto method = CHECK_AND_CAST(s->get(), StructDeclStmt *)->methods[0].get();
+    EXPECT_TRUE(method->get_body().empty());
+
+    EXPECT_EQ(p.next_token().line, 2);
+    auto f = p.parse_stmt();
+    auto fn = CHECK_AND_CAST(f->get(), FunDeclStmt *);
+    EXPECT_TRUE(fn->get_body().empty());
+    EXPECT_EQ(fn->name.lexeme, "main");
+
+    EXPECT_FALSE(p.parse_stmt().has_value());
+}
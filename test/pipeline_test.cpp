@@ -0,0 +1,81 @@
+#include "../src/code_generator/cpp_generator.h"
+#include "../src/driver/pipeline.h"
+#include "../src/scanner/scanner.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+#include "./compile_helpers.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+std::string compile_pipelined(std::string &source, size_t thread_count) {
+    ThreadPool pool(thread_count);
+    AstArena arena;
+    Parser parser = Parser(std::make_unique<StringScanner>(source, SymbolTable::global(), true), arena, true);
+
+    MemorySink output;
+    compile_pipelined(parser, arena, pool, output);
+    return std::string(output.view());
+}
+
+TEST(PipelineTest, MatchesSerial) {
+    auto files = {"../examples/enums.baz", "../examples/linked_list.baz", "../examples/turing_machine.baz", "../test/test_cases/type_checking.baz"};
+
+    for (auto file : files) {
+        std::ifstream t(file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        std::string expected = compile_serially(source);
+        for (size_t threads : {1, 2, 4}) {
+            EXPECT_EQ(compile_pipelined(source, threads), expected) << file;
+        }
+    }
+}
+
+TEST(PipelineTest, ReportsFirstTypeError) {
+    std::string source = "fn a(): int { return 1; }\nfn b(): int { return true; }\nfn c(): int { return \"c\"; }";
+
+    testing::internal::CaptureStderr();
+    EXPECT_THROW({ compile_pipelined(source, 4); }, TypeCheckerError);
+    EXPECT_EQ(testing::internal::GetCapturedStderr().rfind("[line 2] Type error", 0), 0);
+}
+
+TEST(PipelineTest, ResolvingErrorsFirst) {
+    // Scanning and syntax errors come before everything, then resolving errors before type errors
+    std::string scanning = "fn a(): int { return true; }\nfn b(): void { c; }\nfn d(): void { 1234a; }";
+    try {
+        compile_pipelined(scanning, 4);
+        ADD_FAILURE() << "Expected a scanning error";
+    } catch (ScannerError e) {
+        EXPECT_EQ(e.message, "Unexpected character in number: '1234a'");
+    }
+
+    std::string syntax = "fn a(): int { return true; }\nfn b(): void { c; }\nfn d(): void { 1 + ; }";
+    try {
+        compile_pipelined(syntax, 4);
+        ADD_FAILURE() << "Expected a syntax error";
+    } catch (ParserError e) {
+        EXPECT_EQ(e.diagnostic.stage, DiagnosticStage::SYNTAX);
+        EXPECT_EQ(e.diagnostic.token.line, 3);
+    }
+
+    std::string resolving = "fn a(): int { return true; }\nfn b(): void { c; }";
+    try {
+        compile_pipelined(resolving, 4);
+        ADD_FAILURE() << "Expected a resolving error";
+    } catch (ResolverError e) {
+        EXPECT_EQ(e.diagnostic.stage, DiagnosticStage::RESOLVING);
+        EXPECT_EQ(e.diagnostic.token.line, 2);
+    }
+}
+
+TEST(PipelineTest, ManyDeclarations) {
+    // Enough declarations for the list of them to grow many times while the parser is still making nodes
+    std::string source;
+    for (int i = 0; i < 5000; i++) {
+        source += "fn f" + std::to_string(i) + "(x: int): int { return x + " + std::to_string(i) + "; }\n";
+    }
+
+    EXPECT_EQ(compile_pipelined(source, 4), compile_serially(source));
+}
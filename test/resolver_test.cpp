@@ -0,0 +1,97 @@
+#include "../src/ast/dispatch.h"
+#include "../src/ast/stmt.h"
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/type_checker/resolver.h"
+#include "../src/type_checker/type_environment.h"
+#include "./compile_helpers.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Get the variable printed by the `index`th statement of a block
+VarExpr *printed_var(NodeList<Stmt> &stmts, size_t index) {
+    auto print = node_cast<PrintStmt>(stmts[index].get());
+    return node_cast<VarExpr>(print->expr.value().get());
+}
+
+TEST(ResolverTest, VariableSlots) {
+    std::string source = R"(
+fn main(): void {
+    let a: int = 1;
+    let b: int = 2;
+    {
+        let a: int = 3;
+        println(a);
+        println(b);
+    }
+    println(a);
+    b = 4;
+}
+)";
+
+    AstArena arena;
+    Parser parser = Parser(std::make_unique<StringScanner>(source), arena);
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    parse_all(parser, stmts);
+
+    auto type_env = TypeEnvironment();
+    type_env.generate_type_env(stmts);
+
+    auto resolver = Resolver(type_env.type_env);
+    resolver.resolve(stmts);
+
+    auto &body = node_cast<FunDeclStmt>(stmts[0].get())->body;
+    auto &block = node_cast<BlockStmt>(body[2].get())->stmts;
+
+    // The inner `a` shadows the outer one
+    VarExpr *inner_a = printed_var(block, 1);
+    EXPECT_EQ(inner_a->slot.depth, 0);
+    EXPECT_EQ(inner_a->slot.slot, 0);
+
+    VarExpr *outer_b = printed_var(block, 2);
+    EXPECT_EQ(outer_b->slot.depth, 1);
+    EXPECT_EQ(outer_b->slot.slot, 1);
+
+    // Leaving the block uncovers the outer `a` again
+    VarExpr *outer_a = printed_var(body, 3);
+    EXPECT_EQ(outer_a->slot.depth, 0);
+    EXPECT_EQ(outer_a->slot.slot, 0);
+
+    auto assign = node_cast<AssignStmt>(body[4].get());
+    EXPECT_EQ(assign->slot.depth, 0);
+    EXPECT_EQ(assign->slot.slot, 1);
+}
+
+TEST(ResolverTest, TypeHandles) {
+    std::string source = R"(
+struct Line {
+    start: Point;
+    fn length(): int { return 0; }
+}
+
+struct Point {
+    x: int;
+}
+)";
+
+    AstArena arena;
+    Parser parser = Parser(std::make_unique<StringScanner>(source), arena);
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    parse_all(parser, stmts);
+
+    auto type_env = TypeEnvironment();
+    type_env.generate_type_env(stmts);
+    const TypeTable &types = type_env.type_env;
+
+    // Types can be referred to before they are declared
+    auto line = type_cast<StructType>(types[node_cast<StructDeclStmt>(stmts[0].get())->name.symbol]);
+    Type *point = types[node_cast<StructDeclStmt>(stmts[1].get())->name.symbol];
+    ASSERT_NE(line, nullptr);
+    EXPECT_EQ(line->props[0].resolved_type, point);
+
+    auto method = node_cast<StructDeclStmt>(stmts[0].get())->methods[0].get();
+    EXPECT_EQ(method->type->return_type, types[SYM_INT]);
+}
@@ -171,3 +171,76 @@ TEST(ScannerTest, Types) {
         EXPECT_EQ(next->lexeme, std::get<1>(ex));
     }
 }
+
+TEST(ScannerTest, Comments) {
+    std::string source = "a // line comment\n/* multi\nline\ncomment */ b /**/ c";
+    StringScanner scan = StringScanner(source);
+
+    auto expected = {
+        std::make_tuple("a", 1),
+        std::make_tuple("b", 4),
+        std::make_tuple("c", 4),
+    };
+
+    for (auto ex : expected) {
+        std::optional<Token> next = scan.scan_token();
+        EXPECT_EQ(next->t, TokenType::IDENTIFIER);
+        EXPECT_EQ(next->lexeme, std::get<0>(ex));
+        EXPECT_EQ(next->line, std::get<1>(ex));
+    }
+
+    EXPECT_EQ(scan.scan_token().t, TokenType::EOF_);
+}
+
+TEST(ScannerTest, UnterminatedComment) {
+    std::string source = "a /* never closed *";
+    StringScanner scan = StringScanner(source);
+    scan.scan_token();
+
+    EXPECT_DEATH({ scan.scan_token(); }, "Unterminated multiline comment.");
+}
+
+TEST(ScannerTest, LongRuns) {
+    // Longer than a vector register, so the fast paths are exercised
+    std::string identifier = "a_very_long_identifier_that_spans_multiple_vector_registers_1234567890";
+    std::string source = identifier + std::string(40, ' ') + std::string(20, '\n') + "\t\t\"a string that is longer than thirty two characters\nwith a newline\" end";
+    StringScanner scan = StringScanner(source);
+
+    std::optional<Token> next = scan.scan_token();
+    EXPECT_EQ(next->lexeme, identifier);
+    EXPECT_EQ(next->line, 1);
+
+    next = scan.scan_token();
+    EXPECT_EQ(next->t, TokenType::STR_VAL);
+    EXPECT_EQ(next->line, 21);
+
+    next = scan.scan_token();
+    EXPECT_EQ(next->lexeme, "end");
+    EXPECT_EQ(next->line, 22);
+}
+
+TEST(ScannerTest, AllKeywords) {
+    for (auto keyword : KEYWORDS) {
+        EXPECT_EQ(lookup_keyword(keyword.word), keyword.t);
+    }
+
+    EXPECT_FALSE(lookup_keyword("structs").has_value());
+    EXPECT_FALSE(lookup_keyword("i").has_value());
+    EXPECT_FALSE(lookup_keyword("tru").has_value());
+}
+
+TEST(ScannerTest, Symbols) {
+    std::string source = "this x str 12 \"x\" x int";
+    SymbolTable symbols;
+    StringScanner scan = StringScanner(source, symbols);
+
+    // Identifiers and type names are interned, so equal names share a symbol
+    Symbol x = symbols.size();
+    std::vector<Symbol> expected = {SYM_THIS, x, SYM_STR, NO_SYMBOL, NO_SYMBOL, x, SYM_INT};
+    for (auto symbol : expected) {
+        EXPECT_EQ(scan.scan_token().symbol, symbol);
+    }
+
+    EXPECT_EQ(symbols.name(x), "x");
+    EXPECT_EQ(symbols.intern("main"), SYM_MAIN);
+}
@@ -0,0 +1,48 @@
+#include "../src/scanner/scanner.h"
+#include "../src/scanner/source_buffer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+TEST(SourceBufferTest, MissingFile) {
+    EXPECT_FALSE(SourceBuffer::open("this_file_does_not_exist.baz").has_value());
+}
+
+TEST(SourceBufferTest, ReadsWholeFile) {
+    std::string path("../test/test_cases/returns_success.baz");
+    std::ifstream t(path);
+    std::string expected((std::istreambuf_iterator<char>(t)),
+                         std::istreambuf_iterator<char>());
+
+    auto source = SourceBuffer::open(path);
+    ASSERT_TRUE(source.has_value());
+    EXPECT_EQ(source->view(), expected);
+    EXPECT_EQ(source->view().data()[source->view().length()], '\0');
+}
+
+TEST(SourceBufferTest, PageSizedFileIsTerminated) {
+    // A file filling whole pages cannot be mapped with a readable byte after the end
+    std::string path("source_buffer_page_test.baz");
+    std::string contents(sysconf(_SC_PAGESIZE), ' ');
+    contents.replace(0, 5, "a b c");
+    {
+        std::ofstream out(path);
+        out << contents;
+    }
+
+    auto source = SourceBuffer::open(path);
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(source.has_value());
+    EXPECT_EQ(source->view(), contents);
+    EXPECT_EQ(source->view().data()[source->view().length()], '\0');
+
+    StringScanner scan = StringScanner(source->view());
+    auto expected = {"a", "b", "c", ""};
+    for (auto ex : expected) {
+        Token next = scan.scan_token();
+        EXPECT_EQ(next.lexeme, ex);
+    }
+}
@@ -0,0 +1,61 @@
+#include "../src/code_generator/cpp_generator.h"
+#include "../src/driver/streaming.h"
+#include "../src/parser/parser.h"
+#include "../src/scanner/scanner.h"
+#include "../src/type_checker/resolver.h"
+#include "../src/type_checker/type_checker.h"
+#include "../src/type_checker/type_environment.h"
+#include "./compile_helpers.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+std::string compile_streaming(std::string &source) {
+    StreamingCompiler compiler(source);
+
+    MemorySink output;
+    compiler.compile(output);
+    return std::string(output.view());
+}
+
+TEST(StreamingTest, MatchesSerial) {
+    auto files = {"../examples/enums.baz", "../examples/linked_list.baz", "../examples/turing_machine.baz", "../test/test_cases/type_checking.baz"};
+
+    for (auto file : files) {
+        std::ifstream t(file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        EXPECT_EQ(compile_streaming(source), compile_serially(source)) << file;
+    }
+}
+
+TEST(StreamingTest, ReportsErrorsInOrder) {
+    // Syntax errors come before everything, then resolving errors before type errors
+    std::string type = "fn a(): int { return 1; }\n\nfn b(): int { return true; }\nfn c(): int { return \"c\"; }";
+    testing::internal::CaptureStderr();
+    EXPECT_THROW({ compile_streaming(type); }, TypeCheckerError);
+    EXPECT_EQ(testing::internal::GetCapturedStderr().rfind("[line 3] Type error", 0), 0);
+
+    std::string resolving = "fn a(): int { return true; }\nfn b(): void { c; }\nfn d(): void { e; }";
+    try {
+        compile_streaming(resolving);
+        FAIL() << "Expected a resolving error";
+    } catch (ResolverError e) {
+        EXPECT_EQ(e.diagnostic.token.line, 2);
+    }
+
+    std::string syntax = "fn a(): int { return true; }\nfn b(): void { c; }\nfn d(): void { 1 + ; }";
+    try {
+        compile_streaming(syntax);
+        FAIL() << "Expected a syntax error";
+    } catch (ParserError e) {
+        EXPECT_EQ(e.diagnostic.token.line, 3);
+    }
+}
+
+TEST(StreamingTest, SyntaxErrorInSkippedBody) {
+    // The first pass only finds the second error, but the first is still the one reported
+    std::string source = "fn a(): void { let; }\nfn b() void {}";
+    EXPECT_EXIT({ StreamingCompiler compiler(source); }, testing::ExitedWithCode(2), "\\[line 1\\] Syntax error");
+}
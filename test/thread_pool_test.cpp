@@ -0,0 +1,39 @@
+#include "../src/util/thread_pool.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(ThreadPoolTest, RunsEveryJobOnce) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+
+    std::vector<std::atomic<int>> runs(1000);
+    pool.for_each(runs.size(), [&](size_t i) { runs[i]++; });
+
+    for (auto &r : runs)
+        EXPECT_EQ(r, 1);
+}
+
+TEST(ThreadPoolTest, ReusedForManyBatches) {
+    ThreadPool pool(3);
+
+    // Includes empty and single job batches, which don't wake the workers
+    for (size_t batch = 0; batch < 100; batch++) {
+        std::atomic<size_t> total = 0;
+        pool.for_each(batch % 10, [&](size_t i) { total += i + 1; });
+
+        size_t n = batch % 10;
+        EXPECT_EQ(total, n * (n + 1) / 2);
+    }
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsInOrder) {
+    ThreadPool pool(1);
+
+    std::vector<size_t> order;
+    pool.for_each(5, [&](size_t i) { order.push_back(i); });
+
+    std::vector<size_t> expected = {0, 1, 2, 3, 4};
+    EXPECT_EQ(order, expected);
+}
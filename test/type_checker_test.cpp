@@ -1,36 +1,82 @@
+#include "../src/ast/dispatch.h"
 #include "../src/ast/stmt.h"
 #include "../src/parser/parser.h"
 #include "../src/scanner/scanner.h"
 #include "../src/type_checker/resolver.h"
 #include "../src/type_checker/type_checker.h"
 #include "../src/type_checker/type_environment.h"
+#include "../src/util/thread_pool.h"
+#include "./compile_helpers.h"
 
 #include <gtest/gtest.h>
 
-std::vector<std::unique_ptr<Stmt>> run_test(std::string &source) {
+// Parse, resolve and type check a program, keeping the checked statements
+// Resolves as it checks unless `fused` is false, in which case the resolver is run first
+void run_test(std::string &source, AstArena &arena, NodeList<Stmt> &stmts, bool fused = true) {
     auto scan = std::make_unique<StringScanner>(source);
-    Parser parser = Parser(std::move(scan));
+    Parser parser = Parser(std::move(scan), arena);
 
-    std::vector<std::unique_ptr<Stmt>> stmts;
-    auto stmt = parser.parse_stmt();
-    while (stmt.has_value()) {
-        stmts.push_back(std::move(stmt.value()));
-        stmt = parser.parse_stmt();
-    }
+    parse_all(parser, stmts);
 
     // Generate type environment
     auto type_env = TypeEnvironment();
     type_env.generate_type_env(stmts);
 
+    auto type_checker = TypeChecker(type_env.type_env);
+    if (fused) {
+        type_checker.resolve_and_check(stmts);
+        return;
+    }
+
     // Resolve types
     auto resolver = Resolver(type_env.type_env);
     resolver.resolve(stmts);
 
     // Check types
-    auto type_checker = TypeChecker(type_env.type_env);
     type_checker.check(stmts);
+}
 
-    return std::move(stmts);
+void run_test(std::string &source, bool fused = true) {
+    AstArena arena;
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    run_test(source, arena, stmts, fused);
+}
+
+// What the type checker writes to stderr for a program
+std::string type_errors(std::string &source, bool fused) {
+    testing::internal::CaptureStderr();
+    try {
+        run_test(source, fused);
+    } catch (TypeCheckerError) {
+    }
+
+    return testing::internal::GetCapturedStderr();
+}
+
+// What the type checker writes to stderr when checking functions in parallel
+std::string parallel_type_errors(std::string &source, size_t thread_count) {
+    AstArena arena;
+    Parser parser = Parser(std::make_unique<StringScanner>(source), arena);
+
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    parse_all(parser, stmts);
+
+    auto type_env = TypeEnvironment();
+    type_env.generate_type_env(stmts);
+
+    auto resolver = Resolver(type_env.type_env);
+    resolver.resolve(stmts);
+
+    ThreadPool pool(thread_count);
+    auto type_checker = TypeChecker(type_env.type_env);
+
+    testing::internal::CaptureStderr();
+    try {
+        type_checker.check_parallel(stmts, pool);
+    } catch (TypeCheckerError) {
+    }
+
+    return testing::internal::GetCapturedStderr();
 }
 
 TEST(TypeCheckerTest, ReturnTypes) {
@@ -86,3 +132,102 @@ TEST(TypeCheckerTest, Optionals) {
         }
     }
 }
+
+TEST(TypeCheckerTest, StructInitOrder) {
+    std::string source = R"(
+struct Point {
+    x: int;
+    y: int;
+    z: int;
+}
+
+fn main(): void {
+    let p: Point = Point { z: 3, x: 1, y: 2 };
+}
+)";
+
+    AstArena arena;
+    NodeList<Stmt> stmts = arena.nodes<Stmt>();
+    run_test(source, arena, stmts);
+
+    // Checking only reads the tree, so the initialisers are left in the order they were written
+    auto &body = node_cast<FunDeclStmt>(stmts[1].get())->body;
+    auto init = node_cast<StructInitExpr>(node_cast<VariableDeclStmt>(body[0].get())->initialiser.get());
+    ASSERT_EQ(init->properties.size(), 3);
+    EXPECT_EQ(std::get<0>(init->properties[0]).lexeme, "z");
+    EXPECT_EQ(std::get<0>(init->properties[1]).lexeme, "x");
+    EXPECT_EQ(std::get<0>(init->properties[2]).lexeme, "y");
+}
+
+TEST(TypeCheckerTest, ResolveAndCheckSameErrors) {
+    auto files = {
+        "for_missing_return.baz",
+        "if_missing_return.baz",
+        "match_missing_return.baz",
+        "missing_return.baz",
+        "nested_missing_return.baz",
+        "optional_type_checking_fail.baz",
+        "reassign_wrong_type.baz",
+        "returns_no_val_when_void.baz",
+        "returns_val_when_void.baz",
+        "returns_wrong_type.baz",
+        "while_missing_return.baz",
+    };
+
+    for (auto file : files) {
+        std::ifstream t(std::string("../test/test_cases/") + file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        std::string errors = type_errors(source, true);
+        EXPECT_NE(errors, "") << file;
+        EXPECT_EQ(errors, type_errors(source, false)) << file;
+    }
+}
+
+TEST(TypeCheckerTest, ResolveErrorsBeforeTypeErrors) {
+    // The type error comes first, but resolving errors are reported before type errors
+    std::string source = R"(
+fn main(): void {
+    let a: int = "a";
+    println(b);
+}
+)";
+
+    EXPECT_EXIT({ run_test(source); }, testing::ExitedWithCode(5), "Unknown variable");
+}
+
+TEST(TypeCheckerTest, ParallelSameErrors) {
+    auto files = {
+        "for_missing_return.baz",
+        "match_missing_return.baz",
+        "optional_type_checking_fail.baz",
+        "optional_type_checking_succeed.baz",
+        "returns_success.baz",
+        "returns_wrong_type.baz",
+        "type_checking.baz",
+    };
+
+    for (auto file : files) {
+        std::ifstream t(std::string("../test/test_cases/") + file);
+        std::string source((std::istreambuf_iterator<char>(t)),
+                           std::istreambuf_iterator<char>());
+
+        EXPECT_EQ(parallel_type_errors(source, 4), type_errors(source, false)) << file;
+    }
+}
+
+TEST(TypeCheckerTest, ParallelReportsFirstError) {
+    // Every function has an error, but only the first one is reported however they are scheduled
+    std::string source;
+    for (int i = 0; i < 50; i++) {
+        source += "fn f" + std::to_string(i) + "(): int { return \"" + std::to_string(i) + "\"; }\n";
+    }
+
+    std::string expected = type_errors(source, false);
+    EXPECT_NE(expected.find("[line 1]"), std::string::npos);
+
+    for (int run = 0; run < 10; run++) {
+        EXPECT_EQ(parallel_type_errors(source, 4), expected);
+    }
+}